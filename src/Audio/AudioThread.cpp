@@ -0,0 +1,726 @@
+/*************************************
+ * @file    AudioThread.cpp
+ * @date    17/10/26
+ * @author  Manuel
+ *
+ * Définitions de la classe AudioThread.
+ *************************************
+*/
+
+#include "AudioThread.h"
+#include "../Exceptions/BaseException.h"
+#include <QDebug>
+#include <functional>
+
+
+namespace audio {
+
+
+AudioThread::AudioThread(QObject *parent)
+    : QThread(parent), m_Active(false), m_Serial(0), m_SpectrumEnabled(false), m_SpectrumClock(0),
+      m_Executed(0), m_Loading(false), m_SongEnding(false), m_Spectrum()
+{
+    qRegisterMetaType<std::vector<FmodManager::ResidentInfo>>();
+    qRegisterMetaType<std::vector<FmodManager::VoiceInfo>>();
+
+    m_VoiceSerials.fill(0);
+
+    for (unsigned int slot = 0; slot < m_OpenSlots.size(); slot++)
+    {
+        m_OpenSlots.at(slot).file.reserve(AUDIO_PATH_CAPACITY);
+        m_FreeSlots.push(slot);
+    }
+}
+
+// ==============================
+// ==============================
+
+AudioThread::~AudioThread()
+{
+    stop();
+}
+
+// ==============================
+// ==============================
+
+void AudioThread::stop()
+{
+    requestInterruption();
+    wait();
+}
+
+// ==============================
+// ==============================
+
+void AudioThread::run()
+{
+    using namespace std::placeholders;
+
+    FmodManager::getInstance().setChannelCallback(std::bind(&AudioThread::onChannelEvent, this, _1, _2));
+
+    while (!isInterruptionRequested())
+    {
+        bool positionChanged = false;
+
+        try
+        {
+            bool executed = executeCommands(positionChanged);
+            FmodManager::getInstance().update();
+
+            // Un canal en cours d'ouverture ou qui vient de se terminer est publié même à l'arrêt
+            if (m_Active || executed || m_Loading || m_SongEnding || m_EndedSounds.any())
+                publishSnapshot();
+        }
+        catch (exceptions::BaseException& e)
+        {
+            qWarning() << e.what();
+        }
+
+        emitChannelEvents();
+
+        if (positionChanged)
+            emit this->positionChanged();
+
+        msleep(AUDIO_UPDATE_TIME_MS);
+    }
+
+    FmodManager::getInstance().setChannelCallback(nullptr);
+}
+
+// ==============================
+// ==============================
+
+void AudioThread::post(Command& command, bool voiceChanged)
+{
+    command.serial = ++m_Serial;
+
+    if (voiceChanged)
+        m_VoiceSerials.at(command.id) = command.serial;
+
+    while (!m_Commands.push(command))
+        QThread::yieldCurrentThread();
+}
+
+// ==============================
+// ==============================
+
+bool AudioThread::executeCommands(bool& positionChanged)
+{
+    bool executed = false;
+    Command command;
+
+    while (m_Commands.pop(command))
+    {
+        executed = true;
+        m_Executed = command.serial;
+
+        // Une commande en échec n'empêche pas l'exécution des suivantes
+        try
+        {
+            positionChanged |= execute(command);
+        }
+        catch (FmodManager::StreamError)
+        {
+            // Echec de l'ouverture : publié avec l'état du canal (voir isSoundReady)
+        }
+        catch (exceptions::BaseException& e)
+        {
+            qWarning() << e.what();
+        }
+    }
+
+    return executed;
+}
+
+// ==============================
+// ==============================
+
+bool AudioThread::execute(const Command& command)
+{
+    FmodManager& fmod = FmodManager::getInstance();
+
+    switch (command.type)
+    {
+        case Command::Type::OPEN:
+        {
+            OpenSlot& slot = m_OpenSlots.at(command.slot);
+
+            // L'emplacement est rendu même si l'ouverture échoue
+            try
+            {
+                fmod.openFromFile(command.id, slot.file, slot.settings, true, slot.index);
+            }
+            catch (...)
+            {
+                slot.index.reset();
+                m_FreeSlots.push(command.slot);
+                throw;
+            }
+
+            slot.index.reset();
+            m_FreeSlots.push(command.slot);
+            break;
+        }
+
+        case Command::Type::RELEASE:
+            fmod.releaseSound(command.id);
+            break;
+
+        case Command::Type::PLAY:
+            fmod.playSound(command.id, command.enabled);
+            fmod.setVolume(command.id, command.volume);
+            break;
+
+        case Command::Type::PLAY_AFTER:
+            fmod.playSoundAfter(command.id, command.otherId, command.position, command.curve);
+            fmod.setVolume(command.id, command.volume);
+            break;
+
+        case Command::Type::SCHEDULE:
+            fmod.scheduleSound(command.id, command.otherId, command.position, command.curve);
+            break;
+
+        case Command::Type::PAUSE:
+            fmod.pauseSound(command.id, command.enabled);
+            return !command.enabled;
+
+        case Command::Type::STOP:
+            fmod.stopSound(command.id);
+            break;
+
+        case Command::Type::SEEK:
+            fmod.setSoundPosition(command.id, command.position);
+            return true;
+
+        case Command::Type::SYNC_POINT:
+            fmod.setEndSyncPoint(command.id, command.position);
+            break;
+
+        case Command::Type::FADE_IN:
+            fmod.fadeInSound(command.id, command.position, command.curve);
+            break;
+
+        case Command::Type::FADE_OUT:
+            fmod.fadeOutSound(command.id, command.otherId, command.position, command.curve);
+            break;
+
+        case Command::Type::REMOVE_FADES:
+            fmod.removeFadePoints(command.id);
+            break;
+
+        case Command::Type::MOVE:
+            if (command.otherId == FmodManager::MAIN_VOICE_ID)
+                fmod.moveToMainCanal(command.id);
+            else
+                fmod.moveToSecondaryCanal(command.id, command.otherId);
+            break;
+
+        case Command::Type::VOLUME:
+            fmod.setVolume(command.volume);
+            break;
+
+        case Command::Type::MUTE:
+            fmod.setMute(command.enabled);
+            break;
+
+        case Command::Type::SPECTRUM:
+            fmod.setSpectrumEnabled(command.enabled);
+            break;
+
+        case Command::Type::SAMPLE_BUDGET:
+            fmod.setSampleBudget(command.bytes);
+            break;
+
+        case Command::Type::PICTURE:
+        {
+            unsigned int length = 0;
+            const char *data = fmod.getSongPictureData(command.id, &length);
+
+            emit pictureRead(command.id, command.serial, data ? QByteArray(data, length) : QByteArray());
+            break;
+        }
+
+        case Command::Type::STATUS:
+            emit voicesRead(fmod.getVoices());
+            emit residentSoundsRead(fmod.getResidentSounds());
+            break;
+    }
+
+    return false;
+}
+
+// ==============================
+// ==============================
+
+void AudioThread::publishSnapshot()
+{
+    FmodManager& fmod = FmodManager::getInstance();
+    Snapshot& snapshot = m_Snapshots.back();
+
+    m_Loading = false;
+
+    for (SoundID_t id = 0; id < snapshot.voices.size(); id++)
+    {
+        Voice& voice = snapshot.voices.at(id);
+
+        voice.position = fmod.getSoundPosition(id);
+        voice.playing = fmod.isPlaying(id);
+        voice.failed = false;
+        voice.length = 0;
+
+        try
+        {
+            voice.ready = fmod.isSoundReady(id);
+        }
+        catch (FmodManager::StreamError error)
+        {
+            voice.ready = false;
+            voice.failed = true;
+            voice.error = error;
+        }
+
+        // L'état d'un son dont l'ouverture a échoué ne peut pas être lu
+        voice.buffered = voice.ready && fmod.isBuffered(id, CROSSFADE_REMOTE_BUFFER);
+
+        if (voice.ready)
+            voice.length = fmod.getSoundLength(id);
+
+        m_Loading |= (!voice.ready && !voice.failed);
+    }
+
+    // Le dernier spectre entendu reste publié tant que la sortie n'a pas atteint le suivant
+    fmod.getSpectrumFrame(m_Spectrum);
+    snapshot.spectrum = m_Spectrum;
+
+    snapshot.serial = m_Executed;
+
+    m_Snapshots.publish();
+}
+
+// ==============================
+// ==============================
+
+void AudioThread::emitChannelEvents()
+{
+    if (m_SongEnding)
+        emit songEnding();
+
+    for (SoundID_t id = 0; id < m_EndedSounds.size(); id++)
+    {
+        if (m_EndedSounds.test(id))
+            emit soundEnded(id);
+    }
+
+    m_SongEnding = false;
+    m_EndedSounds.reset();
+}
+
+// ==============================
+// ==============================
+
+void AudioThread::onChannelEvent(SoundID_t id, ChannelEvent event)
+{
+    if (id == FmodManager::getInstance().getMainSoundID())
+        m_SongEnding = true;
+    else if (event == ChannelEvent::END && id < m_EndedSounds.size())
+        m_EndedSounds.set(id);
+}
+
+// ==============================
+// ==============================
+
+const AudioThread::Voice* AudioThread::getVoice(SoundID_t id) const
+{
+    const Snapshot& snapshot = m_Snapshots.front();
+
+    if (id >= snapshot.voices.size() || snapshot.serial < m_VoiceSerials.at(id))
+        return nullptr;
+
+    return &snapshot.voices.at(id);
+}
+
+// ==============================
+// ==============================
+
+SoundID_t AudioThread::openFromFile(const std::string& soundFile, VoiceRole role, SoundSettings *settings,
+                                    std::shared_ptr<const SeekIndex> index) throw (FmodManager::StreamError)
+{
+    Command command;
+
+    command.type = Command::Type::OPEN;
+    command.id = FmodManager::getInstance().reserveVoice(role);
+
+    // Attend qu'une ouverture précédente rende son emplacement
+    while (!m_FreeSlots.pop(command.slot))
+        QThread::yieldCurrentThread();
+
+    OpenSlot& slot = m_OpenSlots.at(command.slot);
+
+    slot.file.assign(soundFile);
+    slot.settings = settings;
+    slot.index = std::move(index);
+    post(command, true);
+
+    return command.id;
+}
+
+// ==============================
+// ==============================
+
+bool AudioThread::isSoundReady(SoundID_t id) const throw (FmodManager::StreamError)
+{
+    const Voice *voice = getVoice(id);
+
+    if (!voice)
+        return false;
+
+    if (voice->failed)
+        throw voice->error;
+
+    return voice->ready;
+}
+
+// ==============================
+// ==============================
+
+bool AudioThread::isPlaying(SoundID_t id) const
+{
+    const Voice *voice = getVoice(id);
+
+    return !voice || voice->playing;
+}
+
+// ==============================
+// ==============================
+
+SoundPos_t AudioThread::getSoundLength(SoundID_t id) const
+{
+    const Voice *voice = getVoice(id);
+
+    return voice ? voice->length : 0;
+}
+
+// ==============================
+// ==============================
+
+void AudioThread::releaseSound(SoundID_t id)
+{
+    Command command;
+
+    command.type = Command::Type::RELEASE;
+    command.id = id;
+    post(command, true);
+}
+
+// ==============================
+// ==============================
+
+void AudioThread::playSound(SoundID_t id, float volume, bool paused)
+{
+    Command command;
+
+    command.type = Command::Type::PLAY;
+    command.id = id;
+    command.volume = volume;
+    command.enabled = paused;
+    post(command);
+}
+
+// ==============================
+// ==============================
+
+void AudioThread::playSoundAfter(SoundID_t id, SoundID_t previousId, SoundPos_t overlap, FadeCurve curve, float volume)
+{
+    Command command;
+
+    command.type = Command::Type::PLAY_AFTER;
+    command.id = id;
+    command.otherId = previousId;
+    command.position = overlap;
+    command.curve = curve;
+    command.volume = volume;
+    post(command);
+}
+
+// ==============================
+// ==============================
+
+void AudioThread::scheduleSound(SoundID_t id, SoundID_t previousId, SoundPos_t overlap, FadeCurve curve)
+{
+    Command command;
+
+    command.type = Command::Type::SCHEDULE;
+    command.id = id;
+    command.otherId = previousId;
+    command.position = overlap;
+    command.curve = curve;
+    post(command);
+}
+
+// ==============================
+// ==============================
+
+void AudioThread::pauseSound(SoundID_t id, bool paused)
+{
+    Command command;
+
+    command.type = Command::Type::PAUSE;
+    command.id = id;
+    command.enabled = paused;
+    post(command);
+}
+
+// ==============================
+// ==============================
+
+void AudioThread::stopSound(SoundID_t id)
+{
+    Command command;
+
+    command.type = Command::Type::STOP;
+    command.id = id;
+    post(command);
+}
+
+// ==============================
+// ==============================
+
+void AudioThread::setSoundPosition(SoundID_t id, SoundPos_t pos)
+{
+    Command command;
+
+    command.type = Command::Type::SEEK;
+    command.id = id;
+    command.position = pos;
+    post(command);
+}
+
+// ==============================
+// ==============================
+
+void AudioThread::setEndSyncPoint(SoundID_t id, SoundPos_t margin)
+{
+    Command command;
+
+    command.type = Command::Type::SYNC_POINT;
+    command.id = id;
+    command.position = margin;
+    post(command);
+}
+
+// ==============================
+// ==============================
+
+void AudioThread::fadeInSound(SoundID_t id, SoundPos_t length, FadeCurve curve)
+{
+    Command command;
+
+    command.type = Command::Type::FADE_IN;
+    command.id = id;
+    command.position = length;
+    command.curve = curve;
+    post(command);
+}
+
+// ==============================
+// ==============================
+
+SoundID_t AudioThread::fadeOutSound(SoundID_t id, SoundPos_t length, FadeCurve curve)
+{
+    Command command;
+
+    command.type = Command::Type::FADE_OUT;
+    command.id = id;
+    command.otherId = FmodManager::getInstance().reserveSecondaryVoice(id);
+    command.position = length;
+    command.curve = curve;
+    post(command, true);
+
+    if (command.otherId == FmodManager::NO_VOICE_ID)
+        return id;
+
+    m_VoiceSerials.at(command.otherId) = command.serial;
+
+    return command.otherId;
+}
+
+// ==============================
+// ==============================
+
+void AudioThread::removeFadePoints(SoundID_t id)
+{
+    Command command;
+
+    command.type = Command::Type::REMOVE_FADES;
+    command.id = id;
+    post(command);
+}
+
+// ==============================
+// ==============================
+
+SoundID_t AudioThread::moveToMainCanal(SoundID_t id)
+{
+    if (id == FmodManager::MAIN_VOICE_ID)
+        return id;
+
+    Command command;
+
+    command.type = Command::Type::MOVE;
+    command.id = id;
+    command.otherId = FmodManager::MAIN_VOICE_ID;
+    post(command, true);
+
+    m_VoiceSerials.at(command.otherId) = command.serial;
+
+    return command.otherId;
+}
+
+// ==============================
+// ==============================
+
+SoundID_t AudioThread::moveToSecondaryCanal(SoundID_t id)
+{
+    Command command;
+
+    command.type = Command::Type::MOVE;
+    command.id = id;
+    command.otherId = FmodManager::getInstance().reserveSecondaryVoice(id);
+
+    if (command.otherId == id)
+        return id;
+
+    post(command, true);
+
+    if (command.otherId == FmodManager::NO_VOICE_ID)
+        return id;
+
+    m_VoiceSerials.at(command.otherId) = command.serial;
+
+    return command.otherId;
+}
+
+// ==============================
+// ==============================
+
+void AudioThread::setVolume(float volume)
+{
+    Command command;
+
+    command.type = Command::Type::VOLUME;
+    command.volume = volume;
+    post(command);
+}
+
+// ==============================
+// ==============================
+
+void AudioThread::setMute(bool mute)
+{
+    Command command;
+
+    command.type = Command::Type::MUTE;
+    command.enabled = mute;
+    post(command);
+}
+
+// ==============================
+// ==============================
+
+SoundPos_t AudioThread::getSoundPosition(SoundID_t id) const
+{
+    const Voice *voice = getVoice(id);
+
+    return voice ? voice->position : 0;
+}
+
+// ==============================
+// ==============================
+
+bool AudioThread::isBuffered(SoundID_t id) const
+{
+    const Voice *voice = getVoice(id);
+
+    return voice && voice->buffered;
+}
+
+// ==============================
+// ==============================
+
+void AudioThread::setActive(bool active)
+{
+    m_Active = active;
+}
+
+// ==============================
+// ==============================
+
+void AudioThread::setSpectrumEnabled(bool enabled)
+{
+    if (enabled == m_SpectrumEnabled)
+        return;
+
+    Command command;
+
+    command.type = Command::Type::SPECTRUM;
+    command.enabled = enabled;
+    post(command);
+
+    m_SpectrumEnabled = enabled;
+}
+
+// ==============================
+// ==============================
+
+bool AudioThread::getSpectrum(SpectrumFrame& frame)
+{
+    const SpectrumFrame& spectrum = m_Snapshots.front().spectrum;
+
+    if (spectrum.clock == 0 || spectrum.clock == m_SpectrumClock)
+        return false;
+
+    frame = spectrum;
+    m_SpectrumClock = spectrum.clock;
+
+    return true;
+}
+
+// ==============================
+// ==============================
+
+void AudioThread::setSampleBudget(std::size_t budget)
+{
+    Command command;
+
+    command.type = Command::Type::SAMPLE_BUDGET;
+    command.bytes = budget;
+    post(command);
+}
+
+// ==============================
+// ==============================
+
+unsigned long long AudioThread::requestPicture(SoundID_t id)
+{
+    Command command;
+
+    command.type = Command::Type::PICTURE;
+    command.id = id;
+    post(command);
+
+    return command.serial;
+}
+
+// ==============================
+// ==============================
+
+void AudioThread::requestStatus()
+{
+    Command command;
+
+    command.type = Command::Type::STATUS;
+    post(command);
+}
+
+
+} // audio
@@ -0,0 +1,360 @@
+/*************************************
+ * @file    AudioThread.h
+ * @date    17/10/26
+ * @author  Manuel
+ *
+ * Déclarations de la classe AudioThread
+ * mettant à jour FMOD hors du thread
+ * graphique et publiant l'état du son.
+ *************************************
+*/
+
+#ifndef __AUDIOTHREAD_H__
+#define __AUDIOTHREAD_H__
+
+#include <QThread>
+#include <QByteArray>
+#include <array>
+#include <atomic>
+#include <bitset>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "FmodManager.h"
+#include "../Constants.h"
+#include "../Util/spscqueue.h"
+#include "../Util/triplebuffer.h"
+
+
+namespace audio {
+
+
+/**
+ * Le thread audio appelle FMOD_System_Update à intervalle régulier, exécute les commandes
+ * envoyées par le thread graphique (file sans verrou) et publie l'état de chaque canal et le dernier
+ * spectre dans des instantanés échangés atomiquement : l'interface ne fait aucun appel à FMOD,
+ * que ce soit pour les musiques, la preview, le spectre ou la pochette.
+ * Chaque commande désigne son canal ; les canaux ouverts ou déplacés sont attribués immédiatement
+ * (voir FmodManager::reserveVoice, qui ne fait que la comptabilité des canaux), le son n'y est ouvert
+ * ou déplacé qu'à l'exécution de la commande.
+ * Les fins de lecture sont remontées par les callbacks des canaux FMOD, sans scrutation.
+ */
+class AudioThread : public QThread
+{
+    Q_OBJECT
+
+    public:
+
+        // Commandes appliquées au canal id (volume, sourdine, spectre et budget : ensemble des canaux)
+        struct Command
+        {
+            enum class Type { OPEN, RELEASE, PLAY, PLAY_AFTER, SCHEDULE, PAUSE, STOP, SEEK, SYNC_POINT,
+                              FADE_IN, FADE_OUT, REMOVE_FADES, MOVE, VOLUME, MUTE, SPECTRUM, SAMPLE_BUDGET, PICTURE, STATUS };
+
+            Type type;
+            unsigned long long serial;
+            SoundID_t id;
+            SoundID_t otherId;              // Musique précédente (PLAY_AFTER, SCHEDULE), destination (FADE_OUT, MOVE)
+            SoundPos_t position;            // Position, fondu enchaîné, durée du fondu ou avance du point de synchronisation
+            float volume;
+            bool enabled;
+            FadeCurve curve;
+            std::size_t bytes;              // Mémoire maximale des sons chargés (SAMPLE_BUDGET)
+            unsigned int slot;              // Emplacement des paramètres de l'ouverture (OPEN)
+
+            Command() : type(Type::PAUSE), serial(0), id(FmodManager::NO_VOICE_ID), otherId(FmodManager::NO_VOICE_ID),
+                        position(0), volume(0.0f), enabled(false), curve(FadeCurve::EQUAL_POWER), bytes(0), slot(0) {}
+        };
+
+        // Paramètres d'une ouverture, écrits par le thread graphique dans un emplacement libre et rendus
+        // par le thread audio après l'ouverture : les commandes restent copiables sans allocation
+        struct OpenSlot
+        {
+            std::string file;               // Capacité réservée (AUDIO_PATH_CAPACITY)
+            SoundSettings *settings;
+            std::shared_ptr<const SeekIndex> index;
+
+            OpenSlot() : settings(nullptr) {}
+        };
+
+        // Etat d'un canal publié à chaque mise à jour
+        struct Voice
+        {
+            SoundPos_t position;
+            SoundPos_t length;              // 0 tant que l'ouverture n'est pas terminée
+            bool playing;
+            bool ready;
+            bool failed;
+            FmodManager::StreamError error;
+            bool buffered;                  // Avance suffisante pour un fondu enchaîné (CROSSFADE_REMOTE_BUFFER)
+
+            Voice() : position(0), length(0), playing(false), ready(false), failed(false),
+                      error(FmodManager::StreamError::FILE_ERROR), buffered(false) {}
+        };
+
+        struct Snapshot
+        {
+            std::array<Voice, MAX_CHANNELS_NB> voices;
+            SpectrumFrame spectrum;         // Dernier spectre calculé par le DSP (horloge 0 : aucun)
+            unsigned long long serial;      // Dernière commande exécutée
+
+            Snapshot() : spectrum(), serial(0) {}
+        };
+
+    private:
+
+        util::SpscQueue<Command, AUDIO_COMMANDS_NB> m_Commands;
+
+        // Emplacements des ouvertures et indices des emplacements libres (rendus par le thread audio)
+        std::array<OpenSlot, AUDIO_OPEN_SLOTS_NB> m_OpenSlots;
+        util::SpscQueue<unsigned int, AUDIO_OPEN_SLOTS_NB> m_FreeSlots;
+
+        mutable util::TripleBuffer<Snapshot> m_Snapshots;
+
+        // Aucun instantané n'est mesuré tant que la musique n'est pas en lecture (sauf ouverture, commande ou fin d'un canal)
+        std::atomic<bool> m_Active;
+
+        // Thread graphique : dernière commande envoyée, et dernière commande ayant changé le son de chaque canal
+        unsigned long long m_Serial;
+        std::array<unsigned long long, MAX_CHANNELS_NB> m_VoiceSerials;
+
+        // Thread graphique : état demandé du DSP du spectre, horloge du dernier spectre lu
+        bool m_SpectrumEnabled;
+        unsigned long long m_SpectrumClock;
+
+        // Thread audio : dernière commande exécutée, ouverture en cours, événements des canaux
+        // (émis une fois l'instantané qui les suit publié)
+        unsigned long long m_Executed;
+        bool m_Loading;
+        bool m_SongEnding;
+        std::bitset<MAX_CHANNELS_NB> m_EndedSounds;
+        SpectrumFrame m_Spectrum;
+
+
+        /**
+         * @brief Envoie la commande au thread audio (attend une place si la file est pleine).
+         * @param command Commande à envoyer
+         * @param voiceChanged true si la commande change le son du canal (l'état publié du canal est ignoré jusqu'à son exécution)
+         */
+        void post(Command& command, bool voiceChanged = false);
+
+        /**
+         * @brief Exécute les commandes en attente.
+         * @param positionChanged Mis à true si une reprise ou un déplacement a été appliqué
+         * @return true si au moins une commande a été exécutée
+         */
+        bool executeCommands(bool& positionChanged);
+
+        /**
+         * @brief Exécute une commande.
+         * @param command Commande à exécuter
+         * @return true si la commande est une reprise ou un déplacement
+         */
+        bool execute(const Command& command);
+
+        /**
+         * @brief Mesure les canaux et publie l'instantané.
+         */
+        void publishSnapshot();
+
+        /**
+         * @brief Emet les événements des canaux reçus pendant la dernière mise à jour.
+         */
+        void emitChannelEvents();
+
+        /**
+         * @brief Reçoit les événements des canaux FMOD (appelée pendant FmodManager::update).
+         * @param id Identifiant du canal
+         * @param event Evénement du canal
+         */
+        void onChannelEvent(SoundID_t id, ChannelEvent event);
+
+        /**
+         * @brief Récupère l'état publié du canal (thread graphique uniquement).
+         * @param id Identifiant du canal
+         * @return Etat du canal, nullptr si une commande changeant son son n'a pas encore été exécutée
+         */
+        const Voice* getVoice(SoundID_t id) const;
+
+    protected:
+
+        void run() override;
+
+    public:
+
+        AudioThread(QObject *parent = nullptr);
+        virtual ~AudioThread();
+
+        /**
+         * @brief Arrête le thread et attend la fin de sa dernière mise à jour.
+         */
+        void stop();
+
+        /**
+         * @brief Attribue un canal au son et y lance l'ouverture du fichier en arrière-plan (voir isSoundReady).
+         * @param soundFile Fichier à ouvrir
+         * @param role Rôle du canal (VOICE_ERROR si aucun n'est disponible)
+         * @param settings Options de chargement de la musique (doivent rester valides jusqu'à la libération du son)
+         * @param index Index de déplacement du fichier local lu en stream
+         * @return Identifiant du canal attribué
+         */
+        SoundID_t openFromFile(const std::string& soundFile, VoiceRole role, SoundSettings *settings = nullptr,
+                               std::shared_ptr<const SeekIndex> index = nullptr) throw (FmodManager::StreamError);
+
+        /**
+         * @brief Détermine si l'ouverture du son est terminée d'après le dernier instantané.
+         * @param id Identifiant du son
+         * @return true si le son peut être joué (exception StreamError si l'ouverture a échoué)
+         */
+        bool isSoundReady(SoundID_t id) const throw (FmodManager::StreamError);
+
+        /**
+         * @brief Détermine si le canal est en lecture d'après le dernier instantané.
+         * @param id Identifiant du canal
+         * @return true si le canal joue, ou si une commande changeant son son n'a pas encore été exécutée
+         */
+        bool isPlaying(SoundID_t id) const;
+
+        /**
+         * @brief getSoundLength
+         * @param id Identifiant du son
+         * @return Durée publiée du son (ms, 0 tant que son ouverture n'est pas terminée).
+         */
+        SoundPos_t getSoundLength(SoundID_t id) const;
+
+        void releaseSound(SoundID_t id);
+        void playSound(SoundID_t id, float volume, bool paused = false);
+        void playSoundAfter(SoundID_t id, SoundID_t previousId, SoundPos_t overlap, FadeCurve curve, float volume);
+        void scheduleSound(SoundID_t id, SoundID_t previousId, SoundPos_t overlap, FadeCurve curve);
+        void pauseSound(SoundID_t id, bool paused);
+        void stopSound(SoundID_t id);
+        void setSoundPosition(SoundID_t id, SoundPos_t pos);
+        void setEndSyncPoint(SoundID_t id, SoundPos_t margin);
+        void fadeInSound(SoundID_t id, SoundPos_t length, FadeCurve curve);
+        void removeFadePoints(SoundID_t id);
+        void setVolume(float volume);
+        void setMute(bool mute);
+
+        /**
+         * @brief Déplace le son sur un canal secondaire et l'éteint en fondu (voir FmodManager::fadeOutSound).
+         * @param id Identifiant du son
+         * @param length Durée du fondu (ms)
+         * @param curve Courbe du fondu
+         * @return Nouvel identifiant du son
+         */
+        SoundID_t fadeOutSound(SoundID_t id, SoundPos_t length, FadeCurve curve);
+
+        /**
+         * @brief Déplace le son sur le canal principal (le son principal est libéré).
+         * @param id Identifiant du son
+         * @return Identifiant du canal principal
+         */
+        SoundID_t moveToMainCanal(SoundID_t id);
+
+        /**
+         * @brief Déplace le son sur un canal de fondu de sortie (son libéré s'il n'y en a pas).
+         * @param id Identifiant du son
+         * @return Nouvel identifiant du son
+         */
+        SoundID_t moveToSecondaryCanal(SoundID_t id);
+
+        /**
+         * @brief getSoundPosition
+         * @param id Identifiant du son
+         * @return Dernière position publiée du son (ms, 0 tant que son ouverture ou son déplacement n'a pas été exécuté).
+         */
+        SoundPos_t getSoundPosition(SoundID_t id) const;
+
+        /**
+         * @brief isBuffered
+         * @param id Identifiant du son
+         * @return true si le stream du son a assez d'avance pour un fondu enchaîné (CROSSFADE_REMOTE_BUFFER).
+         */
+        bool isBuffered(SoundID_t id) const;
+
+        /**
+         * @brief Active ou non la mesure des canaux à chaque mise à jour.
+         * @param active true si la musique est en lecture
+         */
+        void setActive(bool active);
+
+        /**
+         * @brief Active le DSP du spectre ou le contourne (commande envoyée seulement si l'état change).
+         * @param enabled true si le spectre est affiché
+         */
+        void setSpectrumEnabled(bool enabled);
+
+        /**
+         * @brief Récupère le spectre du dernier instantané s'il n'a pas encore été lu.
+         * @param frame Spectre récupéré (inchangé sinon)
+         * @return true si un nouveau spectre a été récupéré
+         */
+        bool getSpectrum(SpectrumFrame& frame);
+
+        /**
+         * @brief Modifie la mémoire maximale des sons chargés en mémoire (voir FmodManager::setSampleBudget).
+         * @param budget Mémoire maximale (octets)
+         */
+        void setSampleBudget(std::size_t budget);
+
+        /**
+         * @brief Demande la lecture de la pochette du son dans ses tags (signal pictureRead).
+         * @param id Identifiant du son
+         * @return Numéro de la commande, transmis avec la pochette
+         */
+        unsigned long long requestPicture(SoundID_t id);
+
+        /**
+         * @brief Demande l'état des canaux et des sons chargés en mémoire (signaux voicesRead et residentSoundsRead).
+         */
+        void requestStatus();
+
+    signals:
+
+        /**
+         * @brief Emis lorsque la musique du canal principal se termine ou passe son point
+         *        de synchronisation de fin (voir FmodManager::setEndSyncPoint).
+         */
+        void songEnding();
+
+        /**
+         * @brief Emis lorsque la lecture d'un canal secondaire se termine.
+         * @param id Identifiant du canal
+         */
+        void soundEnded(SoundID_t id);
+
+        /**
+         * @brief Emis lorsque la reprise ou le déplacement d'une musique a été appliqué
+         *        (l'instantané qui suit l'application est déjà publié).
+         */
+        void positionChanged();
+
+        /**
+         * @brief Emis lorsque la pochette demandée par requestPicture a été lue.
+         * @param id Identifiant du son
+         * @param serial Numéro de la commande (voir requestPicture)
+         * @param data Données de l'image (vide si le son n'a pas de pochette)
+         */
+        void pictureRead(SoundID_t id, unsigned long long serial, const QByteArray& data);
+
+        /**
+         * @brief Emis lorsque l'état demandé par requestStatus a été relevé.
+         * @param residents Sons chargés en mémoire, du plus récemment ouvert au plus ancien
+         */
+        void residentSoundsRead(const std::vector<audio::FmodManager::ResidentInfo>& residents);
+
+        /**
+         * @brief Emis lorsque l'état demandé par requestStatus a été relevé.
+         * @param voices Canaux actifs du pool et lectures de durée en cours
+         */
+        void voicesRead(const std::vector<audio::FmodManager::VoiceInfo>& voices);
+};
+
+
+} // audio
+
+Q_DECLARE_METATYPE(std::vector<audio::FmodManager::ResidentInfo>)
+Q_DECLARE_METATYPE(std::vector<audio::FmodManager::VoiceInfo>)
+
+#endif  // __AUDIOTHREAD_H__
@@ -0,0 +1,294 @@
+/*************************************
+ * @file    FftEngine.cpp
+ * @date    17/10/26
+ * @author  Manuel
+ *
+ * Définitions de la classe FftEngine.
+ *************************************
+*/
+
+#include "FftEngine.h"
+#include "SpectrumKernels.h"
+#include <algorithm>
+#include <cmath>
+
+
+namespace audio {
+
+
+namespace {
+
+constexpr double TWO_PI = 6.28318530717958647692;
+
+// Produit complexe sans la gestion des infinis de std::complex (appel de __mulsc3)
+inline std::complex<float> multiply(const std::complex<float>& a, const std::complex<float>& b)
+{
+    return std::complex<float>(a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real());
+}
+
+}
+
+// ==============================
+// ==============================
+
+FftEngine::FftEngine(unsigned int fftSize, unsigned int outputSize, Window window, float overlap)
+    : m_FftSize(4), m_OutputSize(std::max(outputSize, 1u)), m_HopSize(0), m_Window(window), m_Scale(0), m_SamplesNb(0)
+{
+    while (m_FftSize < fftSize)
+        m_FftSize *= 2;
+
+    const unsigned int halfSize = m_FftSize / 2;
+
+    overlap = std::min(std::max(overlap, 0.0f), 0.99f);
+    m_HopSize = std::max(1u, static_cast<unsigned int>(std::lround(m_FftSize * (1.0f - overlap))));
+
+    m_Samples.resize(m_FftSize);
+    m_Twiddles.resize(halfSize);
+    m_RealTwiddles.resize(halfSize);
+    m_Buffer.resize(halfSize);
+    m_Scratch.resize(halfSize);
+    m_Magnitudes.resize(halfSize);
+    m_Edges.resize(m_OutputSize + 1);
+
+    for (unsigned int k = 0; k < halfSize; k++)
+    {
+        m_Twiddles[k] = std::polar(1.0f, static_cast<float>(-TWO_PI * k / halfSize));
+        m_RealTwiddles[k] = std::polar(1.0f, static_cast<float>(-TWO_PI * k / m_FftSize));
+    }
+
+    for (unsigned int j = 0; j <= m_OutputSize; j++)
+        m_Edges[j] = static_cast<unsigned int>(static_cast<unsigned long long>(j) * halfSize / m_OutputSize);
+
+    setWindow(window);
+}
+
+// ==============================
+// ==============================
+
+unsigned int FftEngine::getFftSize() const
+{
+    return m_FftSize;
+}
+
+// ==============================
+// ==============================
+
+unsigned int FftEngine::getOutputSize() const
+{
+    return m_OutputSize;
+}
+
+// ==============================
+// ==============================
+
+unsigned int FftEngine::getHopSize() const
+{
+    return m_HopSize;
+}
+
+// ==============================
+// ==============================
+
+FftEngine::Window FftEngine::getWindow() const
+{
+    return m_Window;
+}
+
+// ==============================
+// ==============================
+
+void FftEngine::setWindow(Window window)
+{
+    m_Window = window;
+    m_Coefficients.resize(m_FftSize);
+
+    double sum = 0;
+
+    for (unsigned int i = 0; i < m_FftSize; i++)
+    {
+        const double x = TWO_PI * i / (m_FftSize - 1);
+        double coefficient;
+
+        switch (window)
+        {
+            case Window::HANN:
+                coefficient = 0.5 - 0.5 * std::cos(x);
+                break;
+
+            case Window::HAMMING:
+                coefficient = 0.54 - 0.46 * std::cos(x);
+                break;
+
+            case Window::BLACKMAN:
+                coefficient = 0.42 - 0.5 * std::cos(x) + 0.08 * std::cos(2 * x);
+                break;
+
+            case Window::BLACKMAN_HARRIS:
+                coefficient = 0.35875 - 0.48829 * std::cos(x) + 0.14128 * std::cos(2 * x) - 0.01168 * std::cos(3 * x);
+                break;
+
+            default:
+                coefficient = 1.0;
+                break;
+        }
+
+        m_Coefficients[i] = static_cast<float>(coefficient);
+        sum += coefficient;
+    }
+
+    // Une sinusoïde d'amplitude 1 donne une valeur proche de 1, quelle que soit la fenêtre
+    m_Scale = static_cast<float>(2.0 / sum);
+}
+
+// ==============================
+// ==============================
+
+unsigned int FftEngine::write(const float *samples, unsigned int count)
+{
+    unsigned int written = std::min(count, m_FftSize - m_SamplesNb);
+
+    std::copy(samples, samples + written, m_Samples.begin() + m_SamplesNb);
+    m_SamplesNb += written;
+
+    return written;
+}
+
+// ==============================
+// ==============================
+
+bool FftEngine::isFrameReady() const
+{
+    return m_SamplesNb == m_FftSize;
+}
+
+// ==============================
+// ==============================
+
+void FftEngine::compute(float *output)
+{
+    transform(m_Samples.data(), output);
+
+    // Les échantillons recouverts par la trame suivante sont conservés
+    std::copy(m_Samples.begin() + m_HopSize, m_Samples.end(), m_Samples.begin());
+    m_SamplesNb = m_FftSize - m_HopSize;
+}
+
+// ==============================
+// ==============================
+
+void FftEngine::transform(const float *samples, float *output)
+{
+    computeMagnitudes(samples);
+    SpectrumKernels::get().aggregateBands(m_Magnitudes.data(), m_Edges.data(), output, m_OutputSize);
+}
+
+// ==============================
+// ==============================
+
+void FftEngine::reset()
+{
+    m_SamplesNb = 0;
+}
+
+// ==============================
+// ==============================
+
+void FftEngine::computeMagnitudes(const float *samples)
+{
+    const unsigned int halfSize = m_FftSize / 2;
+
+    // Les échantillons pairs et impairs forment les parties réelle et imaginaire d'un signal de taille N/2
+    for (unsigned int k = 0; k < halfSize; k++)
+    {
+        m_Buffer[k] = std::complex<float>(samples[2 * k] * m_Coefficients[2 * k],
+                                          samples[2 * k + 1] * m_Coefficients[2 * k + 1]);
+    }
+
+    const std::complex<float> *z = complexTransform();
+
+    m_Magnitudes[0] = std::fabs(z[0].real() + z[0].imag()) * m_Scale;
+
+    for (unsigned int k = 1; k < halfSize; k++)
+    {
+        const std::complex<float> current = z[k];
+        const std::complex<float> mirror = std::conj(z[halfSize - k]);
+
+        const std::complex<float> even = (current + mirror) * 0.5f;
+        const std::complex<float> difference = current - mirror;
+        const std::complex<float> odd(difference.imag() * 0.5f, -difference.real() * 0.5f);
+        const std::complex<float> value = even + multiply(m_RealTwiddles[k], odd);
+
+        m_Magnitudes[k] = std::sqrt(value.real() * value.real() + value.imag() * value.imag()) * m_Scale;
+    }
+}
+
+// ==============================
+// ==============================
+
+std::complex<float>* FftEngine::complexTransform()
+{
+    const unsigned int size = m_Buffer.size();
+
+    std::complex<float> *x = m_Buffer.data();
+    std::complex<float> *y = m_Scratch.data();
+
+    unsigned int n = size;
+    unsigned int stride = 1;
+
+    /* Etapes radix-4 (Stockham : pas de permutation des indices) */
+    while (n >= 4)
+    {
+        const unsigned int m = n / 4;
+        const unsigned int step = size / n;
+
+        for (unsigned int p = 0; p < m; p++)
+        {
+            const std::complex<float> w1 = m_Twiddles[p * step];
+            const std::complex<float> w2 = m_Twiddles[2 * p * step];
+            const std::complex<float> w3 = m_Twiddles[3 * p * step];
+
+            for (unsigned int q = 0; q < stride; q++)
+            {
+                const std::complex<float> a = x[q + stride * p];
+                const std::complex<float> b = x[q + stride * (p + m)];
+                const std::complex<float> c = x[q + stride * (p + 2 * m)];
+                const std::complex<float> d = x[q + stride * (p + 3 * m)];
+
+                const std::complex<float> apc = a + c;
+                const std::complex<float> amc = a - c;
+                const std::complex<float> bpd = b + d;
+                const std::complex<float> bmd = b - d;
+                const std::complex<float> jbmd(-bmd.imag(), bmd.real());
+
+                y[q + stride * (4 * p)] = apc + bpd;
+                y[q + stride * (4 * p + 1)] = multiply(w1, amc - jbmd);
+                y[q + stride * (4 * p + 2)] = multiply(w2, apc - bpd);
+                y[q + stride * (4 * p + 3)] = multiply(w3, amc + jbmd);
+            }
+        }
+
+        n /= 4;
+        stride *= 4;
+        std::swap(x, y);
+    }
+
+    /* Dernière étape radix-2 si log2(N/2) est impair */
+    if (n == 2)
+    {
+        for (unsigned int q = 0; q < stride; q++)
+        {
+            const std::complex<float> a = x[q];
+            const std::complex<float> b = x[q + stride];
+
+            y[q] = a + b;
+            y[q + stride] = a - b;
+        }
+
+        std::swap(x, y);
+    }
+
+    return x;
+}
+
+
+} // audio
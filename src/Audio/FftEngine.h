@@ -0,0 +1,136 @@
+/*************************************
+ * @file    FftEngine.h
+ * @date    17/10/26
+ * @author  Manuel
+ *
+ * Déclarations de la classe FftEngine
+ * calculant le spectre d'échantillons
+ * mono par transformée de Fourier.
+ *************************************
+*/
+
+#ifndef __FFTENGINE_H__
+#define __FFTENGINE_H__
+
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+
+namespace audio {
+
+
+/**
+ * Transformée de Fourier d'un signal réel : FFT complexe de taille N/2 (Stockham radix-4,
+ * dernière étape radix-2 si besoin) suivie de la séparation des parties paire et impaire.
+ * Les fenêtres et facteurs de rotation sont calculés à la construction : write et compute
+ * n'allouent rien et peuvent être appelées depuis le thread de mixage.
+ *
+ * Les N/2 amplitudes (normalisées par le gain de la fenêtre) sont regroupées en outputSize
+ * valeurs (maximum de chaque groupe), indépendamment de la taille de la FFT.
+ * Les trames successives se recouvrent selon overlap (0 : aucun recouvrement).
+ */
+class FftEngine
+{
+    public:
+
+        enum class Window { RECTANGULAR, HANN, HAMMING, BLACKMAN, BLACKMAN_HARRIS };
+
+    private:
+
+        unsigned int m_FftSize;
+        unsigned int m_OutputSize;
+        unsigned int m_HopSize;
+
+        Window m_Window;
+        std::vector<float> m_Coefficients;
+        float m_Scale;
+
+        // Echantillons de la trame en cours
+        std::vector<float> m_Samples;
+        unsigned int m_SamplesNb;
+
+        // Facteurs de rotation de la FFT complexe (N/2) et de la séparation réelle (N)
+        std::vector<std::complex<float>> m_Twiddles;
+        std::vector<std::complex<float>> m_RealTwiddles;
+
+        std::vector<std::complex<float>> m_Buffer;
+        std::vector<std::complex<float>> m_Scratch;
+
+        std::vector<float> m_Magnitudes;
+
+        // Premier coefficient de chaque valeur de sortie (outputSize + 1 bornes)
+        std::vector<unsigned int> m_Edges;
+
+
+        /**
+         * @brief Calcule la FFT complexe de m_Buffer.
+         * @return Buffer contenant le résultat (m_Buffer ou m_Scratch)
+         */
+        std::complex<float>* complexTransform();
+
+        /**
+         * @brief Calcule les amplitudes des N/2 coefficients d'un signal réel.
+         * @param samples N échantillons
+         */
+        void computeMagnitudes(const float *samples);
+
+    public:
+
+        /**
+         * @brief Crée le moteur de FFT.
+         * @param fftSize Taille de la FFT (arrondie à la puissance de 2 supérieure, au moins 4)
+         * @param outputSize Nombre de valeurs du spectre produit
+         * @param window Fenêtre appliquée aux échantillons
+         * @param overlap Recouvrement des trames successives, dans [0, 1)
+         */
+        FftEngine(unsigned int fftSize, unsigned int outputSize, Window window = Window::HANN, float overlap = 0.0f);
+
+        unsigned int getFftSize() const;
+        unsigned int getOutputSize() const;
+        unsigned int getHopSize() const;
+        Window getWindow() const;
+
+        /**
+         * @brief Change la fenêtre appliquée aux échantillons (pas depuis le thread de mixage).
+         * @param window Nouvelle fenêtre
+         */
+        void setWindow(Window window);
+
+        /**
+         * @brief Ajoute des échantillons à la trame en cours, jusqu'à ce qu'elle soit pleine.
+         * @param samples Echantillons mono
+         * @param count Nombre d'échantillons disponibles
+         * @return Nombre d'échantillons ajoutés
+         */
+        unsigned int write(const float *samples, unsigned int count);
+
+        /**
+         * @brief isFrameReady
+         * @return true si la trame en cours est pleine et peut être calculée.
+         */
+        bool isFrameReady() const;
+
+        /**
+         * @brief Calcule le spectre de la trame pleine puis la décale du pas entre deux trames.
+         * @param output Spectre (outputSize valeurs)
+         */
+        void compute(float *output);
+
+        /**
+         * @brief Calcule le spectre de N échantillons, indépendamment de la trame en cours.
+         * @param samples N échantillons mono
+         * @param output Spectre (outputSize valeurs)
+         */
+        void transform(const float *samples, float *output);
+
+        /**
+         * @brief Vide la trame en cours.
+         */
+        void reset();
+};
+
+
+} // audio
+
+#endif  // __FFTENGINE_H__
@@ -11,18 +11,73 @@
 #include "../Exceptions/LibException.h"
 #include <vector>
 #include <memory>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#ifdef _WIN32
+#include <codecvt>
+#include <locale>
+#endif
 
 
 namespace audio {
 
 
+namespace {
+
+// Rapport estimé entre un fichier compressé (128 kbit/s) et son décodage en PCM 16 bits stéréo à 44,1 kHz
+constexpr std::size_t PCM_SIZE_RATIO = 11;
+
+/**
+ * @brief Ouvre un fichier local en lecture.
+ * @param name Chemin du fichier (UTF-8, comme les chemins transmis à FMOD)
+ * @return Fichier ouvert, nullptr en cas d'échec
+ */
+std::FILE* openLocalFile(const char *name)
+{
+#ifdef _WIN32
+    return _wfopen(std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>>().from_bytes(name).c_str(), L"rb");
+#else
+    return std::fopen(name, "rb");
+#endif
+}
+
+/**
+ * @brief Mesure la taille d'un fichier ouvert et revient à son début.
+ * @param stream Fichier ouvert
+ * @return Taille du fichier (octets, -1 en cas d'échec)
+ */
+long getLocalFileSize(std::FILE *stream)
+{
+    long size;
+
+    if (std::fseek(stream, 0, SEEK_END) != 0 || (size = std::ftell(stream)) < 0 || std::fseek(stream, 0, SEEK_SET) != 0)
+        return -1;
+
+    return size;
+}
+
+}
+
+// ==============================
+// ==============================
+
 FmodManager* FmodManager::mp_Instance = nullptr;
 
+constexpr SoundID_t FmodManager::MAIN_VOICE_ID;
+constexpr SoundID_t FmodManager::NO_VOICE_ID;
+
 // ==============================
 // ==============================
 
 FmodManager::FmodManager(int maxChannels)
-    : mp_System(nullptr), mp_Channels(maxChannels), mp_Sounds(maxChannels), mp_Dsps(maxChannels), mp_ChannelGroup(nullptr)
+    : mp_System(nullptr), mp_Channels(maxChannels), mp_Sounds(maxChannels), mp_ChannelGroup(nullptr), m_SoundFiles(maxChannels),
+      m_ResidentCounter(0), m_SampleBudget(static_cast<std::size_t>(SAMPLE_DEFAULT_BUDGET) * 1024 * 1024), m_Roles(maxChannels, VoiceRole::MAIN), m_VoiceAges(maxChannels, 0), m_VoicesCounter(0), m_Reserved(maxChannels, false), m_Busy(maxChannels, false), m_ProbesNb(0),
+      mp_SyncPoints(maxChannels), m_EndPoints(maxChannels, 0), m_EndPassed(maxChannels, false), mp_SpectrumDsp(nullptr), m_SpectrumEnabled(false)
 {
     FMOD_RESULT res;
 
@@ -49,8 +104,22 @@ FmodManager::~FmodManager()
     for (i = 0; i < mp_Sounds.size(); i++)
         releaseSound(i);
 
+    for (FMOD_SOUND *sound : mp_PendingReleases)
+        FMOD_Sound_Release(sound);
+
+    for (ResidentSound& resident : m_ResidentSounds)
+        FMOD_Sound_Release(resident.sound);
+
     FMOD_RESULT res;
 
+    if (mp_SpectrumDsp)
+    {
+        FMOD_ChannelGroup_RemoveDSP(mp_ChannelGroup, mp_SpectrumDsp);
+
+        if ((res = FMOD_DSP_Release(mp_SpectrumDsp)) != FMOD_OK)
+            throw exceptions::LibException("FmodManager::~FmodManager", "FMOD_DSP_Release", FMOD_ErrorString(res));
+    }
+
     if ((res = FMOD_System_Release(mp_System)) != FMOD_OK)
         throw exceptions::LibException("FmodManager::~FmodManager", "FMOD_System_Release", FMOD_ErrorString(res));
 }
@@ -81,124 +150,1011 @@ void FmodManager::deleteInstance()
 // ==============================
 // ==============================
 
-SoundID_t FmodManager::getSoundID(bool mainCanal) const
+unsigned int FmodManager::getPriority(VoiceRole role)
+{
+    switch (role)
+    {
+        case VoiceRole::MAIN:       return VOICE_PRIORITY_MAIN;
+        case VoiceRole::NEXT:       return VOICE_PRIORITY_NEXT;
+        case VoiceRole::PREVIEW:    return VOICE_PRIORITY_PREVIEW;
+        case VoiceRole::CROSSFADE:  return VOICE_PRIORITY_CROSSFADE;
+        default:                    return VOICE_PRIORITY_PROBE;
+    }
+}
+
+// ==============================
+// ==============================
+
+unsigned int FmodManager::getLimit(VoiceRole role)
 {
-    SoundID_t id = 0;
+    switch (role)
+    {
+        case VoiceRole::MAIN:       return 1;
+        case VoiceRole::NEXT:       return VOICE_LIMIT_NEXT;
+        case VoiceRole::PREVIEW:    return VOICE_LIMIT_PREVIEW;
+        case VoiceRole::CROSSFADE:  return VOICE_LIMIT_CROSSFADE;
+        default:                    return VOICE_LIMIT_PROBE;
+    }
+}
+
+// ==============================
+// ==============================
+
+bool FmodManager::isVoiceFree(SoundID_t id) const
+{
+    if (m_Reserved.at(id))
+        return false;
+
+    if (!mp_Sounds.at(id))
+        return true;
+
+    // Les sons de la musique courante et de la suivante restent réservés jusqu'à leur libération
+    if (m_Roles.at(id) != VoiceRole::PREVIEW && m_Roles.at(id) != VoiceRole::CROSSFADE)
+        return false;
+
+    return !m_Busy.at(id);
+}
+
+// ==============================
+// ==============================
+
+SoundID_t FmodManager::findVoice(VoiceRole role, SoundID_t reservedId) const
+{
+    SoundID_t id = NO_VOICE_ID;
+
+    if (role == VoiceRole::MAIN)
+        id = MAIN_VOICE_ID;
+    else
+    {
+        SoundID_t oldest = NO_VOICE_ID;
+        unsigned int roleVoices = 0;
+
+        for (SoundID_t i = MAIN_VOICE_ID + 1; i < mp_Sounds.size(); i++)
+        {
+            if (i == reservedId)
+                continue;
+
+            if ((mp_Sounds.at(i) || m_Reserved.at(i)) && m_Roles.at(i) == role && !isVoiceFree(i))
+            {
+                roleVoices++;
+
+                if (oldest == NO_VOICE_ID || m_VoiceAges.at(i) < m_VoiceAges.at(oldest))
+                    oldest = i;
+            }
+            else if (id == NO_VOICE_ID && isVoiceFree(i))
+                id = i;
+        }
+
+        // Limite du rôle atteinte : son canal le plus ancien est réutilisé
+        if (roleVoices >= getLimit(role))
+            id = oldest;
+
+        // Pool plein : éviction du canal le moins prioritaire s'il l'est moins que le rôle demandé
+        if (id == NO_VOICE_ID)
+        {
+            for (SoundID_t i = MAIN_VOICE_ID + 1; i < mp_Sounds.size(); i++)
+            {
+                if (i == reservedId || m_Reserved.at(i) || getPriority(m_Roles.at(i)) >= getPriority(role))
+                    continue;
+
+                if (id == NO_VOICE_ID || getPriority(m_Roles.at(i)) < getPriority(m_Roles.at(id))
+                    || (m_Roles.at(i) == m_Roles.at(id) && m_VoiceAges.at(i) < m_VoiceAges.at(id)))
+                    id = i;
+            }
+        }
+    }
+
+    return id;
+}
 
-    if (mainCanal)
+// ==============================
+// ==============================
+
+SoundID_t FmodManager::allocateVoice(VoiceRole role, SoundID_t reservedId)
+{
+    SoundID_t id = findVoice(role, reservedId);
+
+    if (id == NO_VOICE_ID)
+        return NO_VOICE_ID;
+
+    releaseSound(id);
+
+    m_Roles.at(id) = role;
+    m_VoiceAges.at(id) = ++m_VoicesCounter;
+
+    return id;
+}
+
+// ==============================
+// ==============================
+
+SoundID_t FmodManager::reserveVoice(VoiceRole role) throw (StreamError)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_Mutex);
+
+    SoundID_t id = findVoice(role);
+
+    if (id == NO_VOICE_ID)
+        throw StreamError::VOICE_ERROR;
+
+    m_Roles.at(id) = role;
+    m_VoiceAges.at(id) = ++m_VoicesCounter;
+    m_Reserved.at(id) = true;
+
+    return id;
+}
+
+// ==============================
+// ==============================
+
+SoundID_t FmodManager::reserveSecondaryVoice(SoundID_t id)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_Mutex);
+
+    if (id != MAIN_VOICE_ID && m_Roles.at(id) == VoiceRole::CROSSFADE)
         return id;
 
-    do
+    const SoundID_t secondaryId = findVoice(VoiceRole::CROSSFADE, id);
+
+    if (secondaryId != NO_VOICE_ID)
+    {
+        m_Roles.at(secondaryId) = VoiceRole::CROSSFADE;
+        m_VoiceAges.at(secondaryId) = ++m_VoicesCounter;
+        m_Reserved.at(secondaryId) = true;
+    }
+
+    return secondaryId;
+}
+
+// ==============================
+// ==============================
+
+void FmodManager::update()
+{
+    std::lock_guard<std::recursive_mutex> lock(m_Mutex);
+
+    FMOD_RESULT res;
+
+    if ((res = FMOD_System_Update(mp_System)) != FMOD_OK)
+        throw exceptions::LibException("FmodManager::update", "FMOD_System_Update", FMOD_ErrorString(res));
+
+    for (auto it = mp_PendingReleases.begin(); it != mp_PendingReleases.end(); )
+    {
+        if (isLoading(*it))
+        {
+            ++it;
+            continue;
+        }
+
+        FMOD_Sound_Release(*it);
+
+        m_PendingFiles.erase(m_PendingFiles.begin() + (it - mp_PendingReleases.begin()));
+        it = mp_PendingReleases.erase(it);
+    }
+
+    for (SoundID_t id = 0; id < static_cast<SoundID_t>(m_SoundFiles.size()); ++id)
+    {
+        m_Busy.at(id) = mp_Sounds.at(id) && (isLoading(mp_Sounds.at(id)) || isPlaying(id));
+
+        // Point de fin placé avant la correction d'un déplacement distant : décalé de l'avance du canal
+        SoundFile *file = m_SoundFiles.at(id).get();
+
+        if (file && file->shiftChanged.exchange(false) && mp_SyncPoints.at(id))
+            setEndSyncPoint(id, file->syncMargin);
+
+        // Déplacement terminé : sa correction, si FMOD n'a pas eu à lire le fichier, ne doit pas servir au suivant
+        if (file && mp_Sounds.at(id) && !isSeeking(mp_Sounds.at(id)))
+        {
+            file->seekOffset = -1;
+            file->seekTime = -1;
+
+            if (file->pendingSeek >= 0)
+            {
+                const SoundPos_t pos = static_cast<SoundPos_t>(file->pendingSeek);
+                file->pendingSeek = -1;
+                setSoundPosition(id, pos);
+            }
+        }
+
+        // Fin d'un son partagé : signalée une fois lorsque le canal passe le point
+        if (m_EndPoints.at(id) && isChannelUsed(id))
+        {
+            const bool passed = (getSoundPosition(id) >= m_EndPoints.at(id));
+
+            if (passed && !m_EndPassed.at(id) && m_ChannelCallback)
+                m_ChannelCallback(id, ChannelEvent::SYNC_POINT);
+
+            m_EndPassed.at(id) = passed;
+        }
+    }
+
+    updateResidentSounds();
+}
+
+// ==============================
+// ==============================
+
+FMOD_RESULT F_CALLBACK FmodManager::channelCallback(FMOD_CHANNELCONTROL *channelControl, FMOD_CHANNELCONTROL_TYPE controlType,
+                                                    FMOD_CHANNELCONTROL_CALLBACK_TYPE callbackType, void* /*commandData1*/, void* /*commandData2*/)
+{
+    if (!mp_Instance || controlType != FMOD_CHANNELCONTROL_CHANNEL)
+        return FMOD_OK;
+
+    ChannelEvent event;
+
+    if (callbackType == FMOD_CHANNELCONTROL_CALLBACK_END)
+        event = ChannelEvent::END;
+    else if (callbackType == FMOD_CHANNELCONTROL_CALLBACK_SYNCPOINT)
+        event = ChannelEvent::SYNC_POINT;
+    else
+        return FMOD_OK;
+
+    std::lock_guard<std::recursive_mutex> lock(mp_Instance->m_Mutex);
+
+    // Le canal a pu changer d'emplacement (moveSound) : recherche par pointeur
+    std::vector<FMOD_CHANNEL*>& channels = mp_Instance->mp_Channels;
+    auto channel = std::find(channels.begin(), channels.end(), reinterpret_cast<FMOD_CHANNEL*>(channelControl));
+
+    if (channel != channels.end() && mp_Instance->m_ChannelCallback)
+        mp_Instance->m_ChannelCallback(channel - channels.begin(), event);
+
+    return FMOD_OK;
+}
+
+// ==============================
+// ==============================
+
+FMOD_RESULT F_CALLBACK FmodManager::fileOpenCallback(const char *name, unsigned int *filesize, void **handle, void *userdata)
+{
+    SoundFile *file = static_cast<SoundFile*>(userdata);
+
+    if (file->settings.openCallback)
+        return file->settings.openCallback(name, filesize, handle, file->settings.userdata);
+
+    std::FILE *stream = openLocalFile(name);
+
+    if (!stream)
+        return FMOD_ERR_FILE_NOTFOUND;
+
+    long size = getLocalFileSize(stream);
+
+    if (size < 0)
+    {
+        std::fclose(stream);
+        return FMOD_ERR_FILE_BAD;
+    }
+
+    *filesize = static_cast<unsigned int>(size);
+    *handle = stream;
+
+    return FMOD_OK;
+}
+
+// ==============================
+// ==============================
+
+FMOD_RESULT F_CALLBACK FmodManager::fileCloseCallback(void *handle, void *userdata)
+{
+    SoundFile *file = static_cast<SoundFile*>(userdata);
+
+    if (file->settings.closeCallback)
+        return file->settings.closeCallback(handle, file->settings.userdata);
+
+    std::fclose(static_cast<std::FILE*>(handle));
+
+    return FMOD_OK;
+}
+
+// ==============================
+// ==============================
+
+FMOD_RESULT F_CALLBACK FmodManager::fileReadCallback(void *handle, void *buffer, unsigned int sizebytes, unsigned int *bytesread, void *userdata)
+{
+    SoundFile *file = static_cast<SoundFile*>(userdata);
+
+    if (file->settings.readCallback)
+        return file->settings.readCallback(handle, buffer, sizebytes, bytesread, file->settings.userdata);
+
+    *bytesread = std::fread(buffer, 1, sizebytes, static_cast<std::FILE*>(handle));
+
+    return (*bytesread < sizebytes) ? FMOD_ERR_FILE_EOF : FMOD_OK;
+}
+
+// ==============================
+// ==============================
+
+FMOD_RESULT F_CALLBACK FmodManager::fileSeekCallback(void *handle, unsigned int pos, void *userdata)
+{
+    SoundFile *file = static_cast<SoundFile*>(userdata);
+
+    // Déplacement demandé par setSoundPosition : trame indexée au lieu de l'estimation de FMOD
+    const long long offset = file->seekOffset.exchange(-1);
+    const long long time = file->seekTime.exchange(-1);
+
+    if (offset >= 0)
+        pos = static_cast<unsigned int>(offset);
+
+    if (file->settings.seekCallback)
     {
-        ++id;
-    } while (id < mp_Sounds.size() && isPlaying(id));
+        if (time >= 0 && file->settings.seekTimeCallback)
+        {
+            SoundPos_t frameTime = static_cast<SoundPos_t>(time);
+            FMOD_RESULT res = file->settings.seekTimeCallback(handle, pos, frameTime, &frameTime, file->settings.userdata);
+
+            // FMOD place le canal à la position demandée alors que la lecture reprend au début de la trame indexée
+            if (res == FMOD_OK)
+            {
+                file->positionShift = (frameTime < time) ? time - frameTime : 0;
+                file->shiftChanged = true;
+            }
+
+            return res;
+        }
+
+        return file->settings.seekCallback(handle, pos, file->settings.userdata);
+    }
+
+    return (std::fseek(static_cast<std::FILE*>(handle), pos, SEEK_SET) == 0) ? FMOD_OK : FMOD_ERR_FILE_COULDNOTSEEK;
+}
+
+// ==============================
+// ==============================
+
+void FmodManager::setChannelCallback(const ChannelCallback& callback)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_Mutex);
+    m_ChannelCallback = callback;
+}
+
+// ==============================
+// ==============================
+
+void FmodManager::setEndSyncPoint(SoundID_t id, SoundPos_t margin)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_Mutex);
+
+    if (!mp_Sounds.at(id))
+        return;
+
+    FMOD_RESULT res;
+
+    if (mp_SyncPoints.at(id))
+    {
+        if ((res = FMOD_Sound_DeleteSyncPoint(mp_Sounds.at(id), mp_SyncPoints.at(id))) != FMOD_OK)
+            throw exceptions::LibException("FmodManager::setEndSyncPoint", "FMOD_Sound_DeleteSyncPoint", FMOD_ErrorString(res));
+
+        mp_SyncPoints.at(id) = nullptr;
+    }
+
+    SoundPos_t length = getSoundLength(id);
+    SoundPos_t shift = 0;
+    SoundFile *file = m_SoundFiles.at(id).get();
+
+    m_EndPoints.at(id) = 0;
+
+    // Son partagé : point relevé sur la position du canal (voir update)
+    if (findResidentSound(mp_Sounds.at(id)))
+    {
+        if (margin != 0 && margin < length)
+        {
+            m_EndPoints.at(id) = length - margin;
+            m_EndPassed.at(id) = (getSoundPosition(id) >= m_EndPoints.at(id));
+        }
+
+        return;
+    }
+
+    if (file)
+    {
+        file->syncMargin = margin;
+        shift = static_cast<SoundPos_t>(file->positionShift);
+    }
+
+    if (margin == 0 || margin >= length)
+        return;
+
+    // Position du canal, en avance de shift sur la lecture après un déplacement distant
+    SoundPos_t point = std::min(length - margin + shift, length - 1);
+
+    if ((res = FMOD_Sound_AddSyncPoint(mp_Sounds.at(id), point, FMOD_TIMEUNIT_MS, "end", &mp_SyncPoints.at(id))) != FMOD_OK)
+        throw exceptions::LibException("FmodManager::setEndSyncPoint", "FMOD_Sound_AddSyncPoint", FMOD_ErrorString(res));
+}
+
+// ==============================
+// ==============================
+
+SoundID_t FmodManager::getMainSoundID() const
+{
+    return MAIN_VOICE_ID;
+}
+
+// ==============================
+// ==============================
+
+SoundID_t FmodManager::openFromFile(const std::string& soundFile, VoiceRole role, SoundSettings *settings,
+                                     bool nonBlocking, std::shared_ptr<const SeekIndex> index) throw (StreamError)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_Mutex);
+
+    SoundID_t id = allocateVoice(role);
+
+    if (id == NO_VOICE_ID)
+        throw StreamError::VOICE_ERROR;
+
+    openFromFile(id, soundFile, settings, nonBlocking, index);
+
+    return id;
+}
+
+// ==============================
+// ==============================
+
+void FmodManager::openFromFile(SoundID_t id, const std::string& soundFile, SoundSettings *settings,
+                               bool nonBlocking, std::shared_ptr<const SeekIndex> index) throw (StreamError)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_Mutex);
+
+    releaseSound(id);
+    m_Reserved.at(id) = false;
+    m_Busy.at(id) = true;
 
-    return (id < mp_Sounds.size()) ? id : 0;
+    FMOD_RESULT res;
+    FMOD_MODE mode = nonBlocking ? (FMOD_DEFAULT | FMOD_NONBLOCKING) : FMOD_DEFAULT;
+
+    if (!settings && (mp_Sounds.at(id) = openResidentSound(soundFile, nonBlocking)))
+        return;
+
+    // Sans index (débit constant), FMOD lit lui-même le fichier local
+    if (index && index->isEmpty())
+        index = nullptr;
+
+    if (!settings && !index)
+        res = FMOD_System_CreateStream(mp_System, soundFile.c_str(), mode, 0, &mp_Sounds.at(id));
+    else
+    {
+        std::shared_ptr<SoundFile> file = std::make_shared<SoundFile>();
+
+        file->settings = settings ? *settings : SoundSettings();
+        file->path = settings ? std::string() : soundFile;
+        file->index = index;
+        file->seekOffset = -1;
+        file->seekTime = -1;
+        file->pendingSeek = -1;
+        file->positionShift = 0;
+        file->shiftChanged = false;
+        file->syncMargin = 0;
+
+        std::unique_ptr<FMOD_CREATESOUNDEXINFO> soundSettings = std::make_unique<FMOD_CREATESOUNDEXINFO>();
+
+        soundSettings->cbsize = sizeof(FMOD_CREATESOUNDEXINFO);
+        soundSettings->fileuseropen = fileOpenCallback;
+        soundSettings->fileuserclose = fileCloseCallback;
+        soundSettings->fileuserread = fileReadCallback;
+        soundSettings->fileuserseek = fileSeekCallback;
+        soundSettings->fileuserdata = file.get();
+
+        m_SoundFiles.at(id) = file;
+
+        res = FMOD_System_CreateStream(mp_System, soundFile.c_str(), mode, soundSettings.get(), &mp_Sounds.at(id));
+    }
+
+    if (res == FMOD_ERR_FORMAT)
+        throw StreamError::FORMAT_ERROR;
+    else if (res != FMOD_OK)
+        throw StreamError::FILE_ERROR;
+}
+
+// ==============================
+// ==============================
+
+bool FmodManager::isSoundReady(SoundID_t id) const throw (StreamError)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_Mutex);
+
+    if (!mp_Sounds.at(id))
+        throw StreamError::FILE_ERROR;
+
+    FMOD_OPENSTATE state;
+    FMOD_RESULT res = FMOD_Sound_GetOpenState(mp_Sounds.at(id), &state, 0, 0, 0);
+
+    // En cas d'échec de l'ouverture, le code d'erreur est retourné par FMOD_Sound_GetOpenState
+    if (res == FMOD_ERR_FORMAT)
+        throw StreamError::FORMAT_ERROR;
+    else if (res != FMOD_OK || state == FMOD_OPENSTATE_ERROR)
+        throw StreamError::FILE_ERROR;
+
+    return (state == FMOD_OPENSTATE_READY || state == FMOD_OPENSTATE_PLAYING);
+}
+
+// ==============================
+// ==============================
+
+bool FmodManager::isLoading(FMOD_SOUND *sound) const
+{
+    FMOD_OPENSTATE state;
+
+    if (FMOD_Sound_GetOpenState(sound, &state, 0, 0, 0) != FMOD_OK)
+        return false;
+
+    return (state == FMOD_OPENSTATE_LOADING || state == FMOD_OPENSTATE_CONNECTING);
+}
+
+// ==============================
+// ==============================
+
+bool FmodManager::isSeeking(FMOD_SOUND *sound) const
+{
+    FMOD_OPENSTATE state;
+
+    if (FMOD_Sound_GetOpenState(sound, &state, 0, 0, 0) != FMOD_OK)
+        return false;
+
+    return (state == FMOD_OPENSTATE_SETPOSITION);
+}
+
+// ==============================
+// ==============================
+
+std::shared_ptr<void> FmodManager::reserveProbe() const
+{
+    {
+        std::unique_lock<std::mutex> lock(m_ProbeMutex);
+        m_ProbeCondition.wait(lock, [this]() { return m_ProbesNb < VOICE_LIMIT_PROBE; });
+        m_ProbesNb++;
+    }
+
+    return std::shared_ptr<void>(nullptr, [this](void*) {
+        std::lock_guard<std::mutex> lock(m_ProbeMutex);
+        m_ProbesNb--;
+        m_ProbeCondition.notify_one();
+    });
+}
+
+// ==============================
+// ==============================
+
+SoundPos_t FmodManager::getFileLength(const std::string& soundFile, FMOD_SOUND_TYPE *type) const throw (StreamError)
+{
+    // Réservation d'une place de lecture, rendue à la sortie de la fonction
+    std::shared_ptr<void> probe = reserveProbe();
+
+    FMOD_SOUND *sound = nullptr;
+    FMOD_RESULT res = FMOD_System_CreateSound(mp_System, soundFile.c_str(), FMOD_CREATESTREAM | FMOD_OPENONLY, 0, &sound);
+
+    if (res == FMOD_ERR_FORMAT)
+        throw StreamError::FORMAT_ERROR;
+    else if (res != FMOD_OK)
+        throw StreamError::FILE_ERROR;
+
+    SoundPos_t length = 0;
+    res = FMOD_Sound_GetLength(sound, &length, FMOD_TIMEUNIT_MS);
+
+    if (res == FMOD_OK && type)
+        res = FMOD_Sound_GetFormat(sound, type, 0, 0, 0);
+
+    FMOD_Sound_Release(sound);
+
+    if (res != FMOD_OK)
+        throw StreamError::FORMAT_ERROR;
+
+    return length;
+}
+
+// ==============================
+// ==============================
+
+bool FmodManager::decodeFile(const std::string& soundFile, const DecodeCallback& consumer) const throw (StreamError)
+{
+    std::shared_ptr<void> probe = reserveProbe();
+
+    FMOD_SOUND *sound = nullptr;
+    FMOD_RESULT res = FMOD_System_CreateSound(mp_System, soundFile.c_str(), FMOD_CREATESTREAM | FMOD_OPENONLY, 0, &sound);
+
+    if (res == FMOD_ERR_FORMAT)
+        throw StreamError::FORMAT_ERROR;
+    else if (res != FMOD_OK)
+        throw StreamError::FILE_ERROR;
+
+    std::shared_ptr<FMOD_SOUND> soundGuard(sound, FMOD_Sound_Release);
+
+    FMOD_SOUND_FORMAT format;
+    int channels = 0, bits = 0;
+    float frequency = 0;
+
+    if (FMOD_Sound_GetFormat(sound, 0, &format, &channels, &bits) != FMOD_OK
+            || FMOD_Sound_GetDefaults(sound, &frequency, 0) != FMOD_OK || channels <= 0)
+        throw StreamError::FORMAT_ERROR;
+
+    if (format != FMOD_SOUND_FORMAT_PCM8 && format != FMOD_SOUND_FORMAT_PCM16 && format != FMOD_SOUND_FORMAT_PCM24
+            && format != FMOD_SOUND_FORMAT_PCM32 && format != FMOD_SOUND_FORMAT_PCMFLOAT)
+        throw StreamError::FORMAT_ERROR;
+
+    const unsigned int bytes = bits / 8;
+    const unsigned int frameSize = bytes * channels;
+
+    std::vector<unsigned char> data(LOUDNESS_DECODE_FRAMES * frameSize);
+    std::vector<float> samples(LOUDNESS_DECODE_FRAMES * channels);
+
+    while (true)
+    {
+        unsigned int read = 0;
+        res = FMOD_Sound_ReadData(sound, data.data(), data.size(), &read);
+
+        if (res != FMOD_OK && res != FMOD_ERR_FILE_EOF)
+            return false;
+
+        const unsigned int frames = read / frameSize;
+        const unsigned int count = frames * channels;
+        const unsigned char *in = data.data();
+
+        /* Conversion en flottants (entiers signés little endian) */
+        for (unsigned int i = 0; i < count; i++, in += bytes)
+        {
+            switch (format)
+            {
+                case FMOD_SOUND_FORMAT_PCM8:
+                    samples[i] = static_cast<signed char>(in[0]) / 128.0f;
+                    break;
+
+                case FMOD_SOUND_FORMAT_PCM16:
+                    samples[i] = static_cast<std::int16_t>(in[0] | (in[1] << 8)) / 32768.0f;
+                    break;
+
+                case FMOD_SOUND_FORMAT_PCM24:
+                    samples[i] = static_cast<std::int32_t>((in[0] << 8) | (in[1] << 16) | (static_cast<std::uint32_t>(in[2]) << 24)) / 2147483648.0f;
+                    break;
+
+                case FMOD_SOUND_FORMAT_PCM32:
+                    samples[i] = static_cast<std::int32_t>(in[0] | (in[1] << 8) | (in[2] << 16) | (static_cast<std::uint32_t>(in[3]) << 24)) / 2147483648.0f;
+                    break;
+
+                default:
+                    std::memcpy(&samples[i], in, sizeof(float));
+                    break;
+            }
+        }
+
+        if (frames > 0 && !consumer(samples.data(), frames, channels, static_cast<int>(frequency)))
+            return false;
+
+        if (res == FMOD_ERR_FILE_EOF || read < data.size())
+            return true;
+    }
+}
+
+// ==============================
+// ==============================
+
+void FmodManager::releaseSound(SoundID_t id)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_Mutex);
+
+    if (mp_Sounds.at(id))
+    {
+        FMOD_RESULT res;
+
+        if (isChannelUsed(id))
+            stopSound(id);
+
+        m_EndPoints.at(id) = 0;
+
+        // Son chargé en mémoire : gardé pour les prochaines ouvertures
+        if (findResidentSound(mp_Sounds.at(id)))
+        {
+            mp_Sounds.at(id) = nullptr;
+            return;
+        }
+
+        // Le point de synchronisation est libéré avec le son
+        mp_SyncPoints.at(id) = nullptr;
+
+        // Libérer un son en cours d'ouverture bloquerait jusqu'à la fin de l'ouverture
+        if (isLoading(mp_Sounds.at(id)))
+        {
+            mp_PendingReleases.push_back(mp_Sounds.at(id));
+            m_PendingFiles.push_back(m_SoundFiles.at(id));
+
+            mp_Sounds.at(id) = nullptr;
+            m_SoundFiles.at(id) = nullptr;
+            return;
+        }
+
+        res = FMOD_Sound_Release(mp_Sounds.at(id));
+        if (res != FMOD_OK && res != FMOD_ERR_NET_CONNECT)
+            throw exceptions::LibException("FmodManager::releaseSound", "FMOD_Sound_Release", FMOD_ErrorString(res));
+
+        mp_Sounds.at(id) = nullptr;
+    }
+
+    // Le fichier est fermé avec le son
+    m_SoundFiles.at(id) = nullptr;
+}
+
+// ==============================
+// ==============================
+
+void FmodManager::playSound(SoundID_t id, bool paused)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_Mutex);
+
+    FMOD_RESULT res;
+
+    if ((res = FMOD_System_PlaySound(mp_System, mp_Sounds.at(id), 0, paused, &mp_Channels.at(id))) != FMOD_OK)
+        throw exceptions::LibException("FmodManager::playSound", "FMOD_System_PlaySound", FMOD_ErrorString(res));
+
+    m_Busy.at(id) = true;
+
+    if ((res = FMOD_Channel_SetCallback(mp_Channels.at(id), channelCallback)) != FMOD_OK)
+        throw exceptions::LibException("FmodManager::playSound", "FMOD_Channel_SetCallback", FMOD_ErrorString(res));
+}
+
+// ==============================
+// ==============================
+
+void FmodManager::playSoundAfter(SoundID_t id, SoundID_t previousId, SoundPos_t overlap, FadeCurve curve)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_Mutex);
+
+    FMOD_RESULT res;
+
+    if ((res = FMOD_System_PlaySound(mp_System, mp_Sounds.at(id), 0, true, &mp_Channels.at(id))) != FMOD_OK)
+        throw exceptions::LibException("FmodManager::playSoundAfter", "FMOD_System_PlaySound", FMOD_ErrorString(res));
+
+    m_Busy.at(id) = true;
+
+    if ((res = FMOD_Channel_SetCallback(mp_Channels.at(id), channelCallback)) != FMOD_OK)
+        throw exceptions::LibException("FmodManager::playSoundAfter", "FMOD_Channel_SetCallback", FMOD_ErrorString(res));
+
+    scheduleSound(id, previousId, overlap, curve);
+    pauseSound(id, false);
+}
+
+// ==============================
+// ==============================
+
+void FmodManager::scheduleSound(SoundID_t id, SoundID_t previousId, SoundPos_t overlap, FadeCurve curve) const
+{
+    std::lock_guard<std::recursive_mutex> lock(m_Mutex);
+
+    if (!isChannelUsed(id) || !isChannelUsed(previousId))
+        return;
+
+    FMOD_RESULT res;
+    unsigned long long dspClock = 0, parentClock = 0;
+    unsigned int length = 0, pos = 0;
+    float frequency = 0.0;
+
+    if ((res = FMOD_Channel_GetDSPClock(mp_Channels.at(previousId), &dspClock, &parentClock)) != FMOD_OK)
+        throw exceptions::LibException("FmodManager::scheduleSound", "FMOD_Channel_GetDSPClock", FMOD_ErrorString(res));
+
+    if ((res = FMOD_Channel_GetPosition(mp_Channels.at(previousId), &pos, FMOD_TIMEUNIT_PCM)) != FMOD_OK)
+        throw exceptions::LibException("FmodManager::scheduleSound", "FMOD_Channel_GetPosition", FMOD_ErrorString(res));
+
+    if ((res = FMOD_Sound_GetLength(mp_Sounds.at(previousId), &length, FMOD_TIMEUNIT_PCM)) != FMOD_OK)
+        throw exceptions::LibException("FmodManager::scheduleSound", "FMOD_Sound_GetLength", FMOD_ErrorString(res));
+
+    if ((res = FMOD_Channel_GetFrequency(mp_Channels.at(previousId), &frequency)) != FMOD_OK)
+        throw exceptions::LibException("FmodManager::scheduleSound", "FMOD_Channel_GetFrequency", FMOD_ErrorString(res));
+
+    // Echantillons restants du son précédent, convertis en échantillons du mixeur
+    unsigned long long remaining = (length > pos) ? (length - pos) : 0;
+
+    if (frequency > 0)
+        remaining = static_cast<unsigned long long>(remaining * getSampleRate() / frequency);
+
+    unsigned long long fadeLength = std::min(msToDSPClock(overlap), remaining);
+    unsigned long long start = parentClock + remaining - fadeLength;
+
+    if ((res = FMOD_Channel_SetDelay(mp_Channels.at(id), start, 0, false)) != FMOD_OK)
+        throw exceptions::LibException("FmodManager::scheduleSound", "FMOD_Channel_SetDelay", FMOD_ErrorString(res));
+
+    removeFadePoints(id);
+    removeFadePoints(previousId);
+
+    if (fadeLength > 0)
+    {
+        addFadePoints(id, start, fadeLength, true, curve);
+        addFadePoints(previousId, start, fadeLength, false, curve);
+    }
+}
+
+// ==============================
+// ==============================
+
+void FmodManager::fadeInSound(SoundID_t id, SoundPos_t length, FadeCurve curve) const
+{
+    std::lock_guard<std::recursive_mutex> lock(m_Mutex);
+
+    if (!isChannelUsed(id) || length == 0)
+        return;
+
+    removeFadePoints(id);
+    addFadePoints(id, getParentClock(id), msToDSPClock(length), true, curve);
+}
+
+// ==============================
+// ==============================
+
+void FmodManager::fadeOutSound(SoundID_t id, SoundID_t secondaryId, SoundPos_t length, FadeCurve curve)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_Mutex);
+
+    moveToSecondaryCanal(id, secondaryId);
+    id = secondaryId;
+
+    if (!isChannelUsed(id))
+        return;
+
+    FMOD_RESULT res;
+    unsigned long long start = getParentClock(id);
+    unsigned long long fadeLength = msToDSPClock(length);
+
+    removeFadePoints(id);
+    addFadePoints(id, start, fadeLength, false, curve);
+
+    // Le canal s'arrête de lui-même à la fin du fondu
+    if ((res = FMOD_Channel_SetDelay(mp_Channels.at(id), 0, start + fadeLength, true)) != FMOD_OK)
+        throw exceptions::LibException("FmodManager::fadeOutSound", "FMOD_Channel_SetDelay", FMOD_ErrorString(res));
+}
+
+// ==============================
+// ==============================
+
+SoundID_t FmodManager::moveToMainCanal(SoundID_t id)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_Mutex);
+
+    if (id != MAIN_VOICE_ID)
+    {
+        moveSound(id, MAIN_VOICE_ID);
+        m_Roles.at(MAIN_VOICE_ID) = VoiceRole::MAIN;
+    }
+
+    return MAIN_VOICE_ID;
+}
+
+// ==============================
+// ==============================
+
+void FmodManager::moveToSecondaryCanal(SoundID_t id, SoundID_t secondaryId)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_Mutex);
+
+    if (secondaryId == id)
+        return;
+
+    // Aucun canal disponible : le son est coupé
+    if (secondaryId == NO_VOICE_ID)
+    {
+        releaseSound(id);
+        return;
+    }
+
+    moveSound(id, secondaryId);
+    m_Reserved.at(secondaryId) = false;
+}
+
+// ==============================
+// ==============================
+
+void FmodManager::moveSound(SoundID_t from, SoundID_t to)
+{
+    releaseSound(to);
+
+    mp_Sounds.at(to) = mp_Sounds.at(from);
+    mp_Channels.at(to) = mp_Channels.at(from);
+    mp_SyncPoints.at(to) = mp_SyncPoints.at(from);
+    m_EndPoints.at(to) = m_EndPoints.at(from);
+    m_EndPassed.at(to) = m_EndPassed.at(from);
+    m_SoundFiles.at(to) = m_SoundFiles.at(from);
+    m_Busy.at(to) = m_Busy.at(from);
+
+    mp_Sounds.at(from) = nullptr;
+    mp_Channels.at(from) = nullptr;
+    mp_SyncPoints.at(from) = nullptr;
+    m_EndPoints.at(from) = 0;
+    m_SoundFiles.at(from) = nullptr;
+}
+
+// ==============================
+// ==============================
+
+int FmodManager::getSampleRate() const
+{
+    FMOD_RESULT res;
+    int sampleRate = 0;
+
+    if ((res = FMOD_System_GetSoftwareFormat(mp_System, &sampleRate, 0, 0)) != FMOD_OK)
+        throw exceptions::LibException("FmodManager::getSampleRate", "FMOD_System_GetSoftwareFormat", FMOD_ErrorString(res));
+
+    return sampleRate;
+}
+
+// ==============================
+// ==============================
+
+unsigned long long FmodManager::msToDSPClock(SoundPos_t ms) const
+{
+    return static_cast<unsigned long long>(ms) * getSampleRate() / 1000;
 }
 
 // ==============================
 // ==============================
 
-void FmodManager::update() const
+unsigned long long FmodManager::getParentClock(SoundID_t id) const
 {
     FMOD_RESULT res;
+    unsigned long long dspClock = 0, parentClock = 0;
 
-    if ((res = FMOD_System_Update(mp_System)) != FMOD_OK)
-        throw exceptions::LibException("FmodManager::update", "FMOD_System_Update", FMOD_ErrorString(res));
+    if ((res = FMOD_Channel_GetDSPClock(mp_Channels.at(id), &dspClock, &parentClock)) != FMOD_OK)
+        throw exceptions::LibException("FmodManager::getParentClock", "FMOD_Channel_GetDSPClock", FMOD_ErrorString(res));
+
+    return parentClock;
 }
 
 // ==============================
 // ==============================
 
-SoundID_t FmodManager::openFromFile(const std::string& soundFile, bool mainCanal, SoundSettings *settings) throw (StreamError)
+void FmodManager::addFadePoints(SoundID_t id, unsigned long long start, unsigned long long length, bool fadeIn, FadeCurve curve) const
 {
-    SoundID_t id = getSoundID(mainCanal);
-
-    releaseSound(id);
-
     FMOD_RESULT res;
+    constexpr double HALF_PI = 1.57079632679489661923;
 
-    if (!settings)
-        res = FMOD_System_CreateStream(mp_System, soundFile.c_str(), FMOD_DEFAULT, 0, &mp_Sounds.at(id));
-    else
+    // FMOD interpole linéairement entre deux points : la courbe est échantillonnée
+    const unsigned int pointsNb = (curve == FadeCurve::LINEAR) ? 1 : CROSSFADE_CURVE_POINTS;
+
+    for (unsigned int i = 0; i <= pointsNb; i++)
     {
-        std::unique_ptr<FMOD_CREATESOUNDEXINFO> soundSettings = std::make_unique<FMOD_CREATESOUNDEXINFO>();
+        double t = static_cast<double>(i) / pointsNb;
+        double volume = (curve == FadeCurve::LINEAR) ? t : std::sin(t * HALF_PI);
 
-        soundSettings->cbsize = sizeof(FMOD_CREATESOUNDEXINFO);
-        soundSettings->fileuseropen = settings->openCallback;
-        soundSettings->fileuserclose = settings->closeCallback;
-        soundSettings->fileuserread = settings->readCallback;
-        soundSettings->fileuserseek = settings->seekCallback;
-        soundSettings->fileuserdata = settings->userdata;
+        if (!fadeIn)
+            volume = (curve == FadeCurve::LINEAR) ? 1.0 - t : std::cos(t * HALF_PI);
 
-        res = FMOD_System_CreateStream(mp_System, soundFile.c_str(), FMOD_DEFAULT, soundSettings.get(), &mp_Sounds.at(id));
+        if ((res = FMOD_Channel_AddFadePoint(mp_Channels.at(id), start + length * i / pointsNb, static_cast<float>(volume))) != FMOD_OK)
+            throw exceptions::LibException("FmodManager::addFadePoints", "FMOD_Channel_AddFadePoint", FMOD_ErrorString(res));
     }
-
-    if (res == FMOD_ERR_FORMAT)
-        throw StreamError::FORMAT_ERROR;
-    else if (res != FMOD_OK)
-        throw StreamError::FILE_ERROR;
-
-    return id;
 }
 
 // ==============================
 // ==============================
 
-void FmodManager::releaseSound(SoundID_t id)
+void FmodManager::removeFadePoints(SoundID_t id) const
 {
-    if (mp_Sounds.at(id))
-    {
-        FMOD_RESULT res;
-
-        if (isChannelUsed(id))
-            stopSound(id);
+    std::lock_guard<std::recursive_mutex> lock(m_Mutex);
 
-        if (mp_Dsps.at(id))
-        {
-            if ((res = FMOD_DSP_Release(mp_Dsps.at(id))) != FMOD_OK)
-                throw exceptions::LibException("FmodManager::releaseSound", "FMOD_DSP_Release", FMOD_ErrorString(res));
-
-            mp_Dsps.at(id) = nullptr;
-        }
+    if (!isChannelUsed(id))
+        return;
 
-        res = FMOD_Sound_Release(mp_Sounds.at(id));
-        if (res != FMOD_OK && res != FMOD_ERR_NET_CONNECT)
-            throw exceptions::LibException("FmodManager::releaseSound", "FMOD_Sound_Release", FMOD_ErrorString(res));
+    FMOD_RESULT res;
 
-        mp_Sounds.at(id) = nullptr;
-    }
+    if ((res = FMOD_Channel_RemoveFadePoints(mp_Channels.at(id), 0, std::numeric_limits<unsigned long long>::max())) != FMOD_OK)
+        throw exceptions::LibException("FmodManager::removeFadePoints", "FMOD_Channel_RemoveFadePoints", FMOD_ErrorString(res));
 }
 
 // ==============================
 // ==============================
 
-void FmodManager::addDSP(SoundID_t id, unsigned int size)
+bool FmodManager::isBuffered(SoundID_t id, unsigned int minPercent) const
 {
-    FMOD_RESULT res;
+    std::lock_guard<std::recursive_mutex> lock(m_Mutex);
 
-    if ((res = FMOD_System_CreateDSPByType(mp_System, FMOD_DSP_TYPE_FFT, &mp_Dsps.at(id))) != FMOD_OK)
-        throw exceptions::LibException("FmodManager::addDSP", "FMOD_System_CreateDSPByType", FMOD_ErrorString(res));
-
-    if ((res = FMOD_DSP_SetParameterInt(mp_Dsps.at(id), FMOD_DSP_FFT_WINDOWSIZE, size)) != FMOD_OK)
-        throw exceptions::LibException("FmodManager::addDSP", "FMOD_DSP_SetParameterInt", FMOD_ErrorString(res));
-}
+    if (!mp_Sounds.at(id))
+        return false;
 
-// ==============================
-// ==============================
+    // Un son chargé en mémoire ne manque jamais de données
+    if (findResidentSound(mp_Sounds.at(id)))
+        return !isLoading(mp_Sounds.at(id));
 
-void FmodManager::playSound(SoundID_t id)
-{
     FMOD_RESULT res;
+    FMOD_OPENSTATE state;
+    unsigned int percentBuffered = 0;
+    FMOD_BOOL starving = false;
 
-    if ((res = FMOD_System_PlaySound(mp_System, mp_Sounds.at(id), 0, false, &mp_Channels.at(id))) != FMOD_OK)
-        throw exceptions::LibException("FmodManager::playSound", "FMOD_System_PlaySound", FMOD_ErrorString(res));
+    if ((res = FMOD_Sound_GetOpenState(mp_Sounds.at(id), &state, &percentBuffered, &starving, 0)) != FMOD_OK)
+        throw exceptions::LibException("FmodManager::isBuffered", "FMOD_Sound_GetOpenState", FMOD_ErrorString(res));
 
-    if (mp_Dsps.at(id))
-    {
-        if ((res = FMOD_Channel_AddDSP(mp_Channels.at(id), 0, mp_Dsps.at(id))) != FMOD_OK)
-            throw exceptions::LibException("FmodManager::playSound", "FMOD_ChannelGroup_AddDSP", FMOD_ErrorString(res));
-    }
+    return (state != FMOD_OPENSTATE_ERROR && !starving && percentBuffered >= minPercent);
 }
 
 // ==============================
@@ -214,15 +1170,16 @@ bool FmodManager::isChannelUsed(SoundID_t id) const
 
 void FmodManager::stopSound(SoundID_t id)
 {
+    std::lock_guard<std::recursive_mutex> lock(m_Mutex);
+
     if (isChannelUsed(id))
     {
         FMOD_RESULT res;
 
-        if (mp_Dsps.at(id))
-        {
-            if ((res = FMOD_Channel_RemoveDSP(mp_Channels.at(id), mp_Dsps.at(id))) != FMOD_OK)
-                throw exceptions::LibException("FmodManager::stopSound", "FMOD_ChannelGroup_RemoveDSP", FMOD_ErrorString(res));
-        }
+        // Un arrêt demandé n'est pas signalé comme une fin de lecture
+        res = FMOD_Channel_SetCallback(mp_Channels.at(id), nullptr);
+        if (res != FMOD_OK && res != FMOD_ERR_INVALID_HANDLE)
+            throw exceptions::LibException("FmodManager::stopSound", "FMOD_Channel_SetCallback", FMOD_ErrorString(res));
 
         if ((res = FMOD_Channel_Stop(mp_Channels.at(id))) != FMOD_OK)
             throw exceptions::LibException("FmodManager::stopSound", "FMOD_Channel_Stop", FMOD_ErrorString(res));
@@ -236,6 +1193,8 @@ void FmodManager::stopSound(SoundID_t id)
 
 void FmodManager::pauseSound(SoundID_t id, bool paused) const
 {
+    std::lock_guard<std::recursive_mutex> lock(m_Mutex);
+
     if (isChannelUsed(id))
     {
         FMOD_RESULT res;
@@ -250,6 +1209,8 @@ void FmodManager::pauseSound(SoundID_t id, bool paused) const
 
 SoundPos_t FmodManager::getSoundLength(SoundID_t id) const
 {
+    std::lock_guard<std::recursive_mutex> lock(m_Mutex);
+
     FMOD_RESULT res;
     SoundPos_t length = 0;
 
@@ -264,14 +1225,30 @@ SoundPos_t FmodManager::getSoundLength(SoundID_t id) const
 
 SoundPos_t FmodManager::getSoundPosition(SoundID_t id) const
 {
+    std::lock_guard<std::recursive_mutex> lock(m_Mutex);
+
     SoundPos_t pos = 0;
 
     if (isChannelUsed(id))
     {
         FMOD_RESULT res;
 
-        if ((res = FMOD_Channel_GetPosition(mp_Channels.at(id), &pos, FMOD_TIMEUNIT_MS)) != FMOD_OK)
+        res = FMOD_Channel_GetPosition(mp_Channels.at(id), &pos, FMOD_TIMEUNIT_MS);
+
+        // Canal terminé (un arrêt demandé libère le canal, voir stopSound) : le son a été joué jusqu'à sa fin
+        if (res == FMOD_ERR_INVALID_HANDLE)
+            return getSoundLength(id);
+        else if (res != FMOD_OK)
             throw exceptions::LibException("FmodManager::getSoundPosition", "FMOD_Channel_GetPosition", FMOD_ErrorString(res));
+
+        // Lecture reprise au début de la trame indexée, avant la position où FMOD a placé le canal
+        const SoundFile *file = m_SoundFiles.at(id).get();
+
+        if (file)
+        {
+            SoundPos_t shift = static_cast<SoundPos_t>(file->positionShift);
+            pos = (pos > shift) ? pos - shift : 0;
+        }
     }
 
     return pos;
@@ -282,9 +1259,44 @@ SoundPos_t FmodManager::getSoundPosition(SoundID_t id) const
 
 void FmodManager::setSoundPosition(SoundID_t id, SoundPos_t pos)
 {
+    std::lock_guard<std::recursive_mutex> lock(m_Mutex);
+
     if (isChannelUsed(id))
     {
         FMOD_RESULT res;
+        SoundFile *file = m_SoundFiles.at(id).get();
+
+        // Correction du déplacement précédent pas encore utilisée par FMOD : appliqué à la fin de celui-ci (voir update)
+        if (file && (file->seekOffset >= 0 || file->seekTime >= 0) && isSeeking(mp_Sounds.at(id)))
+        {
+            file->pendingSeek = pos;
+            return;
+        }
+
+        // Comme un point de synchronisation, un point de fin sauté par le déplacement n'est pas signalé
+        m_EndPassed.at(id) = (m_EndPoints.at(id) && pos >= m_EndPoints.at(id));
+
+        // Trame contenant la position, lue à sa position dans le fichier : FMOD décode à partir
+        // de son début et écarte les échantillons qui précèdent la position exacte
+        if (file && file->index)
+        {
+            const SeekIndex::Entry entry = file->index->locate(file->path, pos);
+            const unsigned long long sample = static_cast<unsigned long long>(pos) * file->index->getSampleRate() / 1000;
+
+            file->seekOffset = entry.offset;
+
+            if ((res = FMOD_Channel_SetPosition(mp_Channels.at(id), static_cast<unsigned int>(sample), FMOD_TIMEUNIT_PCM)) != FMOD_OK)
+                throw exceptions::LibException("FmodManager::setSoundPosition", "FMOD_Channel_SetPosition", FMOD_ErrorString(res));
+
+            return;
+        }
+
+        if (file && file->settings.seekTimeCallback)
+        {
+            file->seekTime = pos;
+            file->positionShift = 0;
+            file->shiftChanged = true;
+        }
 
         if ((res = FMOD_Channel_SetPosition(mp_Channels.at(id), pos, FMOD_TIMEUNIT_MS)) != FMOD_OK)
             throw exceptions::LibException("FmodManager::setSoundPosition", "FMOD_Channel_SetPosition", FMOD_ErrorString(res));
@@ -296,13 +1308,16 @@ void FmodManager::setSoundPosition(SoundID_t id, SoundPos_t pos)
 
 bool FmodManager::isPlaying(SoundID_t id) const
 {
+    std::lock_guard<std::recursive_mutex> lock(m_Mutex);
+
     FMOD_BOOL playing = false;
 
     if (isChannelUsed(id))
     {
         FMOD_RESULT res;
 
-        if ((res = FMOD_Channel_IsPlaying(mp_Channels.at(id), &playing)) != FMOD_OK)
+        res = FMOD_Channel_IsPlaying(mp_Channels.at(id), &playing);
+        if (res != FMOD_OK && res != FMOD_ERR_INVALID_HANDLE)
             throw exceptions::LibException("FmodManager::isPlaying", "FMOD_Channel_IsPlaying", FMOD_ErrorString(res));
     }
 
@@ -312,21 +1327,54 @@ bool FmodManager::isPlaying(SoundID_t id) const
 // ==============================
 // ==============================
 
-std::vector<float>& FmodManager::getChannelSpectrum(SoundID_t id, std::vector<float>& values) const
+bool FmodManager::getSpectrumFrame(SpectrumFrame& frame)
 {
-    if (isChannelUsed(id) && mp_Dsps.at(id))
-    {
-        FMOD_RESULT res;
-        FMOD_DSP_PARAMETER_FFT *fft;
+    unsigned long long clock = 0;
+    unsigned int bufferLength = 0;
+    int buffersNb = 0;
+
+    if (FMOD_ChannelGroup_GetDSPClock(mp_ChannelGroup, &clock, nullptr) != FMOD_OK ||
+        FMOD_System_GetDSPBufferSize(mp_System, &bufferLength, &buffersNb) != FMOD_OK)
+        return false;
+
+    // Le mixeur a une avance de buffersNb buffers sur la sortie
+    const unsigned long long latency = static_cast<unsigned long long>(bufferLength) * buffersNb;
+    const unsigned long long heard = (clock > latency) ? clock - latency : 0;
+
+    bool found = false;
+
+    while (m_SpectrumFrames.popIf(frame, [heard](const SpectrumFrame& f) { return f.clock <= heard; }))
+        found = true;
+
+    return found;
+}
+
+// ==============================
+// ==============================
+
+void FmodManager::setSpectrumEnabled(bool enabled)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_Mutex);
+
+    if (enabled == m_SpectrumEnabled)
+        return;
+
+    FMOD_RESULT res;
 
-        if ((res = FMOD_DSP_GetParameterData(mp_Dsps.at(id), FMOD_DSP_FFT_SPECTRUMDATA, (void**)&fft, 0, 0, 0)) != FMOD_OK)
-            throw exceptions::LibException("FmodManager::getChannelSpectrum", "FMOD_DSP_GetParameterData", FMOD_ErrorString(res));
+    // Le DSP est créé une seule fois, à l'entrée du groupe principal (avant le volume global)
+    if (!mp_SpectrumDsp)
+    {
+        mp_SpectrumDsp = SpectrumDsp::create(mp_System, SPECTRUM_WIDTH, &m_SpectrumFrames);
 
-        for (int bin = 0; bin < fft->length; bin++)
-            values[bin] = (fft->spectrum[0][bin] + fft->spectrum[1][bin]) / 2.0;
+        if ((res = FMOD_ChannelGroup_AddDSP(mp_ChannelGroup, FMOD_CHANNELCONTROL_DSP_TAIL, mp_SpectrumDsp)) != FMOD_OK)
+            throw exceptions::LibException("FmodManager::setSpectrumEnabled", "FMOD_ChannelGroup_AddDSP", FMOD_ErrorString(res));
     }
 
-    return values;
+    // Un DSP contourné n'est plus appelé par le mixeur
+    if ((res = FMOD_DSP_SetBypass(mp_SpectrumDsp, !enabled)) != FMOD_OK)
+        throw exceptions::LibException("FmodManager::setSpectrumEnabled", "FMOD_DSP_SetBypass", FMOD_ErrorString(res));
+
+    m_SpectrumEnabled = enabled;
 }
 
 // ==============================
@@ -334,6 +1382,8 @@ std::vector<float>& FmodManager::getChannelSpectrum(SoundID_t id, std::vector<fl
 
 float FmodManager::getVolume(SoundID_t id) const
 {
+    std::lock_guard<std::recursive_mutex> lock(m_Mutex);
+
     float volume = 0.0;
 
     if (isChannelUsed(id))
@@ -352,6 +1402,8 @@ float FmodManager::getVolume(SoundID_t id) const
 
 void FmodManager::setVolume(SoundID_t id, float volume) const
 {
+    std::lock_guard<std::recursive_mutex> lock(m_Mutex);
+
     if (isChannelUsed(id))
     {
         FMOD_RESULT res;
@@ -366,6 +1418,8 @@ void FmodManager::setVolume(SoundID_t id, float volume) const
 
 void FmodManager::setVolume(float volume) const
 {
+    std::lock_guard<std::recursive_mutex> lock(m_Mutex);
+
     FMOD_RESULT res;
 
     if ((res = FMOD_ChannelGroup_SetVolume(mp_ChannelGroup, volume)) != FMOD_OK)
@@ -377,6 +1431,8 @@ void FmodManager::setVolume(float volume) const
 
 void FmodManager::setMute(bool mute) const
 {
+    std::lock_guard<std::recursive_mutex> lock(m_Mutex);
+
     FMOD_RESULT res;
 
     if ((res = FMOD_ChannelGroup_SetMute(mp_ChannelGroup, static_cast<FMOD_BOOL>(mute))) != FMOD_OK)
@@ -388,6 +1444,8 @@ void FmodManager::setMute(bool mute) const
 
 char* FmodManager::getSongPictureData(SoundID_t id, unsigned int *dataLength) const
 {
+    std::lock_guard<std::recursive_mutex> lock(m_Mutex);
+
     FMOD_RESULT res;
     FMOD_TAG tag;
 
@@ -413,5 +1471,333 @@ char* FmodManager::getSongPictureData(SoundID_t id, unsigned int *dataLength) co
     }
 }
 
+// ==============================
+// ==============================
+
+unsigned int FmodManager::getFileBufferSize() const
+{
+    FMOD_RESULT res;
+    unsigned int size = 0;
+    FMOD_TIMEUNIT unit;
+
+    if ((res = FMOD_System_GetStreamBufferSize(mp_System, &size, &unit)) != FMOD_OK)
+        throw exceptions::LibException("FmodManager::getFileBufferSize", "FMOD_System_GetStreamBufferSize", FMOD_ErrorString(res));
+
+    return size;
+}
+
+// ==============================
+// ==============================
+
+FMOD_SOUND* FmodManager::openResidentSound(const std::string& soundFile, bool nonBlocking)
+{
+    const unsigned int opens = ++m_OpenCounts[soundFile];
+
+    // Vieillissement des compteurs : seuls les fichiers rejoués récemment restent comptés
+    while (m_OpenCounts.size() > SAMPLE_OPEN_COUNTS_NB)
+    {
+        for (auto it = m_OpenCounts.begin(); it != m_OpenCounts.end();)
+        {
+            if ((it->second /= 2) == 0)
+                it = m_OpenCounts.erase(it);
+            else
+                ++it;
+        }
+    }
+
+    for (ResidentSound& resident : m_ResidentSounds)
+    {
+        if (resident.file == soundFile)
+        {
+            resident.lastUse = ++m_ResidentCounter;
+            return resident.sound;
+        }
+    }
+
+    std::FILE *stream = openLocalFile(soundFile.c_str());
+    if (!stream)
+        return nullptr;
+
+    const long size = getLocalFileSize(stream);
+    std::fclose(stream);
+
+    if (size < 0 || static_cast<unsigned long>(size) > SAMPLE_LARGE_FILE_SIZE)
+        return nullptr;
+
+    // Petit fichier : décodé une fois pour toutes, fichier souvent rejoué : gardé compressé
+    const bool small = (static_cast<unsigned long>(size) <= SAMPLE_SMALL_FILE_SIZE);
+
+    if (!small && opens < SAMPLE_REPLAY_COUNT)
+        return nullptr;
+
+    const std::size_t memory = small ? static_cast<std::size_t>(size) * PCM_SIZE_RATIO : static_cast<std::size_t>(size);
+
+    if (!evictResidentSounds(memory))
+        return nullptr;
+
+    FMOD_MODE mode = small ? FMOD_CREATESAMPLE : FMOD_CREATECOMPRESSEDSAMPLE;
+    FMOD_SOUND *sound = nullptr;
+
+    if (nonBlocking)
+        mode |= FMOD_NONBLOCKING;
+
+    // Format non supporté en mémoire ou fichier illisible : l'ouverture en stream signalera l'erreur
+    if (FMOD_System_CreateSound(mp_System, soundFile.c_str(), mode, 0, &sound) != FMOD_OK)
+        return nullptr;
+
+    m_ResidentSounds.push_back({ soundFile, sound, !small, false, memory, ++m_ResidentCounter });
+
+    return sound;
+}
+
+// ==============================
+// ==============================
+
+const FmodManager::ResidentSound* FmodManager::findResidentSound(FMOD_SOUND *sound) const
+{
+    auto resident = std::find_if(m_ResidentSounds.begin(), m_ResidentSounds.end(), [sound](const ResidentSound& r) {
+        return r.sound == sound;
+    });
+
+    return (resident != m_ResidentSounds.end()) ? &(*resident) : nullptr;
+}
+
+// ==============================
+// ==============================
+
+bool FmodManager::isSoundUsed(FMOD_SOUND *sound) const
+{
+    return std::find(mp_Sounds.begin(), mp_Sounds.end(), sound) != mp_Sounds.end();
+}
+
+// ==============================
+// ==============================
+
+std::size_t FmodManager::getResidentMemory() const
+{
+    std::size_t memory = 0;
+
+    for (const ResidentSound& resident : m_ResidentSounds)
+        memory += resident.memory;
+
+    return memory;
+}
+
+// ==============================
+// ==============================
+
+bool FmodManager::evictResidentSounds(std::size_t memory)
+{
+    if (memory > m_SampleBudget)
+        return false;
+
+    while (getResidentMemory() + memory > m_SampleBudget)
+    {
+        auto oldest = m_ResidentSounds.end();
+
+        // Libérer un son en cours de chargement bloquerait jusqu'à la fin du chargement
+        for (auto it = m_ResidentSounds.begin(); it != m_ResidentSounds.end(); ++it)
+        {
+            if (!isSoundUsed(it->sound) && !isLoading(it->sound) && (oldest == m_ResidentSounds.end() || it->lastUse < oldest->lastUse))
+                oldest = it;
+        }
+
+        if (oldest == m_ResidentSounds.end())
+            return false;
+
+        FMOD_Sound_Release(oldest->sound);
+        m_ResidentSounds.erase(oldest);
+    }
+
+    return true;
+}
+
+// ==============================
+// ==============================
+
+void FmodManager::updateResidentSounds()
+{
+    for (auto it = m_ResidentSounds.begin(); it != m_ResidentSounds.end();)
+    {
+        FMOD_OPENSTATE state = FMOD_OPENSTATE_READY;
+        FMOD_RESULT res = it->measured ? FMOD_OK : FMOD_Sound_GetOpenState(it->sound, &state, 0, 0, 0);
+
+        if (it->measured || (res == FMOD_OK && state == FMOD_OPENSTATE_LOADING))
+        {
+            ++it;
+            continue;
+        }
+
+        // Chargement échoué : le son est libéré dès que plus aucun canal ne l'utilise
+        if (res != FMOD_OK || state == FMOD_OPENSTATE_ERROR)
+        {
+            if (!isSoundUsed(it->sound))
+            {
+                FMOD_Sound_Release(it->sound);
+                it = m_ResidentSounds.erase(it);
+            }
+            else
+                ++it;
+
+            continue;
+        }
+
+        // Un échantillon compressé garde le format du fichier, les autres sont décodés en PCM
+        FMOD_SOUND_FORMAT format;
+        unsigned int length;
+
+        FMOD_TIMEUNIT unit = (FMOD_Sound_GetFormat(it->sound, 0, &format, 0, 0) == FMOD_OK && format == FMOD_SOUND_FORMAT_BITSTREAM)
+                             ? FMOD_TIMEUNIT_RAWBYTES : FMOD_TIMEUNIT_PCMBYTES;
+
+        if (FMOD_Sound_GetLength(it->sound, &length, unit) == FMOD_OK)
+            it->memory = length;
+
+        it->measured = true;
+        ++it;
+    }
+
+    evictResidentSounds(0);
+}
+
+// ==============================
+// ==============================
+
+std::size_t FmodManager::getVoiceMemory(SoundID_t id) const
+{
+    // Durée du buffer de décodage des streams par défaut (FMOD_CREATESOUNDEXINFO::decodebuffersize)
+    constexpr unsigned int DECODE_BUFFER_MS = 400;
+
+    FMOD_SOUND *sound = mp_Sounds.at(id);
+
+    // Mémoire comptée avec les sons chargés (voir getResidentSounds)
+    if (findResidentSound(sound))
+        return 0;
+
+    std::size_t memory = getFileBufferSize();
+
+    if (isLoading(sound))
+        return memory;
+
+    int channels = 0, bits = 0;
+    float frequency = 0;
+
+    if (FMOD_Sound_GetFormat(sound, 0, 0, &channels, &bits) == FMOD_OK && FMOD_Sound_GetDefaults(sound, &frequency, 0) == FMOD_OK)
+        memory += static_cast<std::size_t>(frequency * DECODE_BUFFER_MS / 1000) * channels * (bits / 8);
+
+    return memory;
+}
+
+// ==============================
+// ==============================
+
+unsigned int FmodManager::getVoiceCpuCost(SoundID_t id) const
+{
+    FMOD_BOOL paused = true;
+
+    if (!isPlaying(id) || FMOD_Channel_GetPaused(mp_Channels.at(id), &paused) != FMOD_OK || paused)
+        return 0;
+
+    int channels = 0;
+    float frequency = 0;
+
+    if (FMOD_Sound_GetFormat(mp_Sounds.at(id), 0, 0, &channels, 0) != FMOD_OK || FMOD_Sound_GetDefaults(mp_Sounds.at(id), &frequency, 0) != FMOD_OK)
+        return 0;
+
+    return static_cast<unsigned int>(frequency) * channels;
+}
+
+// ==============================
+// ==============================
+
+std::vector<FmodManager::VoiceInfo> FmodManager::getVoices() const
+{
+    std::lock_guard<std::recursive_mutex> lock(m_Mutex);
+
+    std::vector<VoiceInfo> voices;
+
+    for (SoundID_t id = 0; id < mp_Sounds.size(); id++)
+    {
+        if (!mp_Sounds.at(id))
+            continue;
+
+        VoiceInfo voice;
+        voice.id = id;
+        voice.role = m_Roles.at(id);
+        voice.priority = getPriority(voice.role);
+        voice.loading = isLoading(mp_Sounds.at(id));
+        voice.playing = isPlaying(id);
+        voice.memory = getVoiceMemory(id);
+        voice.cpuCost = getVoiceCpuCost(id);
+
+        voices.push_back(voice);
+    }
+
+    unsigned int probesNb;
+
+    {
+        std::lock_guard<std::mutex> probeLock(m_ProbeMutex);
+        probesNb = m_ProbesNb;
+    }
+
+    // Lectures de durée : stream ouvert sans décodage ni canal
+    for (unsigned int i = 0; i < probesNb; i++)
+    {
+        VoiceInfo voice = { NO_VOICE_ID, VoiceRole::PROBE, getPriority(VoiceRole::PROBE), true, false, getFileBufferSize(), 0 };
+        voices.push_back(voice);
+    }
+
+    return voices;
+}
+
+// ==============================
+// ==============================
+
+std::vector<FmodManager::ResidentInfo> FmodManager::getResidentSounds() const
+{
+    std::lock_guard<std::recursive_mutex> lock(m_Mutex);
+
+    std::vector<const ResidentSound*> residents;
+
+    for (const ResidentSound& resident : m_ResidentSounds)
+        residents.push_back(&resident);
+
+    std::sort(residents.begin(), residents.end(), [](const ResidentSound *a, const ResidentSound *b) {
+        return a->lastUse > b->lastUse;
+    });
+
+    std::vector<ResidentInfo> infos;
+
+    for (const ResidentSound *resident : residents)
+    {
+        auto opens = m_OpenCounts.find(resident->file);
+
+        infos.push_back({ resident->file, resident->memory, resident->compressed, isLoading(resident->sound), isSoundUsed(resident->sound),
+                          (opens != m_OpenCounts.end()) ? opens->second : 0 });
+    }
+
+    return infos;
+}
+
+// ==============================
+// ==============================
+
+std::size_t FmodManager::getSampleBudget() const
+{
+    std::lock_guard<std::recursive_mutex> lock(m_Mutex);
+
+    return m_SampleBudget;
+}
+
+// ==============================
+// ==============================
+
+void FmodManager::setSampleBudget(std::size_t budget)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_Mutex);
+
+    m_SampleBudget = budget;
+    evictResidentSounds(0);
+}
+
 
 } // audio
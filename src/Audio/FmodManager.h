@@ -16,8 +16,16 @@
 #include <fmod_errors.h>
 #include <vector>
 #include <string>
+#include <map>
+#include <mutex>
+#include <functional>
+#include <memory>
+#include <condition_variable>
+#include <atomic>
 
 #include "Constants.h"
+#include "SpectrumDsp.h"
+#include "SeekIndex.h"
 
 
 namespace audio {
@@ -29,12 +37,34 @@ constexpr float VOLUME_MAX = 1.0;
 using SoundID_t = unsigned int;
 using SoundPos_t = unsigned int;    // Position en ms
 
+// Courbe des fondus enchaînés (puissance constante : sin/cos)
+enum class FadeCurve { LINEAR, EQUAL_POWER };
+
+// Evénements remontés par les callbacks des canaux (fin de lecture, point de synchronisation)
+enum class ChannelEvent { END, SYNC_POINT };
+
+using ChannelCallback = std::function<void(SoundID_t, ChannelEvent)>;
+
+// Reçoit un bloc d'échantillons décodés (entrelacés), leur nombre par canal, le nombre de canaux
+// et la fréquence d'échantillonnage ; retourne false pour arrêter le décodage
+using DecodeCallback = std::function<bool(const float*, unsigned int, int, int)>;
+
+// Rôle d'un canal du pool : musique courante, musique suivante pré-chargée, preview,
+// fondu de sortie de la musique précédente, lecture de la durée d'un fichier (sans canal)
+enum class VoiceRole { MAIN, NEXT, PREVIEW, CROSSFADE, PROBE };
+
+// Déplacement dans un fichier distant vers la position demandée (ms) : l'autre client la convertit
+// lui-même en position dans le fichier grâce à son index, pos n'étant que l'estimation de FMOD.
+// frameTime reçoit le début de la trame où la lecture reprend (ms, inchangé sans index)
+typedef FMOD_RESULT (*SeekTimeCallback)(void *handle, unsigned int pos, SoundPos_t time, SoundPos_t *frameTime, void *userdata);
+
 typedef struct
 {
     FMOD_FILE_OPEN_CALLBACK openCallback;
     FMOD_FILE_CLOSE_CALLBACK closeCallback;
     FMOD_FILE_READ_CALLBACK readCallback;
     FMOD_FILE_SEEK_CALLBACK seekCallback;
+    SeekTimeCallback seekTimeCallback;      // Optionnel (seekCallback utilisé sinon)
 
     void *userdata;
 } SoundSettings;
@@ -49,10 +79,88 @@ class FmodManager
 
         std::vector<FMOD_SOUND*> mp_Sounds;
 
-        std::vector<FMOD_DSP*> mp_Dsps;
-
         FMOD_CHANNELGROUP *mp_ChannelGroup;
 
+        // Sons abandonnés pendant leur ouverture asynchrone, libérés une fois l'ouverture terminée
+        std::vector<FMOD_SOUND*> mp_PendingReleases;
+
+        // Fichier d'un son lu au travers des callbacks de FmodManager : le déplacement dans le fichier
+        // demandé par setSoundPosition est corrigé grâce à l'index du fichier (local) ou confié à l'autre client (distant).
+        // La correction ne vaut que pour ce déplacement : elle est retirée dès que FMOD l'a terminé (voir update),
+        // et un nouveau déplacement attend que la correction du précédent ait été utilisée
+        struct SoundFile
+        {
+            SoundSettings settings;                     // Callbacks du fichier distant (openCallback nul : fichier local)
+            std::string path;                           // Fichier local (voir SeekIndex::locate)
+            std::shared_ptr<const SeekIndex> index;
+            std::atomic<long long> seekOffset;          // Position du déplacement en cours (octets, -1 : celle de FMOD)
+            std::atomic<long long> seekTime;            // Position demandée au déplacement distant en cours (ms, -1 : aucune)
+            long long pendingSeek;                      // Déplacement en attente (ms, -1 : aucun)
+            std::atomic<long long> positionShift;       // Avance du canal sur la lecture après un déplacement distant (ms)
+            std::atomic<bool> shiftChanged;             // Point de synchronisation de fin à déplacer (voir update)
+            SoundPos_t syncMargin;                      // Marge du point de synchronisation de fin (ms)
+        };
+
+        // Fichiers des sons (nullptr si FMOD lit lui-même le fichier), et de chaque son de mp_PendingReleases
+        std::vector<std::shared_ptr<SoundFile>> m_SoundFiles;
+        std::vector<std::shared_ptr<SoundFile>> m_PendingFiles;
+
+        // Son chargé entièrement en mémoire, partagé par les canaux qui ouvrent son fichier (voir openResidentSound)
+        struct ResidentSound
+        {
+            std::string file;
+            FMOD_SOUND *sound;
+            bool compressed;                // Gardé compressé et décodé à la lecture (sinon décodé en PCM au chargement)
+            bool measured;                  // Mémoire mesurée une fois le chargement terminé (estimée avant)
+            std::size_t memory;             // Octets
+            unsigned long long lastUse;     // Ordre de la dernière ouverture (éviction de la moins récente)
+        };
+
+        std::vector<ResidentSound> m_ResidentSounds;
+        unsigned long long m_ResidentCounter;
+        std::size_t m_SampleBudget;
+
+        // Nombre d'ouvertures récentes de chaque fichier local : divisés par 2 (et retirés à 0)
+        // dès que plus de SAMPLE_OPEN_COUNTS_NB fichiers sont comptés
+        std::map<std::string, unsigned int> m_OpenCounts;
+
+        // Rôle et ordre d'attribution de chaque canal (éviction du plus ancien)
+        std::vector<VoiceRole> m_Roles;
+        std::vector<unsigned long long> m_VoiceAges;
+        unsigned long long m_VoicesCounter;
+
+        // Canaux attribués par reserveVoice dont le son n'a pas encore été ouvert ou déplacé par le thread audio
+        std::vector<bool> m_Reserved;
+
+        // Canaux en cours d'ouverture ou de lecture, relevés par le thread audio (voir update) :
+        // reserveVoice choisit un canal sans interroger FMOD depuis le thread graphique
+        std::vector<bool> m_Busy;
+
+        // Lectures sans canal en cours (getFileLength, decodeFile), limitées à VOICE_LIMIT_PROBE
+        mutable std::mutex m_ProbeMutex;
+        mutable std::condition_variable m_ProbeCondition;
+        mutable unsigned int m_ProbesNb;
+
+        // Point de synchronisation de fin de chaque son (voir setEndSyncPoint)
+        std::vector<FMOD_SYNCPOINT*> mp_SyncPoints;
+
+        // Un son chargé en mémoire est partagé entre canaux et ne porte aucun point de synchronisation :
+        // sa fin (ms, 0 : aucune) est relevée sur la position de chaque canal à chaque update
+        std::vector<SoundPos_t> m_EndPoints;
+        std::vector<bool> m_EndPassed;
+
+        // Appelé depuis FMOD_System_Update lorsqu'un canal se termine ou passe un point de synchronisation
+        ChannelCallback m_ChannelCallback;
+
+        // DSP unique du spectre, placé à l'entrée du groupe de canaux principal
+        // et contourné tant qu'aucun spectre n'est affiché (voir SpectrumDsp)
+        FMOD_DSP *mp_SpectrumDsp;
+        SpectrumFrames m_SpectrumFrames;
+        bool m_SpectrumEnabled;
+
+        // Protège les tableaux de sons et de canaux (appels depuis le thread audio et le thread graphique)
+        mutable std::recursive_mutex m_Mutex;
+
 
         /* Instance du singleton */
         static FmodManager *mp_Instance;
@@ -62,11 +170,167 @@ class FmodManager
         ~FmodManager();
 
         /**
-         * @brief Attribue un identifiant libre.
-         * @param mainCanal true si la musique est ouverte sur le canal principal
-         * @return Id attribué
+         * @brief Choisit le canal à attribuer au rôle passé en paramètre.
+         *        Si le rôle a atteint sa limite, son canal le plus ancien est réutilisé ;
+         *        si le pool est plein, le canal le moins prioritaire (et le plus ancien) est évincé
+         *        s'il est moins prioritaire que le rôle demandé.
+         * @param role Rôle du canal
+         * @param reservedId Canal à ne pas attribuer (son en cours de déplacement)
+         * @return Identifiant choisi, NO_VOICE_ID si aucun canal n'est disponible
+        */
+        SoundID_t findVoice(VoiceRole role, SoundID_t reservedId = NO_VOICE_ID) const;
+
+        /**
+         * @brief Attribue un canal au rôle passé en paramètre (le son qu'il contenait est libéré, voir findVoice).
+         * @param role Rôle du canal
+         * @param reservedId Canal à ne pas attribuer (son en cours de déplacement)
+         * @return Identifiant attribué, NO_VOICE_ID si aucun canal n'est disponible
         */
-        SoundID_t getSoundID(bool mainCanal) const;
+        SoundID_t allocateVoice(VoiceRole role, SoundID_t reservedId = NO_VOICE_ID);
+
+        /**
+         * @brief Détermine si le canal peut être attribué sans éviction : aucun son, ou son
+         *        d'une preview ou d'un fondu de sortie dont la lecture est terminée (voir m_Busy).
+         * @param id Identifiant du canal
+         * @return true si le canal est libre
+         */
+        bool isVoiceFree(SoundID_t id) const;
+
+        /**
+         * @brief Choisit entre stream et chargement en mémoire pour un fichier local : un petit fichier
+         *        est décodé en mémoire, un fichier ouvert souvent y est gardé compressé, un gros fichier
+         *        est toujours lu en stream. Un son déjà chargé est réutilisé.
+         * @param soundFile Fichier à ouvrir
+         * @param nonBlocking true pour charger le fichier en arrière-plan
+         * @return Son chargé en mémoire, nullptr si le fichier doit être lu en stream
+         */
+        FMOD_SOUND* openResidentSound(const std::string& soundFile, bool nonBlocking);
+
+        /**
+         * @brief Recherche le son parmi les sons chargés en mémoire.
+         * @param sound Son à chercher
+         * @return Son chargé, nullptr si le son est un stream
+         */
+        const ResidentSound* findResidentSound(FMOD_SOUND *sound) const;
+
+        /**
+         * @brief Détermine si le son est ouvert sur un canal.
+         * @param sound Son à tester
+         * @return true si un canal utilise le son
+         */
+        bool isSoundUsed(FMOD_SOUND *sound) const;
+
+        /**
+         * @brief getResidentMemory
+         * @return Mémoire utilisée par les sons chargés (octets).
+         */
+        std::size_t getResidentMemory() const;
+
+        /**
+         * @brief Libère les sons chargés inutilisés, du moins récemment ouvert au plus récent,
+         *        jusqu'à ce que la mémoire demandée tienne dans le budget.
+         * @param memory Mémoire à ajouter aux sons chargés (octets)
+         * @return true si la mémoire demandée tient dans le budget
+         */
+        bool evictResidentSounds(std::size_t memory);
+
+        /**
+         * @brief Mesure la mémoire des sons chargés dont le chargement vient de se terminer, libère
+         *        ceux dont le chargement a échoué puis ramène la mémoire utilisée dans le budget.
+         *        Appelée par update().
+         */
+        void updateResidentSounds();
+
+        /**
+         * @brief Estime la mémoire utilisée par le son du canal (buffers du stream et de décodage).
+         * @param id Identifiant du canal
+         * @return Mémoire utilisée (octets)
+         */
+        std::size_t getVoiceMemory(SoundID_t id) const;
+
+        /**
+         * @brief Estime le coût CPU du canal : échantillons décodés et mixés par seconde.
+         * @param id Identifiant du canal
+         * @return Coût du canal (0 s'il n'est pas en lecture)
+         */
+        unsigned int getVoiceCpuCost(SoundID_t id) const;
+
+        /**
+         * @brief Réserve une place de lecture sans canal (attend qu'une place se libère).
+         * @return Réservation, rendue à sa destruction
+         */
+        std::shared_ptr<void> reserveProbe() const;
+
+        /**
+         * @brief getFileBufferSize
+         * @return Taille du buffer de lecture des streams (octets).
+         */
+        unsigned int getFileBufferSize() const;
+
+        /**
+         * @brief Déplace le son et le canal d'un emplacement à un autre (le son de destination est libéré).
+         * @param from Emplacement d'origine
+         * @param to Emplacement de destination
+         */
+        void moveSound(SoundID_t from, SoundID_t to);
+
+        /**
+         * @brief getSampleRate
+         * @return Fréquence d'échantillonnage du mixeur.
+         */
+        int getSampleRate() const;
+
+        /**
+         * @brief Convertit une durée en nombre d'échantillons de l'horloge du mixeur.
+         * @param ms Durée à convertir (ms)
+         * @return Durée en échantillons
+         */
+        unsigned long long msToDSPClock(SoundPos_t ms) const;
+
+        /**
+         * @brief getParentClock
+         * @param id Identifiant du canal
+         * @return Horloge du mixeur (groupe parent du canal).
+         */
+        unsigned long long getParentClock(SoundID_t id) const;
+
+        /**
+         * @brief Ajoute au canal les points de fondu d'une courbe.
+         * @param id Identifiant du canal
+         * @param start Début du fondu (horloge du mixeur)
+         * @param length Durée du fondu (échantillons)
+         * @param fadeIn true pour une montée du volume, false pour une descente
+         * @param curve Courbe du fondu
+         */
+        void addFadePoints(SoundID_t id, unsigned long long start, unsigned long long length, bool fadeIn, FadeCurve curve) const;
+
+        /**
+         * @brief Détermine si le son est en cours d'ouverture asynchrone.
+         * @param sound Son à tester
+         * @return true si l'ouverture n'est pas terminée
+         */
+        bool isLoading(FMOD_SOUND *sound) const;
+
+        /**
+         * @brief Détermine si FMOD applique un déplacement asynchrone dans le son.
+         * @param sound Son à tester
+         * @return true si le déplacement n'est pas terminé
+         */
+        bool isSeeking(FMOD_SOUND *sound) const;
+
+        /**
+         * @brief Callback FMOD des canaux : retrouve l'identifiant du canal et transmet l'événement.
+         */
+        static FMOD_RESULT F_CALLBACK channelCallback(FMOD_CHANNELCONTROL *channelControl, FMOD_CHANNELCONTROL_TYPE controlType,
+                                                      FMOD_CHANNELCONTROL_CALLBACK_TYPE callbackType, void *commandData1, void *commandData2);
+
+        /**
+         * @brief Callbacks FMOD des fichiers des sons (voir SoundFile).
+         */
+        static FMOD_RESULT F_CALLBACK fileOpenCallback(const char *name, unsigned int *filesize, void **handle, void *userdata);
+        static FMOD_RESULT F_CALLBACK fileCloseCallback(void *handle, void *userdata);
+        static FMOD_RESULT F_CALLBACK fileReadCallback(void *handle, void *buffer, unsigned int sizebytes, unsigned int *bytesread, void *userdata);
+        static FMOD_RESULT F_CALLBACK fileSeekCallback(void *handle, unsigned int pos, void *userdata);
 
         /**
          * @brief Vérifie si le canal associé à l'identifiant id est utilisé ou non.
@@ -77,7 +341,34 @@ class FmodManager
 
     public:
 
-        enum class StreamError { FILE_ERROR, FORMAT_ERROR };
+        // VOICE_ERROR : aucun canal disponible pour le rôle demandé
+        enum class StreamError { FILE_ERROR, FORMAT_ERROR, VOICE_ERROR };
+
+        static constexpr SoundID_t MAIN_VOICE_ID = 0;
+        static constexpr SoundID_t NO_VOICE_ID = 0xFFFFFFFF;
+
+        // Description d'un canal actif du pool
+        struct VoiceInfo
+        {
+            SoundID_t id;               // NO_VOICE_ID pour une lecture de durée
+            VoiceRole role;
+            unsigned int priority;
+            bool loading;
+            bool playing;
+            std::size_t memory;         // Octets (estimation, 0 pour un son chargé en mémoire : voir getResidentSounds)
+            unsigned int cpuCost;       // Echantillons traités par seconde (estimation)
+        };
+
+        // Description d'un son chargé en mémoire
+        struct ResidentInfo
+        {
+            std::string file;
+            std::size_t memory;         // Octets (estimation tant que le chargement n'est pas terminé)
+            bool compressed;
+            bool loading;
+            bool used;                  // Ouvert sur un canal (ne peut pas être évincé)
+            unsigned int opens;         // Ouvertures récentes du fichier (voir openResidentSound)
+        };
 
         /**
          * @brief Créé le singleton s'il n'existe pas
@@ -92,37 +383,213 @@ class FmodManager
         static void deleteInstance();
 
         /**
-         * @brief Met à jour FMOD.
+         * @brief Met à jour FMOD et libère les sons abandonnés dont l'ouverture est terminée.
+         *        Appelée par le thread audio (voir AudioThread).
+         */
+        void update();
+
+        /**
+         * @brief Modifie la fonction appelée à la fin d'un canal (arrêt par FMOD, pas par stopSound)
+         *        ou au passage de son point de synchronisation. Elle est appelée depuis update().
+         * @param callback Fonction à appeler (nullptr pour aucune)
          */
-        void update() const;
+        void setChannelCallback(const ChannelCallback& callback);
 
         /**
-         * @brief Ouvre le fichier son passé en paramètre.
+         * @brief Place le point de synchronisation du son margin ms avant sa fin (remplace le précédent).
+         * @param id Identifiant du son
+         * @param margin Avance sur la fin du son (ms, 0 : aucun point, seule la fin est signalée)
+         */
+        void setEndSyncPoint(SoundID_t id, SoundPos_t margin);
+
+        /**
+         * @brief getMainSoundID
+         * @return Identifiant du canal principal.
+         */
+        SoundID_t getMainSoundID() const;
+
+        /**
+         * @brief Ouvre le fichier son passé en paramètre, en stream ou chargé en mémoire (voir openResidentSound).
          * @param soundFile Fichier à ouvrir
-         * @param mainCanal true si la musique est ouverte sur le canal principal
+         * @param role Rôle du canal attribué au son (VOICE_ERROR si aucun n'est disponible)
          * @param settings Options de chargement de la musique (callbacks utilisés)
+         * @param nonBlocking true pour ouvrir le fichier en arrière-plan (voir isSoundReady)
+         * @param index Index de déplacement du fichier local lu en stream (voir setSoundPosition)
          * @return Identifiant du canal associé
         */
-        SoundID_t openFromFile(const std::string& soundFile, bool mainCanal = true, SoundSettings *settings = nullptr) throw (StreamError);
+        SoundID_t openFromFile(const std::string& soundFile, VoiceRole role = VoiceRole::MAIN, SoundSettings *settings = nullptr,
+                               bool nonBlocking = false, std::shared_ptr<const SeekIndex> index = nullptr) throw (StreamError);
 
         /**
-         * @brief Libère la mémoire du son chargé.
-         * @param id Identifiant du son à libérer
+         * @brief Ouvre le fichier sur le canal attribué par reserveVoice (le son qu'il contenait est libéré).
+         *        Appelée par le thread audio (voir AudioThread).
+         * @param id Identifiant du canal
+         * @param soundFile Fichier à ouvrir
+         * @param settings Options de chargement de la musique (callbacks utilisés)
+         * @param nonBlocking true pour ouvrir le fichier en arrière-plan (voir isSoundReady)
+         * @param index Index de déplacement du fichier local lu en stream (voir setSoundPosition)
         */
-        void releaseSound(SoundID_t id);
+        void openFromFile(SoundID_t id, const std::string& soundFile, SoundSettings *settings = nullptr,
+                          bool nonBlocking = false, std::shared_ptr<const SeekIndex> index = nullptr) throw (StreamError);
+
+        /**
+         * @brief Attribue un canal au rôle passé en paramètre sans toucher au son qu'il contient :
+         *        le son est libéré par l'ouverture (openFromFile) ou le déplacement suivant,
+         *        exécuté plus tard par le thread audio. Le canal n'est pas attribué à nouveau d'ici là.
+         * @param role Rôle du canal (VOICE_ERROR si aucun n'est disponible)
+         * @return Identifiant attribué
+        */
+        SoundID_t reserveVoice(VoiceRole role) throw (StreamError);
+
+        /**
+         * @brief Attribue au son id un canal de fondu de sortie (voir reserveVoice et moveToSecondaryCanal).
+         * @param id Identifiant du son à déplacer
+         * @return Identifiant du canal secondaire (id s'il en est déjà un, NO_VOICE_ID si aucun n'est disponible)
+        */
+        SoundID_t reserveSecondaryVoice(SoundID_t id);
+
+        /**
+         * @brief getVoices
+         * @return Canaux actifs du pool et lectures de durée en cours, avec leur coût estimé.
+         */
+        std::vector<VoiceInfo> getVoices() const;
 
         /**
-         * @brief Ajoute un DSP au son d'identifiant id.
-         * @param id Identifiant du son à traiter
-         * @param size Taille des données de spectre à récupérer
+         * @brief getResidentSounds
+         * @return Sons chargés en mémoire, du plus récemment ouvert au moins récent.
          */
-        void addDSP(SoundID_t id, unsigned int size);
+        std::vector<ResidentInfo> getResidentSounds() const;
+
+        /**
+         * @brief getSampleBudget
+         * @return Mémoire maximale des sons chargés en mémoire (octets).
+         */
+        std::size_t getSampleBudget() const;
+
+        /**
+         * @brief Modifie la mémoire maximale des sons chargés (les sons inutilisés en trop sont libérés).
+         * @param budget Mémoire maximale (octets, 0 : tous les fichiers sont lus en stream)
+         */
+        void setSampleBudget(std::size_t budget);
+
+        /**
+         * @brief Retourne la priorité du rôle passé en paramètre.
+         * @param role Rôle du canal
+         * @return Priorité (la plus haute pour la musique courante)
+         */
+        static unsigned int getPriority(VoiceRole role);
+
+        /**
+         * @brief Retourne le nombre maximal de canaux du rôle passé en paramètre.
+         * @param role Rôle du canal
+         * @return Limite du rôle
+         */
+        static unsigned int getLimit(VoiceRole role);
+
+        /**
+         * @brief Détermine si l'ouverture asynchrone du son est terminée.
+         * @param id Identifiant du son
+         * @return true si le son peut être joué (exception StreamError si l'ouverture a échoué)
+        */
+        bool isSoundReady(SoundID_t id) const throw (StreamError);
+
+        /**
+         * @brief Ouvre le fichier sans l'associer à un canal pour en lire la durée.
+         *        Peut être appelée depuis plusieurs threads simultanément (au plus VOICE_LIMIT_PROBE à la fois).
+         * @param soundFile Fichier à mesurer
+         * @param type Pointeur vers le format du fichier (optionnel)
+         * @return Durée de la musique (ms)
+         */
+        SoundPos_t getFileLength(const std::string& soundFile, FMOD_SOUND_TYPE *type = nullptr) const throw (StreamError);
+
+        /**
+         * @brief Décode le fichier plus vite que le temps réel, sans l'associer à un canal,
+         *        et transmet les échantillons par blocs de LOUDNESS_DECODE_FRAMES.
+         *        Peut être appelée depuis plusieurs threads (partage les places de getFileLength).
+         * @param soundFile Fichier à décoder
+         * @param consumer Fonction recevant chaque bloc (false pour arrêter)
+         * @return true si le fichier a été décodé jusqu'à la fin
+         */
+        bool decodeFile(const std::string& soundFile, const DecodeCallback& consumer) const throw (StreamError);
+
+        /**
+         * @brief Libère la mémoire du son chargé (une fois son ouverture terminée s'il est en cours d'ouverture).
+         * @param id Identifiant du son à libérer
+        */
+        void releaseSound(SoundID_t id);
 
         /**
          * @brief Joue le son chargé.
          * @param id Identifiant du son à jouer
+         * @param paused true pour créer le canal en pause (pré-chargement à la position choisie, voir setSoundPosition)
+        */
+        void playSound(SoundID_t id, bool paused = false);
+
+        /**
+         * @brief Joue le son chargé de façon à ce qu'il démarre exactement
+         *        à la fin du son joué sur le canal previousId (horloge du mixeur).
+         * @param id Identifiant du son à jouer
+         * @param previousId Identifiant du canal en cours de lecture
+         * @param overlap Durée du fondu enchaîné avec le son précédent (ms, 0 : aucun)
+         * @param curve Courbe du fondu enchaîné
+        */
+        void playSoundAfter(SoundID_t id, SoundID_t previousId, SoundPos_t overlap = 0, FadeCurve curve = FadeCurve::EQUAL_POWER);
+
+        /**
+         * @brief Recalcule le démarrage du canal id (et les points de fondu des deux canaux)
+         *        à partir de la position courante du canal previousId.
+         * @param id Identifiant du canal en attente
+         * @param previousId Identifiant du canal en cours de lecture
+         * @param overlap Durée du fondu enchaîné avec le son précédent (ms, 0 : aucun)
+         * @param curve Courbe du fondu enchaîné
+        */
+        void scheduleSound(SoundID_t id, SoundID_t previousId, SoundPos_t overlap = 0, FadeCurve curve = FadeCurve::EQUAL_POWER) const;
+
+        /**
+         * @brief Monte le volume du canal id de 0 à 1 à partir de maintenant.
+         * @param id Identifiant du canal
+         * @param length Durée du fondu (ms)
+         * @param curve Courbe du fondu
         */
-        void playSound(SoundID_t id);
+        void fadeInSound(SoundID_t id, SoundPos_t length, FadeCurve curve) const;
+
+        /**
+         * @brief Déplace le canal id sur un canal secondaire, baisse son volume jusqu'à 0
+         *        puis l'arrête à la fin du fondu.
+         * @param id Identifiant du canal
+         * @param secondaryId Canal secondaire attribué par reserveSecondaryVoice
+         * @param length Durée du fondu (ms)
+         * @param curve Courbe du fondu
+        */
+        void fadeOutSound(SoundID_t id, SoundID_t secondaryId, SoundPos_t length, FadeCurve curve);
+
+        /**
+         * @brief Déplace le son et le canal id sur le canal principal (le son principal est libéré).
+         * @param id Identifiant du son à déplacer
+         * @return Identifiant du canal principal
+        */
+        SoundID_t moveToMainCanal(SoundID_t id);
+
+        /**
+         * @brief Déplace le son et le canal id sur un canal de fondu de sortie (son libéré s'il n'y en a pas).
+         * @param id Identifiant du son à déplacer
+         * @param secondaryId Canal secondaire attribué par reserveSecondaryVoice
+        */
+        void moveToSecondaryCanal(SoundID_t id, SoundID_t secondaryId);
+
+        /**
+         * @brief Supprime les points de fondu du canal (volume rétabli).
+         * @param id Identifiant du canal
+         */
+        void removeFadePoints(SoundID_t id) const;
+
+        /**
+         * @brief Détermine si le stream du son id est suffisamment chargé.
+         * @param id Identifiant du son
+         * @param minPercent Remplissage minimal du buffer du stream (%)
+         * @return true si le stream ne manque pas de données
+        */
+        bool isBuffered(SoundID_t id, unsigned int minPercent) const;
 
         /**
          * @brief Arrête le son joué sur le canal id.
@@ -152,7 +619,9 @@ class FmodManager
         SoundPos_t getSoundPosition(SoundID_t id) const;
 
         /**
-         * @brief Change la position de la musique.
+         * @brief Change la position de la musique. Si le fichier a un index de déplacement, la position est
+         *        ramenée au début de la trame indexée qui la précède, lue à sa position exacte dans le fichier ;
+         *        pour un fichier distant, la position est transmise à l'autre client avec le déplacement.
          * @param id Identifiant du canal à modifier
          * @param pos Position à appliquer
         */
@@ -166,13 +635,21 @@ class FmodManager
         bool isPlaying(SoundID_t id) const;
 
         /**
-         * @brief Récupère le spectre du son joué dans le canal.
-         * @param id Identifiant du canal à tester
-         * @param values Vecteur dans lequel sont stockées
-         *               les valeurs
-         * @return Vecteur dans lequel sont stockées les valeurs
+         * @brief Récupère le spectre du son entendu : le dernier publié par le DSP du groupe de canaux
+         *        dont l'horloge a été atteinte par la sortie (horloge du mixeur moins la latence de sortie).
+         *        Les spectres plus anciens sont écartés, les suivants restent en attente
+         *        (un seul thread consommateur, sans verrou ni allocation).
+         * @param frame Spectre récupéré
+         * @return false si aucun nouveau spectre n'est entendu
         */
-        std::vector<float>& getChannelSpectrum(SoundID_t id, std::vector<float>& values) const;
+        bool getSpectrumFrame(SpectrumFrame& frame);
+
+        /**
+         * @brief Active le DSP du spectre (créé au premier appel) ou le contourne : aucun calcul
+         *        n'est fait tant que le spectre n'est pas affiché.
+         * @param enabled true pour calculer le spectre
+         */
+        void setSpectrumEnabled(bool enabled);
 
         /**
          * @brief Récupère le volume du canal.
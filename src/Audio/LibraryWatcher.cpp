@@ -0,0 +1,193 @@
+/*************************************
+ * @file    LibraryWatcher.cpp
+ * @date    17/10/26
+ * @author  Manuel
+ *
+ * Définitions de la classe LibraryWatcher.
+ *************************************
+*/
+
+#include "LibraryWatcher.h"
+#include "../Constants.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QDateTime>
+
+
+namespace audio {
+
+
+LibraryWatcher::LibraryWatcher(QObject *parent)
+    : QObject(parent)
+{
+    m_Timer.setSingleShot(true);
+    m_Timer.setInterval(LIBRARY_WATCH_DELAY);
+
+    connect(&m_Watcher, &QFileSystemWatcher::directoryChanged, this, &LibraryWatcher::onDirectoryChanged);
+    connect(&m_Timer, &QTimer::timeout, this, &LibraryWatcher::processPendingDirectories);
+}
+
+// ==============================
+// ==============================
+
+void LibraryWatcher::watch(const QString& rootPath, const QVector<SongScanner::Entry>& entries)
+{
+    m_Timer.stop();
+    m_PendingDirectories.clear();
+    m_Directories.clear();
+
+    if (!m_Watcher.directories().isEmpty())
+        m_Watcher.removePaths(m_Watcher.directories());
+
+    m_RootPath = QDir::cleanPath(rootPath);
+    m_Directories.insert(m_RootPath, QHash<QString, FileState>());
+
+    for (const SongScanner::Entry& entry : entries)
+    {
+        QFileInfo fileInfo(entry.filePath);
+        m_Directories[fileInfo.path()].insert(fileInfo.fileName(), { entry.canonicalPath, entry.size, entry.mtime, entry.isDir });
+
+        if (entry.isDir && !m_Directories.contains(entry.filePath))
+            m_Directories.insert(entry.filePath, QHash<QString, FileState>());
+    }
+
+    m_Watcher.addPaths(m_Directories.keys());
+}
+
+// ==============================
+// ==============================
+
+const QString& LibraryWatcher::getRootPath() const
+{
+    return m_RootPath;
+}
+
+// ==============================
+// ==============================
+
+void LibraryWatcher::onDirectoryChanged(const QString& dirPath)
+{
+    // Une copie ou un déplacement génère plusieurs notifications
+    m_PendingDirectories.insert(dirPath);
+    m_Timer.start();
+}
+
+// ==============================
+// ==============================
+
+void LibraryWatcher::processPendingDirectories()
+{
+    QSet<QString> directories;
+    directories.swap(m_PendingDirectories);
+
+    for (const QString& dirPath : directories)
+    {
+        // Répertoire déjà retiré lors du traitement de son parent
+        if (m_Directories.contains(dirPath))
+            scanDirectory(dirPath);
+    }
+}
+
+// ==============================
+// ==============================
+
+void LibraryWatcher::scanDirectory(const QString& dirPath)
+{
+    QDir dir(dirPath);
+    if (!dir.exists())
+        return;
+
+    const QHash<QString, FileState> knownFiles = m_Directories.value(dirPath);
+    QHash<QString, FileState> currentFiles;
+    bool retry = false;
+
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    QFileInfoList files = dir.entryInfoList(QDir::AllEntries | QDir::NoDotAndDotDot);
+
+    for (const QFileInfo& fileInfo : files)
+    {
+        FileState state { fileInfo.canonicalFilePath(), fileInfo.size(), fileInfo.lastModified().toMSecsSinceEpoch(), fileInfo.isDir() };
+        auto known = knownFiles.constFind(fileInfo.fileName());
+
+        bool added = (known == knownFiles.constEnd() || known->isDir != state.isDir);
+        bool modified = (!added && !state.isDir && (known->size != state.size || known->mtime != state.mtime));
+
+        // Fichier en cours d'écriture : il sera relu au prochain passage
+        if ((added || modified) && !state.isDir && now - state.mtime < LIBRARY_WATCH_DELAY)
+        {
+            if (!added)
+                currentFiles.insert(fileInfo.fileName(), known.value());
+
+            retry = true;
+            continue;
+        }
+
+        currentFiles.insert(fileInfo.fileName(), state);
+
+        if (added && known != knownFiles.constEnd())
+        {
+            if (known->isDir)
+                removeDirectory(fileInfo.filePath());
+            else
+                emit fileRemoved(known->canonicalPath);
+        }
+
+        if (added && state.isDir)
+            addDirectory(fileInfo.filePath());
+        else if (added)
+            emit fileAdded(fileInfo.filePath());
+        else if (modified)
+            emit fileModified(fileInfo.filePath());
+    }
+
+    for (auto it = knownFiles.constBegin(); it != knownFiles.constEnd(); ++it)
+    {
+        if (currentFiles.contains(it.key()))
+            continue;
+
+        if (it->isDir)
+            removeDirectory(dir.filePath(it.key()));
+        else
+            emit fileRemoved(it->canonicalPath);
+    }
+
+    m_Directories.insert(dirPath, currentFiles);
+
+    if (retry)
+    {
+        m_PendingDirectories.insert(dirPath);
+        m_Timer.start();
+    }
+}
+
+// ==============================
+// ==============================
+
+void LibraryWatcher::addDirectory(const QString& dirPath)
+{
+    m_Directories.insert(dirPath, QHash<QString, FileState>());
+    m_Watcher.addPath(dirPath);
+
+    scanDirectory(dirPath);
+}
+
+// ==============================
+// ==============================
+
+void LibraryWatcher::removeDirectory(const QString& dirPath)
+{
+    const QHash<QString, FileState> files = m_Directories.take(dirPath);
+    m_Watcher.removePath(dirPath);
+
+    for (auto it = files.constBegin(); it != files.constEnd(); ++it)
+    {
+        if (it->isDir)
+            removeDirectory(dirPath + '/' + it.key());
+        else
+            emit fileRemoved(it->canonicalPath);
+    }
+}
+
+
+} // audio
@@ -0,0 +1,126 @@
+/*************************************
+ * @file    LibraryWatcher.h
+ * @date    17/10/26
+ * @author  Manuel
+ *
+ * Déclarations de la classe LibraryWatcher
+ * surveillant le répertoire des musiques
+ * et signalant les fichiers modifiés.
+ *************************************
+*/
+
+#ifndef __LIBRARYWATCHER_H__
+#define __LIBRARYWATCHER_H__
+
+#include <QObject>
+#include <QFileSystemWatcher>
+#include <QTimer>
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include "SongScanner.h"
+
+
+namespace audio {
+
+
+class LibraryWatcher : public QObject
+{
+    Q_OBJECT
+
+    private:
+
+        struct FileState
+        {
+            QString canonicalPath;
+            qint64 size;
+            qint64 mtime;
+            bool isDir;
+        };
+
+        QString m_RootPath;
+
+        QFileSystemWatcher m_Watcher;
+
+        QTimer m_Timer;
+
+        // Contenu connu de chaque répertoire surveillé (nom de fichier -> état)
+        QHash<QString, QHash<QString, FileState>> m_Directories;
+
+        QSet<QString> m_PendingDirectories;
+
+
+        /**
+         * @brief Compare le contenu du répertoire avec son dernier état connu et signale les différences.
+         * @param dirPath Répertoire à comparer
+         */
+        void scanDirectory(const QString& dirPath);
+
+        /**
+         * @brief Surveille le nouveau répertoire et signale l'ensemble de ses fichiers.
+         * @param dirPath Répertoire ajouté
+         */
+        void addDirectory(const QString& dirPath);
+
+        /**
+         * @brief Arrête la surveillance du répertoire et signale la suppression de ses fichiers.
+         * @param dirPath Répertoire supprimé
+         */
+        void removeDirectory(const QString& dirPath);
+
+    private slots:
+
+        /**
+         * @brief Met de côté le répertoire modifié jusqu'à la fin du délai de regroupement.
+         * @param dirPath Répertoire modifié
+         */
+        void onDirectoryChanged(const QString& dirPath);
+
+        /**
+         * @brief Traite les répertoires modifiés depuis le dernier passage.
+         */
+        void processPendingDirectories();
+
+    signals:
+
+        /**
+         * @brief Signal émis lorsqu'un fichier apparaît dans le répertoire.
+         * @param filePath Chemin du fichier (préfixé par le répertoire surveillé)
+         */
+        void fileAdded(const QString& filePath);
+
+        /**
+         * @brief Signal émis lorsqu'un fichier est supprimé du répertoire.
+         * @param canonicalPath Chemin canonique du fichier supprimé
+         */
+        void fileRemoved(const QString& canonicalPath);
+
+        /**
+         * @brief Signal émis lorsqu'un fichier du répertoire change de taille ou de date.
+         * @param filePath Chemin du fichier (préfixé par le répertoire surveillé)
+         */
+        void fileModified(const QString& filePath);
+
+    public:
+
+        LibraryWatcher(QObject *parent = nullptr);
+        virtual ~LibraryWatcher() = default;
+
+        /**
+         * @brief Surveille le répertoire à partir du contenu lu par le SongScanner.
+         * @param rootPath Répertoire à surveiller
+         * @param entries Eléments du répertoire (parcours complet)
+         */
+        void watch(const QString& rootPath, const QVector<SongScanner::Entry>& entries);
+
+        /**
+         * @brief getRootPath
+         * @return Répertoire surveillé.
+         */
+        const QString& getRootPath() const;
+};
+
+
+} // audio
+
+#endif  // __LIBRARYWATCHER_H__
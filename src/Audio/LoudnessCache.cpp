@@ -0,0 +1,143 @@
+/*************************************
+ * @file    LoudnessCache.cpp
+ * @date    17/10/26
+ * @author  Manuel
+ *
+ * Définitions de la classe LoudnessCache.
+ *************************************
+*/
+
+#include "LoudnessCache.h"
+#include <QDataStream>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+
+
+namespace audio {
+
+
+namespace {
+
+constexpr quint32 CACHE_MAGIC = 0x504C4348;     // "PLCH"
+constexpr quint32 CACHE_VERSION = 1;
+
+}
+
+// ==============================
+// ==============================
+
+LoudnessCache::LoudnessCache(const QString& filePath)
+    : m_FilePath(filePath), m_Dirty(false)
+{
+
+}
+
+// ==============================
+// ==============================
+
+bool LoudnessCache::load()
+{
+    m_Entries.clear();
+    m_Dirty = false;
+
+    QFile file(m_FilePath);
+    if (!file.open(QIODevice::ReadOnly))
+        return !file.exists();
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+
+    quint32 magic, version, count;
+    stream >> magic >> version >> count;
+
+    if (stream.status() != QDataStream::Ok || magic != CACHE_MAGIC || version != CACHE_VERSION)
+        return false;
+
+    for (quint32 i = 0; i < count; ++i)
+    {
+        QString path;
+        Entry entry;
+
+        stream >> path >> entry.size >> entry.mtime >> entry.info.loudness >> entry.info.truePeak;
+
+        if (stream.status() != QDataStream::Ok)
+        {
+            m_Entries.clear();
+            return false;
+        }
+
+        m_Entries.insert(path, entry);
+    }
+
+    return true;
+}
+
+// ==============================
+// ==============================
+
+bool LoudnessCache::save()
+{
+    for (auto it = m_Entries.begin(); it != m_Entries.end();)
+    {
+        if (!QFileInfo::exists(it.key()))
+            it = m_Entries.erase(it);
+        else
+            ++it;
+    }
+
+    QSaveFile file(m_FilePath);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+
+    stream << CACHE_MAGIC << CACHE_VERSION << static_cast<quint32>(m_Entries.size());
+
+    for (auto it = m_Entries.constBegin(); it != m_Entries.constEnd(); ++it)
+        stream << it.key() << it->size << it->mtime << it->info.loudness << it->info.truePeak;
+
+    if (!file.commit())
+        return false;
+
+    m_Dirty = false;
+
+    return true;
+}
+
+// ==============================
+// ==============================
+
+bool LoudnessCache::find(const QString& path, qint64 size, qint64 mtime, LoudnessInfo& info) const
+{
+    auto entry = m_Entries.constFind(path);
+
+    if (entry == m_Entries.constEnd() || entry->size != size || entry->mtime != mtime)
+        return false;
+
+    info = entry->info;
+    return true;
+}
+
+// ==============================
+// ==============================
+
+void LoudnessCache::insert(const QString& path, qint64 size, qint64 mtime, const LoudnessInfo& info)
+{
+    m_Entries.insert(path, { size, mtime, info });
+    m_Dirty = true;
+}
+
+// ==============================
+// ==============================
+
+bool LoudnessCache::isDirty() const
+{
+    return m_Dirty;
+}
+
+
+} // audio
@@ -0,0 +1,98 @@
+/*************************************
+ * @file    LoudnessCache.h
+ * @date    17/10/26
+ * @author  Manuel
+ *
+ * Déclarations de la classe LoudnessCache
+ * conservant sur disque la loudness
+ * mesurée de chaque fichier.
+ *************************************
+*/
+
+#ifndef __LOUDNESSCACHE_H__
+#define __LOUDNESSCACHE_H__
+
+#include <QHash>
+#include <QString>
+#include "../Constants.h"
+
+
+namespace audio {
+
+
+// Résultat de l'analyse d'un fichier (voir LoudnessMeter)
+struct LoudnessInfo
+{
+    float loudness;     // Loudness intégrée (LUFS)
+    float truePeak;     // True peak (dBTP)
+};
+
+
+/**
+ * Format du fichier (QDataStream) : magic, version, nombre d'entrées puis, pour chaque
+ * entrée, chemin, taille, date de modification, loudness et true peak.
+ * Les entrées tiennent en mémoire : le fichier est lu entièrement au chargement.
+ */
+class LoudnessCache
+{
+    private:
+
+        struct Entry
+        {
+            qint64 size;
+            qint64 mtime;
+            LoudnessInfo info;
+        };
+
+        QString m_FilePath;
+
+        QHash<QString, Entry> m_Entries;
+
+        bool m_Dirty;
+
+    public:
+
+        LoudnessCache(const QString& filePath = LOUDNESS_CACHE_FILEPATH);
+
+        /**
+         * @brief Lit le fichier du cache.
+         * @return true si le cache est utilisable (fichier absent compris)
+         */
+        bool load();
+
+        /**
+         * @brief Ecrit le cache sur disque. Les entrées dont le fichier n'existe plus sont supprimées.
+         * @return true si l'écriture a réussi
+         */
+        bool save();
+
+        /**
+         * @brief Cherche la loudness du fichier dans le cache.
+         * @param path Chemin canonique du fichier
+         * @param size Taille actuelle du fichier
+         * @param mtime Date de modification actuelle du fichier (ms)
+         * @param info Loudness trouvée
+         * @return true si une entrée à jour (taille et date identiques) existe
+         */
+        bool find(const QString& path, qint64 size, qint64 mtime, LoudnessInfo& info) const;
+
+        /**
+         * @brief Ajoute ou remplace la loudness du fichier dans le cache.
+         * @param path Chemin canonique du fichier
+         * @param size Taille du fichier
+         * @param mtime Date de modification du fichier (ms)
+         * @param info Loudness mesurée
+         */
+        void insert(const QString& path, qint64 size, qint64 mtime, const LoudnessInfo& info);
+
+        /**
+         * @brief isDirty
+         * @return true si des entrées n'ont pas encore été écrites.
+         */
+        bool isDirty() const;
+};
+
+
+} // audio
+
+#endif  // __LOUDNESSCACHE_H__
@@ -0,0 +1,416 @@
+/*************************************
+ * @file    LoudnessMeter.cpp
+ * @date    17/10/26
+ * @author  Manuel
+ *
+ * Définitions de la classe LoudnessMeter.
+ *************************************
+*/
+
+#include "LoudnessMeter.h"
+#include "SpectrumKernels.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    #define LOUDNESS_METER_X86
+    #include <emmintrin.h>
+#endif
+
+#if defined(__GNUC__)
+    #define TARGET_SSE2 __attribute__((target("sse2")))
+#else
+    #define TARGET_SSE2
+#endif
+
+
+namespace audio {
+
+
+namespace {
+
+constexpr double PI = 3.14159265358979323846;
+
+// Décalage de la mesure (-0.691 dB) et seuils (BS.1770-4)
+constexpr double LOUDNESS_OFFSET = -0.691;
+constexpr double ABSOLUTE_GATE = -70.0;
+constexpr double RELATIVE_GATE = -10.0;
+
+// Poids des canaux d'ambiance d'un son 5.1 et au-delà (le LFE n'est pas mesuré)
+constexpr unsigned int LFE_CHANNEL = 3;
+constexpr double SURROUND_WEIGHT = 1.41;
+
+inline double toPower(double loudness)
+{
+    return std::pow(10.0, (loudness - LOUDNESS_OFFSET) / 10.0);
+}
+
+}
+
+constexpr unsigned int LoudnessMeter::TRUE_PEAK_TAPS;
+
+// ==============================
+// ==============================
+
+LoudnessMeter::LoudnessMeter(unsigned int channels, int sampleRate)
+    : m_Channels(std::max(channels, 1u)), m_SubBlockFrames(0), m_SubBlocks(), m_SubBlocksNb(0), m_Peak(0.0f),
+      m_Simd(SpectrumKernels::isSupported(SpectrumKernels::Variant::SSE2))
+{
+    const double rate = std::max(sampleRate, 8000);
+
+    /* Pondération K : coefficients de BS.1770 recalculés pour la fréquence du son */
+    {
+        const double k = std::tan(PI * 1681.974450955533 / rate);
+        const double q = 0.7071752369554196;
+        const double vh = std::pow(10.0, 3.999843853973347 / 20.0);
+        const double vb = std::pow(vh, 0.4996667741545416);
+        const double a0 = 1.0 + k / q + k * k;
+
+        m_Shelf = { (vh + vb * k / q + k * k) / a0, 2.0 * (k * k - vh) / a0, (vh - vb * k / q + k * k) / a0,
+                    2.0 * (k * k - 1.0) / a0, (1.0 - k / q + k * k) / a0 };
+    }
+    {
+        const double k = std::tan(PI * 38.13547087602444 / rate);
+        const double q = 0.5003270373238773;
+        const double a0 = 1.0 + k / q + k * k;
+
+        m_HighPass = { 1.0, -2.0, 1.0, 2.0 * (k * k - 1.0) / a0, (1.0 - k / q + k * k) / a0 };
+    }
+
+    const unsigned int pairedChannels = (m_Channels + 1) / 2 * 2;
+
+    m_ShelfStates.assign(pairedChannels * 2, 0.0);
+    m_HighPassStates.assign(pairedChannels * 2, 0.0);
+    m_Energies.assign(pairedChannels, 0.0);
+    m_Weights.assign(m_Channels, 1.0);
+
+    if (m_Channels > LFE_CHANNEL + 2)
+    {
+        m_Weights[LFE_CHANNEL] = 0.0;
+
+        for (unsigned int c = LFE_CHANNEL + 1; c < m_Channels; c++)
+            m_Weights[c] = SURROUND_WEIGHT;
+    }
+
+    m_SubBlockSize = std::max(1u, static_cast<unsigned int>(std::lround(rate / 10.0)));
+
+    /* Suréchantillonnage x4 : sinus cardinal fenêtré (Hann), chaque phase de gain unitaire */
+    const unsigned int length = TRUE_PEAK_TAPS * 4;
+    const double center = (length - 1) / 2.0;
+
+    for (unsigned int phase = 0; phase < 4; phase++)
+    {
+        double sum = 0.0;
+        std::array<double, TRUE_PEAK_TAPS> coefficients;
+
+        for (unsigned int k = 0; k < TRUE_PEAK_TAPS; k++)
+        {
+            const double n = 4 * k + phase;
+            const double x = (n - center) / 4.0;
+            const double sinc = std::sin(PI * x) / (PI * x);
+            const double window = 0.5 - 0.5 * std::cos(2.0 * PI * (n + 0.5) / length);
+
+            coefficients[k] = sinc * window;
+            sum += coefficients[k];
+        }
+
+        for (unsigned int k = 0; k < TRUE_PEAK_TAPS; k++)
+            m_Taps[4 * k + phase] = static_cast<float>(coefficients[k] / sum);
+    }
+
+    m_History.assign(m_Channels * TRUE_PEAK_TAPS * 2, 0.0f);
+    m_HistoryPos.assign(m_Channels, 0);
+}
+
+// ==============================
+// ==============================
+
+void LoudnessMeter::process(const float *samples, unsigned int frames)
+{
+    while (frames > 0)
+    {
+        const unsigned int count = std::min(frames, m_SubBlockSize - m_SubBlockFrames);
+
+        filter(samples, count);
+
+        m_SubBlockFrames += count;
+        samples += static_cast<std::size_t>(count) * m_Channels;
+        frames -= count;
+
+        if (m_SubBlockFrames == m_SubBlockSize)
+            finishSubBlock();
+    }
+}
+
+// ==============================
+// ==============================
+
+void LoudnessMeter::filter(const float *samples, unsigned int frames)
+{
+    for (unsigned int c = 0; c < m_Channels; c += 2)
+    {
+        if (c + 1 < m_Channels)
+            filterPair(samples, frames, c);
+        else
+            filterScalar(samples, frames, c);
+    }
+
+    for (unsigned int c = 0; c < m_Channels; c++)
+    {
+        if (m_Simd)
+            peakSimd(samples, frames, c);
+        else
+            peakScalar(samples, frames, c);
+    }
+}
+
+// ==============================
+// ==============================
+
+void LoudnessMeter::filterScalar(const float *samples, unsigned int frames, unsigned int channel)
+{
+    // Etats d'une paire de canaux : z1 des deux canaux puis z2 des deux canaux
+    const unsigned int z1 = channel / 2 * 4 + channel % 2;
+    const unsigned int z2 = z1 + 2;
+
+    double shelf1 = m_ShelfStates[z1], shelf2 = m_ShelfStates[z2];
+    double highPass1 = m_HighPassStates[z1], highPass2 = m_HighPassStates[z2];
+    double energy = 0.0;
+
+    for (unsigned int f = 0; f < frames; f++)
+    {
+        const double x = samples[static_cast<std::size_t>(f) * m_Channels + channel];
+
+        const double y = m_Shelf.b0 * x + shelf1;
+        shelf1 = m_Shelf.b1 * x - m_Shelf.a1 * y + shelf2;
+        shelf2 = m_Shelf.b2 * x - m_Shelf.a2 * y;
+
+        const double z = m_HighPass.b0 * y + highPass1;
+        highPass1 = m_HighPass.b1 * y - m_HighPass.a1 * z + highPass2;
+        highPass2 = m_HighPass.b2 * y - m_HighPass.a2 * z;
+
+        energy += z * z;
+    }
+
+    m_ShelfStates[z1] = shelf1;
+    m_ShelfStates[z2] = shelf2;
+    m_HighPassStates[z1] = highPass1;
+    m_HighPassStates[z2] = highPass2;
+    m_Energies[channel] += energy;
+}
+
+// ==============================
+// ==============================
+
+TARGET_SSE2 void LoudnessMeter::filterPair(const float *samples, unsigned int frames, unsigned int channel)
+{
+#if defined(LOUDNESS_METER_X86)
+    if (!m_Simd)
+    {
+        filterScalar(samples, frames, channel);
+        filterScalar(samples, frames, channel + 1);
+        return;
+    }
+
+    // Les deux canaux de la paire sont filtrés ensemble (un canal par moitié de registre)
+    double *shelfStates = &m_ShelfStates[channel * 2];
+    double *highPassStates = &m_HighPassStates[channel * 2];
+
+    const __m128d sb0 = _mm_set1_pd(m_Shelf.b0), sb1 = _mm_set1_pd(m_Shelf.b1), sb2 = _mm_set1_pd(m_Shelf.b2);
+    const __m128d sa1 = _mm_set1_pd(m_Shelf.a1), sa2 = _mm_set1_pd(m_Shelf.a2);
+    const __m128d hb0 = _mm_set1_pd(m_HighPass.b0), hb1 = _mm_set1_pd(m_HighPass.b1), hb2 = _mm_set1_pd(m_HighPass.b2);
+    const __m128d ha1 = _mm_set1_pd(m_HighPass.a1), ha2 = _mm_set1_pd(m_HighPass.a2);
+
+    __m128d shelf1 = _mm_loadu_pd(shelfStates), shelf2 = _mm_loadu_pd(shelfStates + 2);
+    __m128d highPass1 = _mm_loadu_pd(highPassStates), highPass2 = _mm_loadu_pd(highPassStates + 2);
+    __m128d energy = _mm_setzero_pd();
+
+    for (unsigned int f = 0; f < frames; f++)
+    {
+        const float *frame = samples + static_cast<std::size_t>(f) * m_Channels + channel;
+        const __m128d x = _mm_set_pd(frame[1], frame[0]);
+
+        const __m128d y = _mm_add_pd(_mm_mul_pd(sb0, x), shelf1);
+        shelf1 = _mm_add_pd(_mm_sub_pd(_mm_mul_pd(sb1, x), _mm_mul_pd(sa1, y)), shelf2);
+        shelf2 = _mm_sub_pd(_mm_mul_pd(sb2, x), _mm_mul_pd(sa2, y));
+
+        const __m128d z = _mm_add_pd(_mm_mul_pd(hb0, y), highPass1);
+        highPass1 = _mm_add_pd(_mm_sub_pd(_mm_mul_pd(hb1, y), _mm_mul_pd(ha1, z)), highPass2);
+        highPass2 = _mm_sub_pd(_mm_mul_pd(hb2, y), _mm_mul_pd(ha2, z));
+
+        energy = _mm_add_pd(energy, _mm_mul_pd(z, z));
+    }
+
+    _mm_storeu_pd(shelfStates, shelf1);
+    _mm_storeu_pd(shelfStates + 2, shelf2);
+    _mm_storeu_pd(highPassStates, highPass1);
+    _mm_storeu_pd(highPassStates + 2, highPass2);
+
+    double energies[2];
+    _mm_storeu_pd(energies, energy);
+
+    m_Energies[channel] += energies[0];
+    m_Energies[channel + 1] += energies[1];
+#else
+    filterScalar(samples, frames, channel);
+    filterScalar(samples, frames, channel + 1);
+#endif
+}
+
+// ==============================
+// ==============================
+
+void LoudnessMeter::peakScalar(const float *samples, unsigned int frames, unsigned int channel)
+{
+    float *history = &m_History[channel * TRUE_PEAK_TAPS * 2];
+    unsigned int pos = m_HistoryPos[channel];
+    float peak = m_Peak;
+
+    for (unsigned int f = 0; f < frames; f++)
+    {
+        const float x = samples[static_cast<std::size_t>(f) * m_Channels + channel];
+
+        pos = (pos == 0) ? TRUE_PEAK_TAPS - 1 : pos - 1;
+        history[pos] = history[pos + TRUE_PEAK_TAPS] = x;
+
+        peak = std::max(peak, std::fabs(x));
+
+        for (unsigned int phase = 0; phase < 4; phase++)
+        {
+            float sum = 0.0f;
+
+            for (unsigned int k = 0; k < TRUE_PEAK_TAPS; k++)
+                sum += m_Taps[4 * k + phase] * history[pos + k];
+
+            peak = std::max(peak, std::fabs(sum));
+        }
+    }
+
+    m_HistoryPos[channel] = pos;
+    m_Peak = peak;
+}
+
+// ==============================
+// ==============================
+
+TARGET_SSE2 void LoudnessMeter::peakSimd(const float *samples, unsigned int frames, unsigned int channel)
+{
+#if defined(LOUDNESS_METER_X86)
+    float *history = &m_History[channel * TRUE_PEAK_TAPS * 2];
+    unsigned int pos = m_HistoryPos[channel];
+
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    __m128 peak = _mm_set1_ps(m_Peak);
+
+    for (unsigned int f = 0; f < frames; f++)
+    {
+        const float x = samples[static_cast<std::size_t>(f) * m_Channels + channel];
+
+        pos = (pos == 0) ? TRUE_PEAK_TAPS - 1 : pos - 1;
+        history[pos] = history[pos + TRUE_PEAK_TAPS] = x;
+
+        // Les 4 phases du suréchantillonnage sont calculées ensemble
+        const float *window = history + pos;
+        __m128 sum = _mm_mul_ps(_mm_loadu_ps(&m_Taps[0]), _mm_set1_ps(window[0]));
+
+        for (unsigned int k = 1; k < TRUE_PEAK_TAPS; k++)
+            sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(&m_Taps[4 * k]), _mm_set1_ps(window[k])));
+
+        peak = _mm_max_ps(peak, _mm_and_ps(sum, absMask));
+        peak = _mm_max_ps(peak, _mm_and_ps(_mm_set1_ps(x), absMask));
+    }
+
+    float peaks[4];
+    _mm_storeu_ps(peaks, peak);
+
+    m_HistoryPos[channel] = pos;
+    m_Peak = std::max(std::max(peaks[0], peaks[1]), std::max(peaks[2], peaks[3]));
+#else
+    peakScalar(samples, frames, channel);
+#endif
+}
+
+// ==============================
+// ==============================
+
+void LoudnessMeter::finishSubBlock()
+{
+    double energy = 0.0;
+
+    for (unsigned int c = 0; c < m_Channels; c++)
+    {
+        energy += m_Weights[c] * m_Energies[c];
+        m_Energies[c] = 0.0;
+    }
+
+    m_SubBlocks[m_SubBlocksNb % m_SubBlocks.size()] = energy;
+    m_SubBlocksNb++;
+    m_SubBlockFrames = 0;
+
+    if (m_SubBlocksNb >= m_SubBlocks.size())
+    {
+        double sum = 0.0;
+
+        for (double subBlock : m_SubBlocks)
+            sum += subBlock;
+
+        m_Blocks.push_back(sum / (static_cast<double>(m_SubBlockSize) * m_SubBlocks.size()));
+    }
+}
+
+// ==============================
+// ==============================
+
+double LoudnessMeter::getIntegratedLoudness() const
+{
+    const double absoluteGate = toPower(ABSOLUTE_GATE);
+
+    double sum = 0.0;
+    unsigned int count = 0;
+
+    for (double block : m_Blocks)
+    {
+        if (block > absoluteGate)
+        {
+            sum += block;
+            count++;
+        }
+    }
+
+    if (count == 0)
+        return -std::numeric_limits<double>::infinity();
+
+    const double gate = std::max(absoluteGate, sum / count * std::pow(10.0, RELATIVE_GATE / 10.0));
+
+    sum = 0.0;
+    count = 0;
+
+    for (double block : m_Blocks)
+    {
+        if (block > gate)
+        {
+            sum += block;
+            count++;
+        }
+    }
+
+    if (count == 0)
+        return -std::numeric_limits<double>::infinity();
+
+    return LOUDNESS_OFFSET + 10.0 * std::log10(sum / count);
+}
+
+// ==============================
+// ==============================
+
+double LoudnessMeter::getTruePeak() const
+{
+    if (m_Peak <= 0.0f)
+        return -std::numeric_limits<double>::infinity();
+
+    return 20.0 * std::log10(m_Peak);
+}
+
+
+} // audio
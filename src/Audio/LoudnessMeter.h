@@ -0,0 +1,130 @@
+/*************************************
+ * @file    LoudnessMeter.h
+ * @date    17/10/26
+ * @author  Manuel
+ *
+ * Déclarations de la classe LoudnessMeter
+ * mesurant la loudness intégrée et le
+ * true peak d'un son (EBU R128).
+ *************************************
+*/
+
+#ifndef __LOUDNESSMETER_H__
+#define __LOUDNESSMETER_H__
+
+#include <array>
+#include <vector>
+
+
+namespace audio {
+
+
+/**
+ * Mesure ITU-R BS.1770 / EBU R128 d'un son complet :
+ *  - pondération K (filtre en plateau puis passe-haut) de chaque canal, énergie par blocs
+ *    de 400 ms espacés de 100 ms, seuils absolu (-70 LUFS) et relatif (-10 LU) ;
+ *  - true peak par suréchantillonnage x4 (filtre polyphase de TRUE_PEAK_TAPS coefficients).
+ * Les filtres de pondération traitent les canaux par paires et le filtre polyphase calcule
+ * ses 4 phases ensemble, en SSE2 lorsque le processeur le permet.
+ */
+class LoudnessMeter
+{
+    public:
+
+        // Coefficients par phase du filtre de suréchantillonnage
+        static constexpr unsigned int TRUE_PEAK_TAPS = 12;
+
+    private:
+
+        // Biquad en forme directe transposée (a0 = 1)
+        struct Biquad
+        {
+            double b0, b1, b2, a1, a2;
+        };
+
+        unsigned int m_Channels;
+
+        Biquad m_Shelf;
+        Biquad m_HighPass;
+
+        // Etats des deux filtres de chaque canal (nombre pair de canaux, le dernier éventuellement inutilisé)
+        std::vector<double> m_ShelfStates;
+        std::vector<double> m_HighPassStates;
+
+        std::vector<double> m_Weights;
+
+        // Energie de chaque canal dans le bloc de 100 ms en cours
+        std::vector<double> m_Energies;
+        unsigned int m_SubBlockSize;
+        unsigned int m_SubBlockFrames;
+
+        // Energies pondérées des 4 derniers blocs de 100 ms
+        std::array<double, 4> m_SubBlocks;
+        unsigned int m_SubBlocksNb;
+
+        // Puissance moyenne de chaque bloc de 400 ms
+        std::vector<double> m_Blocks;
+
+        // Coefficients du filtre polyphase, regroupés par 4 phases
+        std::array<float, TRUE_PEAK_TAPS * 4> m_Taps;
+
+        // Derniers échantillons de chaque canal, écrits deux fois pour être lus d'un seul tenant
+        std::vector<float> m_History;
+        std::vector<unsigned int> m_HistoryPos;
+
+        float m_Peak;
+
+        bool m_Simd;
+
+
+        /**
+         * @brief Filtre un bloc d'échantillons et cumule l'énergie et le crête de chaque canal.
+         * @param samples Echantillons entrelacés
+         * @param frames Nombre d'échantillons par canal (dans le bloc de 100 ms en cours)
+         */
+        void filter(const float *samples, unsigned int frames);
+
+        void filterScalar(const float *samples, unsigned int frames, unsigned int channel);
+        void filterPair(const float *samples, unsigned int frames, unsigned int channel);
+
+        void peakScalar(const float *samples, unsigned int frames, unsigned int channel);
+        void peakSimd(const float *samples, unsigned int frames, unsigned int channel);
+
+        /**
+         * @brief Termine le bloc de 100 ms en cours et ajoute le bloc de 400 ms qu'il complète.
+         */
+        void finishSubBlock();
+
+    public:
+
+        /**
+         * @brief Crée un mesureur pour un son.
+         * @param channels Nombre de canaux (5.1 : L R C LFE Ls Rs)
+         * @param sampleRate Fréquence d'échantillonnage (Hz)
+         */
+        LoudnessMeter(unsigned int channels, int sampleRate);
+
+        /**
+         * @brief Ajoute des échantillons à la mesure.
+         * @param samples Echantillons entrelacés
+         * @param frames Nombre d'échantillons par canal
+         */
+        void process(const float *samples, unsigned int frames);
+
+        /**
+         * @brief getIntegratedLoudness
+         * @return Loudness intégrée des échantillons ajoutés (LUFS, -infini si aucun bloc ne passe les seuils).
+         */
+        double getIntegratedLoudness() const;
+
+        /**
+         * @brief getTruePeak
+         * @return True peak des échantillons ajoutés (dBTP, -infini si silence).
+         */
+        double getTruePeak() const;
+};
+
+
+} // audio
+
+#endif  // __LOUDNESSMETER_H__
@@ -0,0 +1,330 @@
+/*************************************
+ * @file    MetadataCache.cpp
+ * @date    17/10/26
+ * @author  Manuel
+ *
+ * Définitions de la classe MetadataCache.
+ *************************************
+*/
+
+#include "MetadataCache.h"
+#include <QFileInfo>
+#include <QSaveFile>
+#include <algorithm>
+#include <cstring>
+
+
+namespace audio {
+
+
+namespace {
+
+constexpr char CACHE_MAGIC[4] = { 'P', 'M', 'C', 'H' };
+constexpr quint32 CACHE_VERSION = 1;
+
+}
+
+// ==============================
+// ==============================
+
+MetadataCache::MetadataCache(const QString& filePath)
+    : m_FilePath(filePath), mp_Data(nullptr), mp_Records(nullptr), mp_Strings(nullptr), m_Count(0)
+{
+    static_assert(sizeof(Header) == 16, "Unexpected cache header size");
+    static_assert(sizeof(Record) == 64, "Unexpected cache record size");
+}
+
+// ==============================
+// ==============================
+
+MetadataCache::~MetadataCache()
+{
+    unmap();
+}
+
+// ==============================
+// ==============================
+
+quint64 MetadataCache::hashPath(const QByteArray& path)
+{
+    quint64 hash = 14695981039346656037ULL;
+
+    for (char c : path)
+    {
+        hash ^= static_cast<uchar>(c);
+        hash *= 1099511628211ULL;
+    }
+
+    return hash;
+}
+
+// ==============================
+// ==============================
+
+void MetadataCache::unmap()
+{
+    if (mp_Data)
+        m_File.unmap(const_cast<uchar*>(mp_Data));
+
+    if (m_File.isOpen())
+        m_File.close();
+
+    mp_Data = nullptr;
+    mp_Records = nullptr;
+    mp_Strings = nullptr;
+    m_Count = 0;
+    m_UsedRecords.clear();
+}
+
+// ==============================
+// ==============================
+
+bool MetadataCache::load()
+{
+    unmap();
+
+    m_File.setFileName(m_FilePath);
+    if (!m_File.open(QIODevice::ReadOnly))
+        return !m_File.exists();
+
+    qint64 fileSize = m_File.size();
+    if (fileSize < static_cast<qint64>(sizeof(Header)))
+    {
+        m_File.close();
+        return false;
+    }
+
+    mp_Data = m_File.map(0, fileSize);
+    if (!mp_Data)
+    {
+        m_File.close();
+        return false;
+    }
+
+    const Header *header = reinterpret_cast<const Header*>(mp_Data);
+    qint64 stringsOffset = sizeof(Header) + static_cast<qint64>(header->count) * sizeof(Record);
+
+    if (std::memcmp(header->magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 || header->version != CACHE_VERSION
+            || stringsOffset > fileSize)
+    {
+        unmap();
+        return false;
+    }
+
+    const Record *records = reinterpret_cast<const Record*>(mp_Data + sizeof(Header));
+    const quint64 stringsSize = static_cast<quint64>(fileSize - stringsOffset);
+
+    // Fichier tronqué ou corrompu : aucune chaîne ne doit être lue hors du fichier mappé
+    for (quint32 i = 0; i < header->count; ++i)
+    {
+        const Record& record = records[i];
+
+        if (static_cast<quint64>(record.pathOffset) + record.pathSize > stringsSize
+                || static_cast<quint64>(record.titleOffset) + record.titleSize > stringsSize
+                || static_cast<quint64>(record.artistOffset) + record.artistSize > stringsSize)
+        {
+            unmap();
+            return false;
+        }
+    }
+
+    m_Count = header->count;
+    mp_Records = records;
+    mp_Strings = reinterpret_cast<const char*>(mp_Data + stringsOffset);
+    m_UsedRecords.assign(m_Count, false);
+
+    return true;
+}
+
+// ==============================
+// ==============================
+
+int MetadataCache::findRecord(const QByteArray& path) const
+{
+    quint64 hash = hashPath(path);
+
+    const Record *end = mp_Records + m_Count;
+    const Record *record = std::lower_bound(mp_Records, end, hash, [](const Record& r, quint64 h) { return r.pathHash < h; });
+
+    for (; record != end && record->pathHash == hash; ++record)
+    {
+        if (record->pathSize == static_cast<quint32>(path.size())
+                && std::memcmp(mp_Strings + record->pathOffset, path.constData(), path.size()) == 0)
+            return record - mp_Records;
+    }
+
+    return -1;
+}
+
+// ==============================
+// ==============================
+
+bool MetadataCache::find(const QString& path, qint64 size, qint64 mtime, SongMetadata& metadata)
+{
+    auto pending = m_PendingEntries.constFind(path);
+    if (pending != m_PendingEntries.constEnd())
+    {
+        if (pending->size != size || pending->mtime != mtime)
+            return false;
+
+        metadata = pending->metadata;
+        return true;
+    }
+
+    if (!mp_Records)
+        return false;
+
+    int index = findRecord(path.toUtf8());
+    if (index < 0)
+        return false;
+
+    const Record& record = mp_Records[index];
+    if (record.size != size || record.mtime != mtime)
+        return false;
+
+    metadata.title = QString::fromUtf8(mp_Strings + record.titleOffset, record.titleSize);
+    metadata.artist = QString::fromUtf8(mp_Strings + record.artistOffset, record.artistSize);
+    metadata.length = record.length;
+    metadata.format = static_cast<FMOD_SOUND_TYPE>(record.format);
+    metadata.valid = (record.flags & VALID);
+    metadata.error = (record.flags & FORMAT_ERROR) ? FmodManager::StreamError::FORMAT_ERROR : FmodManager::StreamError::FILE_ERROR;
+
+    m_UsedRecords[index] = true;
+
+    return true;
+}
+
+// ==============================
+// ==============================
+
+void MetadataCache::insert(const QString& path, qint64 size, qint64 mtime, const SongMetadata& metadata)
+{
+    // Un fichier d'un format non supporté le restera tant qu'il n'est pas modifié
+    if (metadata.valid || metadata.error == FmodManager::StreamError::FORMAT_ERROR)
+        m_PendingEntries.insert(path, { size, mtime, metadata });
+}
+
+// ==============================
+// ==============================
+
+bool MetadataCache::isDirty() const
+{
+    return !m_PendingEntries.isEmpty();
+}
+
+// ==============================
+// ==============================
+
+bool MetadataCache::save()
+{
+    struct Entry
+    {
+        Record record;
+        QByteArray path;
+        QByteArray title;
+        QByteArray artist;
+    };
+
+    std::vector<Entry> entries;
+    entries.reserve(m_Count + m_PendingEntries.size());
+
+    /* Entrées conservées du fichier actuel */
+    for (quint32 i = 0; i < m_Count; ++i)
+    {
+        const Record& record = mp_Records[i];
+        QByteArray path(mp_Strings + record.pathOffset, record.pathSize);
+
+        if (m_PendingEntries.contains(QString::fromUtf8(path)))
+            continue;
+
+        if (!m_UsedRecords[i] && !QFileInfo::exists(QString::fromUtf8(path)))
+            continue;
+
+        entries.push_back({ record, path, QByteArray(mp_Strings + record.titleOffset, record.titleSize),
+                            QByteArray(mp_Strings + record.artistOffset, record.artistSize) });
+    }
+
+    /* Nouvelles entrées */
+    for (auto it = m_PendingEntries.constBegin(); it != m_PendingEntries.constEnd(); ++it)
+    {
+        Entry entry;
+        entry.path = it.key().toUtf8();
+        entry.title = it->metadata.title.toUtf8();
+        entry.artist = it->metadata.artist.toUtf8();
+
+        entry.record.pathHash = hashPath(entry.path);
+        entry.record.size = it->size;
+        entry.record.mtime = it->mtime;
+        entry.record.length = it->metadata.length;
+        entry.record.format = static_cast<quint32>(it->metadata.format);
+        entry.record.flags = 0;
+        entry.record.padding = 0;
+
+        if (it->metadata.valid)
+            entry.record.flags |= VALID;
+        else if (it->metadata.error == FmodManager::StreamError::FORMAT_ERROR)
+            entry.record.flags |= FORMAT_ERROR;
+
+        entries.push_back(entry);
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const Entry& e1, const Entry& e2) {
+        return e1.record.pathHash < e2.record.pathHash;
+    });
+
+    /* Construction du fichier */
+    QByteArray strings;
+    for (Entry& entry : entries)
+    {
+        entry.record.pathOffset = strings.size();
+        entry.record.pathSize = entry.path.size();
+        strings.append(entry.path);
+
+        entry.record.titleOffset = strings.size();
+        entry.record.titleSize = entry.title.size();
+        strings.append(entry.title);
+
+        entry.record.artistOffset = strings.size();
+        entry.record.artistSize = entry.artist.size();
+        strings.append(entry.artist);
+    }
+
+    Header header;
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.version = CACHE_VERSION;
+    header.count = entries.size();
+    header.reserved = 0;
+
+    QByteArray data;
+    data.reserve(sizeof(Header) + entries.size() * sizeof(Record) + strings.size());
+    data.append(reinterpret_cast<const char*>(&header), sizeof(Header));
+
+    for (const Entry& entry : entries)
+        data.append(reinterpret_cast<const char*>(&entry.record), sizeof(Record));
+
+    data.append(strings);
+
+    /* Le fichier doit être libéré avant d'être remplacé */
+    unmap();
+
+    QSaveFile cacheFile(m_FilePath);
+    if (!cacheFile.open(QIODevice::WriteOnly))
+    {
+        load();
+        return false;
+    }
+
+    cacheFile.write(data);
+    if (!cacheFile.commit())
+    {
+        load();
+        return false;
+    }
+
+    m_PendingEntries.clear();
+
+    return load();
+}
+
+
+} // audio
@@ -0,0 +1,154 @@
+/*************************************
+ * @file    MetadataCache.h
+ * @date    17/10/26
+ * @author  Manuel
+ *
+ * Déclarations de la classe MetadataCache
+ * conservant sur disque les informations
+ * lues dans les fichiers de musique.
+ *************************************
+*/
+
+#ifndef __METADATACACHE_H__
+#define __METADATACACHE_H__
+
+#include <QFile>
+#include <QHash>
+#include <QString>
+#include <QByteArray>
+#include <vector>
+#include "SongMetadata.h"
+#include "../Constants.h"
+
+
+namespace audio {
+
+
+/**
+ * Format du fichier (little endian, mappé en mémoire tel quel) :
+ *  - Header
+ *  - Record[count], triés par hash du chemin
+ *  - Chaînes UTF-8 (chemins, titres, artistes) référencées par les Record
+ */
+class MetadataCache
+{
+    private:
+
+        struct Header
+        {
+            char magic[4];
+            quint32 version;
+            quint32 count;
+            quint32 reserved;
+        };
+
+        struct Record
+        {
+            quint64 pathHash;
+            qint64 size;
+            qint64 mtime;
+            quint32 length;
+            quint32 format;
+            quint32 pathOffset;
+            quint32 pathSize;
+            quint32 titleOffset;
+            quint32 titleSize;
+            quint32 artistOffset;
+            quint32 artistSize;
+            quint32 flags;
+            quint32 padding;
+        };
+
+        enum RecordFlag : quint32 { VALID = 1, FORMAT_ERROR = 2 };
+
+        struct PendingEntry
+        {
+            qint64 size;
+            qint64 mtime;
+            SongMetadata metadata;
+        };
+
+        QString m_FilePath;
+
+        QFile m_File;
+
+        const uchar *mp_Data;
+
+        const Record *mp_Records;
+
+        const char *mp_Strings;
+
+        quint32 m_Count;
+
+        std::vector<bool> m_UsedRecords;
+
+        QHash<QString, PendingEntry> m_PendingEntries;
+
+
+        /**
+         * @brief Cherche l'enregistrement du chemin dans le fichier mappé.
+         * @param path Chemin encodé en UTF-8
+         * @return Indice de l'enregistrement, -1 si absent
+         */
+        int findRecord(const QByteArray& path) const;
+
+        /**
+         * @brief Libère le fichier mappé.
+         */
+        void unmap();
+
+    public:
+
+        /**
+         * @brief Calcule le hash (FNV-1a 64 bits) stable du chemin passé en paramètre.
+         * @param path Chemin encodé en UTF-8
+         * @return Hash du chemin
+         */
+        static quint64 hashPath(const QByteArray& path);
+
+        MetadataCache(const QString& filePath = METADATA_CACHE_FILEPATH);
+        virtual ~MetadataCache();
+
+        /**
+         * @brief Mappe le fichier du cache en mémoire (aucune lecture des entrées).
+         * @return true si le cache est utilisable (fichier absent compris)
+         */
+        bool load();
+
+        /**
+         * @brief Ecrit le cache sur disque. Les entrées non utilisées durant la session
+         *        et dont le fichier n'existe plus sont supprimées.
+         * @return true si l'écriture a réussi
+         */
+        bool save();
+
+        /**
+         * @brief Cherche les informations du fichier dans le cache.
+         * @param path Chemin canonique du fichier
+         * @param size Taille actuelle du fichier
+         * @param mtime Date de modification actuelle du fichier (ms)
+         * @param metadata Informations trouvées (éventuellement invalides si le fichier n'est pas lisible)
+         * @return true si une entrée à jour (taille et date identiques) existe
+         */
+        bool find(const QString& path, qint64 size, qint64 mtime, SongMetadata& metadata);
+
+        /**
+         * @brief Ajoute ou remplace les informations du fichier dans le cache.
+         * @param path Chemin canonique du fichier
+         * @param size Taille du fichier
+         * @param mtime Date de modification du fichier (ms)
+         * @param metadata Informations à conserver (les formats non supportés sont aussi conservés)
+         */
+        void insert(const QString& path, qint64 size, qint64 mtime, const SongMetadata& metadata);
+
+        /**
+         * @brief isDirty
+         * @return true si des entrées n'ont pas encore été écrites.
+         */
+        bool isDirty() const;
+};
+
+
+} // audio
+
+#endif  // __METADATACACHE_H__
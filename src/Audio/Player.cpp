@@ -17,7 +17,9 @@
 
 #include <QDir>
 #include <QFileInfo>
+#include <QDateTime>
 #include <QDebug>
+#include <algorithm>
 #include "../Gui/SongListIterator.h"
 
 
@@ -25,12 +27,52 @@ namespace audio {
 
 
 Player::Player()
-    : m_Cpt(0), mp_Songs({SongList_t::DIRECTORY_SONGS, SongList_t::IMPORTED_SONGS, SongList_t::REMOTE_SONGS}),
-      m_CurrentSong(UNDEFINED_SONG), m_Playlist(true), m_Loop(false),
+    : m_Cpt(0), m_Playlist(true), m_Loop(false), m_Gapless(true),
+      m_CrossfadeTime(CROSSFADE_DEFAULT_TIME), m_CrossfadeCurve(FadeCurve::EQUAL_POWER), m_SkipUnbufferedCrossfade(true),
+      m_NextSongOverlap(0), m_NextSongLoading(false), m_Loading(false), m_LoadingSkip(false), m_LoadingForward(true),
       m_Pause(false), m_Stop(true), m_Mute(false),
-      m_VolumeState(NB_VOLUME_STATES - 1), mp_PreviewId(nullptr)
+      m_VolumeState(NB_VOLUME_STATES - 1), mp_PreviewId(nullptr),
+      m_PreviewOffset(0), m_PreviewScanned(false), m_PreviewCued(false), m_PreviewStarted(false), mp_FadingSong(nullptr),
+      m_PictureSerial(0)
 {
-
+    if (!m_MetadataCache.load())
+        qWarning() << "Invalid metadata cache" << METADATA_CACHE_FILEPATH;
+
+    if (!m_LoudnessCache.load())
+        qWarning() << "Invalid loudness cache" << LOUDNESS_CACHE_FILEPATH;
+
+    if (!m_WaveformCache.load())
+        qWarning() << "Invalid waveform cache" << WAVEFORM_CACHE_FILEPATH;
+
+    if (!m_SeekIndexCache.load())
+        qWarning() << "Invalid seek index cache" << SEEK_INDEX_CACHE_FILEPATH;
+
+    connect(&m_LibraryWatcher, &LibraryWatcher::fileAdded, this, &Player::addWatchedSong);
+    connect(&m_LibraryWatcher, &LibraryWatcher::fileRemoved, this, &Player::removeWatchedSong);
+    connect(&m_LibraryWatcher, &LibraryWatcher::fileModified, this, &Player::updateWatchedSong);
+
+    // Le singleton est créé avant le démarrage du thread audio
+    FmodManager::getInstance();
+
+    connect(&m_AudioThread, &AudioThread::songEnding, this, &Player::checkSongEnd, Qt::QueuedConnection);
+    connect(&m_AudioThread, &AudioThread::soundEnded, this, &Player::checkSoundEnd, Qt::QueuedConnection);
+    connect(&m_AudioThread, &AudioThread::positionChanged, this, &Player::scheduleNextSong, Qt::QueuedConnection);
+    connect(&m_AudioThread, &AudioThread::positionChanged, this, &Player::checkSongEnd, Qt::QueuedConnection);
+    connect(&m_AudioThread, &AudioThread::pictureRead, this, &Player::storePicture, Qt::QueuedConnection);
+    connect(&m_AudioThread, &AudioThread::residentSoundsRead, this, &Player::residentSoundsRead, Qt::QueuedConnection);
+    connect(&m_AudioThread, &AudioThread::voicesRead, this, &Player::voicesRead, Qt::QueuedConnection);
+    connect(this, &Player::stateChanged, [this](PlayerState state) {
+        m_AudioThread.setActive(state == PlayerState::PLAY || isPreviewing());
+    });
+    m_AudioThread.start(QThread::TimeCriticalPriority);
+
+    connect(&m_SongAnalyzer, &SongAnalyzer::loudnessAnalyzed, this, &Player::storeLoudness, Qt::QueuedConnection);
+    connect(&m_SongAnalyzer, &SongAnalyzer::waveformAnalyzed, this, &Player::storeWaveform, Qt::QueuedConnection);
+    connect(&m_SongAnalyzer, &SongAnalyzer::seekIndexAnalyzed, this, &Player::storeSeekIndex, Qt::QueuedConnection);
+    m_SongAnalyzer.start(QThread::LowestPriority);
+
+    connect(&m_PreviewScanner, &PreviewScanner::offsetFound, this, &Player::storePreviewOffset, Qt::QueuedConnection);
+    m_PreviewScanner.start(QThread::LowPriority);
 }
 
 // ==============================
@@ -38,8 +80,19 @@ Player::Player()
 
 Player::~Player()
 {
+    if (m_MetadataCache.isDirty())
+        m_MetadataCache.save();
+
+    m_SongAnalyzer.stop();
+    m_PreviewScanner.stop();
+
+    if (m_LoudnessCache.isDirty() && !m_LoudnessCache.save())
+        qWarning() << "Cannot save loudness cache" << LOUDNESS_CACHE_FILEPATH;
+
+    m_AudioThread.stop();
+
+    m_Songs.setCursor(UNDEFINED_SONG);
     clearSongs();
-    mp_Songs.clear();
 }
 
 // ==============================
@@ -57,10 +110,7 @@ Player::SongId Player::getNewSongId()
 
 std::shared_ptr<Song> Player::getCurrentSong()
 {
-    if (m_CurrentSong == UNDEFINED_SONG)
-        return nullptr;
-    else
-        return *m_CurrentSong;
+    return m_Songs.get(m_Songs.getCursor());
 }
 
 // ==============================
@@ -68,13 +118,57 @@ std::shared_ptr<Song> Player::getCurrentSong()
 
 Player::SongIt Player::findSong(SongId songId) const
 {
-    for (auto it = mp_Songs.begin(); it != mp_Songs.end(); ++it)
+    return m_Songs.find(songId);
+}
+
+// ==============================
+// ==============================
+
+Player::SongIt Player::insertSong(SongList_t list, SongIt pos, const std::shared_ptr<Song>& song)
+{
+    pos = m_Songs.insert(list, pos, song);
+
+    if (list == SongList_t::REMOTE_SONGS)
     {
-        if ((*it)->getId() == songId)
-            return it;
+        auto remoteSong = std::static_pointer_cast<network::RemoteSong>(song);
+        m_RemoteSongs.insert(remoteSong->getRemoteId(), remoteSong);
     }
+    else
+        m_LocalSongs.insert(song->getFile(), song);
 
-    return UNDEFINED_SONG;
+    if (list == SongList_t::DIRECTORY_SONGS)
+        m_DirectoryOrder.insert(SongScanner::walkOrderKey(song->getFile()), pos);
+
+    return pos;
+}
+
+// ==============================
+// ==============================
+
+void Player::unindexSong(const std::shared_ptr<Song>& song)
+{
+    if (song->isRemote())
+        m_RemoteSongs.remove(std::static_pointer_cast<network::RemoteSong>(song)->getRemoteId());
+    else
+        m_LocalSongs.remove(song->getFile());
+
+    if (song->isInFolder())
+        m_DirectoryOrder.remove(SongScanner::walkOrderKey(song->getFile()));
+}
+
+// ==============================
+// ==============================
+
+void Player::eraseSong(SongIt song)
+{
+    if (song == UNDEFINED_SONG)
+        return;
+
+    if (song == m_NextSong)
+        cancelNextSong();
+
+    unindexSong(m_Songs.get(song));
+    m_Songs.erase(song);
 }
 
 // ==============================
@@ -82,7 +176,7 @@ Player::SongIt Player::findSong(SongId songId) const
 
 int Player::songsCount(SongList_t list) const
 {
-    return mp_Songs.getSubSets(list).elementsCount();
+    return m_Songs.count(list);
 }
 
 // ==============================
@@ -95,14 +189,18 @@ void Player::play()
         if (m_Stop)
         {
             m_Stop = false;
-            getCurrentSong()->play();
+
+            if (!m_Loading)
+                getCurrentSong()->play(m_AudioThread);
 
             emit stateChanged(PlayerState::PLAY);
         }
         else if (m_Pause)
         {
             m_Pause = false;
-            getCurrentSong()->pause(false);
+
+            // La musique suivante est recalée une fois la reprise appliquée (positionChanged)
+            getCurrentSong()->pause(m_AudioThread, false);
 
             emit stateChanged(PlayerState::PLAY);
         }
@@ -119,8 +217,11 @@ void Player::stop()
         m_Pause = false;
         m_Stop = true;
 
+        cancelNextSong();
+        stopFadingSong();
+
         if (getCurrentSong())
-            getCurrentSong()->stop();
+            getCurrentSong()->stop(m_AudioThread);
 
         emit stateChanged(PlayerState::STOP);
     }
@@ -136,7 +237,12 @@ void Player::pause()
         m_Pause = true;
 
         if (getCurrentSong())
-            getCurrentSong()->pause(true);
+            getCurrentSong()->pause(m_AudioThread, true);
+
+        if (m_Songs.isValid(m_NextSong))
+            m_Songs.get(m_NextSong)->pause(m_AudioThread, true);
+
+        stopFadingSong();
 
         emit stateChanged(PlayerState::PAUSE);
     }
@@ -148,7 +254,7 @@ void Player::pause()
 void Player::mute(bool mute)
 {
     m_Mute = mute;
-    FmodManager::getInstance().setMute(mute);
+    m_AudioThread.setMute(mute);
 }
 
 // ==============================
@@ -156,7 +262,7 @@ void Player::mute(bool mute)
 
 bool Player::isPlaying() const
 {
-    return (!m_Pause && !m_Stop && m_CurrentSong != UNDEFINED_SONG);
+    return (!m_Pause && !m_Stop && m_Songs.getCursor() != UNDEFINED_SONG);
 }
 
 // ==============================
@@ -178,6 +284,14 @@ bool Player::isPaused() const
 // ==============================
 // ==============================
 
+bool Player::isLoading() const
+{
+    return m_Loading;
+}
+
+// ==============================
+// ==============================
+
 bool Player::isMuted() const
 {
     return m_Mute;
@@ -202,36 +316,167 @@ void Player::setLoop(bool loop)
 // ==============================
 // ==============================
 
-Player::SongIt Player::first(SongList_t list) const
+bool Player::isGapless() const
 {
-    auto songs = mp_Songs.getSubSets(list);
+    return m_Gapless;
+}
 
-    if (!songs.empty())
-        return findSong((*songs.begin())->getId());
-    else
-        return UNDEFINED_SONG;
+// ==============================
+// ==============================
+
+void Player::setGapless(bool gapless)
+{
+    m_Gapless = gapless;
+    cancelNextSong();
+}
+
+// ==============================
+// ==============================
+
+SoundPos_t Player::getCrossfadeTime() const
+{
+    return m_CrossfadeTime;
+}
+
+// ==============================
+// ==============================
+
+void Player::setCrossfadeTime(SoundPos_t length)
+{
+    m_CrossfadeTime = length;
+    cancelNextSong();
+}
+
+// ==============================
+// ==============================
+
+FadeCurve Player::getCrossfadeCurve() const
+{
+    return m_CrossfadeCurve;
+}
+
+// ==============================
+// ==============================
+
+void Player::setCrossfadeCurve(FadeCurve curve)
+{
+    m_CrossfadeCurve = curve;
+    cancelNextSong();
+}
+
+// ==============================
+// ==============================
+
+bool Player::isSkippingUnbufferedCrossfade() const
+{
+    return m_SkipUnbufferedCrossfade;
+}
+
+// ==============================
+// ==============================
+
+void Player::setSkipUnbufferedCrossfade(bool skip)
+{
+    m_SkipUnbufferedCrossfade = skip;
+}
+
+// ==============================
+// ==============================
+
+void Player::setPosition(SoundPos_t pos)
+{
+    if (getCurrentSong())
+        getCurrentSong()->setPosition(m_AudioThread, pos);
+}
+
+// ==============================
+// ==============================
+
+void Player::stopAudioThread()
+{
+    m_AudioThread.stop();
+}
+
+// ==============================
+// ==============================
+
+SoundPos_t Player::getPosition() const
+{
+    return getCurrentSong() ? getCurrentSong()->getPosition(m_AudioThread) : 0;
+}
+
+// ==============================
+// ==============================
+
+bool Player::getSpectrum(SpectrumFrame& frame)
+{
+    return m_AudioThread.getSpectrum(frame);
+}
+
+// ==============================
+// ==============================
+
+void Player::setSpectrumEnabled(bool enabled)
+{
+    m_AudioThread.setSpectrumEnabled(enabled);
+}
+
+// ==============================
+// ==============================
+
+void Player::setSampleBudget(unsigned int megabytes)
+{
+    m_AudioThread.setSampleBudget(static_cast<std::size_t>(megabytes) * 1024 * 1024);
+}
+
+// ==============================
+// ==============================
+
+const QPixmap& Player::getPicture() const
+{
+    return m_Picture;
+}
+
+// ==============================
+// ==============================
+
+void Player::requestAudioStatus()
+{
+    m_AudioThread.requestStatus();
+}
+
+// ==============================
+// ==============================
+
+Player::SongIt Player::first(SongList_t list) const
+{
+    return m_Songs.first(list);
 }
 
 // ==============================
 // ==============================
 
-Player::SongIt Player::prev() const
+Player::SongIt Player::prev(SongIt song) const
 {
-    SongIt prev = (m_Loop && m_CurrentSong == FIRST_SONG) ? mp_Songs.end() : m_CurrentSong;
+    if (song == UNDEFINED_SONG)
+        return m_Songs.last();
+
+    SongIt prev = m_Songs.prev(song);
+
+    if (m_Loop && prev == UNDEFINED_SONG)
+        prev = m_Songs.last();
 
-    --prev;
     return prev;
 }
 
 // ==============================
 // ==============================
 
-Player::SongIt Player::next() const
+Player::SongIt Player::next(SongIt song) const
 {
-    SongIt next = m_CurrentSong;
-    ++next;
+    SongIt next = m_Songs.next(song);
 
-    if (m_Loop && next == mp_Songs.end())
+    if (m_Loop && next == UNDEFINED_SONG)
         next = FIRST_SONG;
 
     return next;
@@ -240,55 +485,65 @@ Player::SongIt Player::next() const
 // ==============================
 // ==============================
 
-Player::SongIt Player::findPrevSong(bool available)
+Player::SongIt Player::seekSong(SongIt from, bool forward, bool available) const
 {
-    SongIt initialSong = m_CurrentSong;
-    SongIt prevSong = UNDEFINED_SONG;
+    SongIt song = forward ? next(from) : prev(from);
 
-    do
+    // Au plus un tour complet (la musique de départ peut ne plus faire partie des listes)
+    for (unsigned int i = m_Songs.count(); song != UNDEFINED_SONG && available && !m_Songs.isAvailable(song); --i)
     {
-        prevSong = prev();
-
-        if (prevSong != UNDEFINED_SONG && prevSong != m_CurrentSong)
-            changeSong(prevSong);
-    }
-    while (prevSong != UNDEFINED_SONG && (isLoop() || m_CurrentSong != FIRST_SONG)
-           && (available && !getCurrentSong()->isAvailable()) && (!isLoop() || m_CurrentSong != initialSong));
+        if (song == from || i == 0)
+            return UNDEFINED_SONG;
 
-    if ((prevSong == UNDEFINED_SONG || (available && !getCurrentSong()->isAvailable()))
-            && m_CurrentSong != initialSong)
-    {
-        changeSong(initialSong);
+        song = forward ? next(song) : prev(song);
     }
 
-    return prevSong;
+    return song;
 }
 
 // ==============================
 // ==============================
 
-Player::SongIt Player::findNextSong(bool available)
+Player::SongIt Player::moveCursor(bool forward, bool available)
 {
-    SongIt initialSong = m_CurrentSong;
-    SongIt nextSong = UNDEFINED_SONG;
+    SongIt initialSong = m_Songs.getCursor();
+    SongIt song = seekSong(initialSong, forward, available);
 
-    do
+    while (song != UNDEFINED_SONG)
     {
-        nextSong = next();
+        changeSong(song);
+
+        // Echec d'une ouverture asynchrone : la recherche reprend dans finishLoading
+        m_LoadingSkip = available;
+        m_LoadingForward = forward;
 
-        if (nextSong != UNDEFINED_SONG && nextSong != m_CurrentSong)
-            changeSong(nextSong);
+        if (!available || m_Songs.isAvailable(song) || song == initialSong)
+            return song;
+
+        // L'ouverture a échoué : la musique est maintenant indisponible, on cherche au-delà
+        song = seekSong(song, forward, available);
     }
-    while (nextSong != UNDEFINED_SONG && (available && !getCurrentSong()->isAvailable())
-           && (!isLoop() || m_CurrentSong != initialSong));
 
-    if ((nextSong == UNDEFINED_SONG || (available && !getCurrentSong()->isAvailable()))
-            && m_CurrentSong != initialSong)
-    {
+    if (m_Songs.getCursor() != initialSong && m_Songs.isValid(initialSong))
         changeSong(initialSong);
-    }
 
-    return nextSong;
+    return UNDEFINED_SONG;
+}
+
+// ==============================
+// ==============================
+
+Player::SongIt Player::findPrevSong(bool available)
+{
+    return moveCursor(false, available);
+}
+
+// ==============================
+// ==============================
+
+Player::SongIt Player::findNextSong(bool available)
+{
+    return moveCursor(true, available);
 }
 
 // ==============================
@@ -307,7 +562,7 @@ void Player::setVolume(int volumeState)
     m_VolumeState = volumeState;
 
     float volume = static_cast<float>(volumeState) / (NB_VOLUME_STATES - 1);
-    FmodManager::getInstance().setVolume(volume);
+    m_AudioThread.setVolume(volume);
 }
 
 // ==============================
@@ -315,7 +570,13 @@ void Player::setVolume(int volumeState)
 
 void Player::clearSongs(SongList_t list)
 {
-    mp_Songs.clear(list);
+    if (m_Songs.isValid(m_NextSong) && (m_Songs.getList(m_NextSong) & list))
+        cancelNextSong();
+
+    for (SongIt song = m_Songs.first(list); song != UNDEFINED_SONG; song = m_Songs.next(song, list))
+        unindexSong(m_Songs.get(song));
+
+    m_Songs.clear(list);
 }
 
 // ==============================
@@ -323,15 +584,7 @@ void Player::clearSongs(SongList_t list)
 
 std::shared_ptr<Song> Player::getLocalSong(const QString& filePath) const
 {
-    auto localSongs = mp_Songs.getSubSets(SongList_t::LOCAL_SONGS);
-
-    for (auto song : localSongs)
-    {
-        if (song->getFile() == filePath)
-            return song;
-    }
-
-    return nullptr;
+    return m_LocalSongs.value(filePath, nullptr);
 }
 
 // ==============================
@@ -339,22 +592,14 @@ std::shared_ptr<Song> Player::getLocalSong(const QString& filePath) const
 
 std::shared_ptr<network::RemoteSong> Player::getRemoteSong(const SongId id) const
 {
-    auto remoteSongs = mp_Songs.getSubSets(SongList_t::REMOTE_SONGS);
-
-    for (auto song : remoteSongs)
-    {
-        auto remoteSong = std::static_pointer_cast<network::RemoteSong>(song);
-        if (remoteSong->getRemoteId() == id)
-            return remoteSong;
-    }
-
-    return nullptr;
+    return m_RemoteSongs.value(id, nullptr);
 }
 
 // ==============================
 // ==============================
 
-std::shared_ptr<Song> Player::createLocalSong(SongList::mapped_type::const_iterator& pos, const QString& filePath, bool inFolder)
+std::shared_ptr<Song> Player::createLocalSong(SongIt& pos, const QString& filePath, bool inFolder,
+                                              const SongMetadata *metadata)
 {
     QFileInfo fileInfo(filePath);
     QString absoluteFilePath = fileInfo.canonicalFilePath();
@@ -365,10 +610,26 @@ std::shared_ptr<Song> Player::createLocalSong(SongList::mapped_type::const_itera
     {
         try
         {
+            SongMetadata fileMetadata;
+
+            if (!metadata)
+            {
+                qint64 mtime = fileInfo.lastModified().toMSecsSinceEpoch();
+
+                if (!m_MetadataCache.find(absoluteFilePath, fileInfo.size(), mtime, fileMetadata))
+                {
+                    fileMetadata = Song::readMetadata(absoluteFilePath);
+                    m_MetadataCache.insert(absoluteFilePath, fileInfo.size(), mtime, fileMetadata);
+                }
+
+                metadata = &fileMetadata;
+            }
+
             SongId id = getNewSongId();
-            song.reset(new Song(id, absoluteFilePath, inFolder));
+            song.reset(new Song(id, absoluteFilePath, *metadata, inFolder));
+            updateAnalyses(*song, fileInfo);
 
-            pos = mp_Songs[list].insert(pos, song);
+            pos = insertSong(list, pos, song);
         }
         catch (FmodManager::StreamError error)
         {
@@ -380,8 +641,10 @@ std::shared_ptr<Song> Player::createLocalSong(SongList::mapped_type::const_itera
     }
     else
     {
-        song->setAvailable(true);
-        pos = std::find(pos, mp_Songs[list].cend(), song);
+        SongIt existingSong = m_Songs.find(song->getId());
+        m_Songs.setAvailable(existingSong, true);
+
+        pos = (m_Songs.getList(existingSong) == list) ? existingSong : UNDEFINED_SONG;
 
         return nullptr;
     }
@@ -392,6 +655,108 @@ std::shared_ptr<Song> Player::createLocalSong(SongList::mapped_type::const_itera
 // ==============================
 // ==============================
 
+void Player::updateAnalyses(Song& song, const QFileInfo& fileInfo)
+{
+    const qint64 mtime = fileInfo.lastModified().toMSecsSinceEpoch();
+    LoudnessInfo info;
+    int analyses = 0;
+
+    if (m_LoudnessCache.find(song.getFile(), fileInfo.size(), mtime, info))
+        song.setGain(SongAnalyzer::getGain(info));
+    else
+        analyses |= SongAnalyzer::LOUDNESS;
+
+    if (!m_SeekIndexCache.contains(song.getFile(), fileInfo.size(), mtime))
+        analyses |= SongAnalyzer::SEEK_INDEX;
+
+    if (analyses)
+        m_SongAnalyzer.analyze(song.getFile(), analyses);
+}
+
+// ==============================
+// ==============================
+
+std::shared_ptr<const SeekIndex> Player::findSeekIndex(const QString& file)
+{
+    QFileInfo fileInfo(file);
+    SeekIndex index;
+
+    if (!m_SeekIndexCache.find(file, fileInfo.size(), fileInfo.lastModified().toMSecsSinceEpoch(), index))
+    {
+        m_SongAnalyzer.analyze(file, SongAnalyzer::SEEK_INDEX, true);
+        return nullptr;
+    }
+
+    if (index.isEmpty())
+        return nullptr;
+
+    return std::make_shared<const SeekIndex>(std::move(index));
+}
+
+// ==============================
+// ==============================
+
+void Player::storeLoudness(const QString& file, float loudness, float truePeak)
+{
+    QFileInfo fileInfo(file);
+    LoudnessInfo info = { loudness, truePeak };
+
+    m_LoudnessCache.insert(file, fileInfo.size(), fileInfo.lastModified().toMSecsSinceEpoch(), info);
+
+    // Le gain est appliqué à la prochaine lecture de la musique
+    std::shared_ptr<Song> song = getLocalSong(file);
+    if (song)
+        song->setGain(SongAnalyzer::getGain(info));
+}
+
+// ==============================
+// ==============================
+
+void Player::storeWaveform(const QString& file, const QByteArray& peaks)
+{
+    QFileInfo fileInfo(file);
+
+    if (!m_WaveformCache.insert(file, fileInfo.size(), fileInfo.lastModified().toMSecsSinceEpoch(), peaks))
+        qWarning() << "Cannot save waveform" << file;
+
+    if (getCurrentSong() && getCurrentSong()->getFile() == file)
+        emit waveformChanged();
+}
+
+// ==============================
+// ==============================
+
+void Player::storeSeekIndex(const QString& file, quint32 sampleRate, const QByteArray& entries)
+{
+    QFileInfo fileInfo(file);
+    SeekIndex index(sampleRate, reinterpret_cast<const SeekIndex::Entry*>(entries.constData()), entries.size() / sizeof(SeekIndex::Entry));
+
+    if (!m_SeekIndexCache.insert(file, fileInfo.size(), fileInfo.lastModified().toMSecsSinceEpoch(), index))
+        qWarning() << "Cannot save seek index" << file;
+}
+
+// ==============================
+// ==============================
+
+QByteArray Player::getWaveform()
+{
+    std::shared_ptr<Song> song = getCurrentSong();
+    QByteArray peaks;
+
+    if (!song || song->isRemote())
+        return peaks;
+
+    QFileInfo fileInfo(song->getFile());
+
+    if (!m_WaveformCache.find(song->getFile(), fileInfo.size(), fileInfo.lastModified().toMSecsSinceEpoch(), peaks))
+        m_SongAnalyzer.analyze(song->getFile(), SongAnalyzer::WAVEFORM, true);
+
+    return peaks;
+}
+
+// ==============================
+// ==============================
+
 std::shared_ptr<network::RemoteSong> Player::createRemoteSong(const QString& file, SongId remoteId, SoundPos_t length, const QString& artist, SoundSettings *settings)
 {
     std::shared_ptr<network::RemoteSong> remoteSong = getRemoteSong(remoteId);
@@ -401,7 +766,7 @@ std::shared_ptr<network::RemoteSong> Player::createRemoteSong(const QString& fil
         SongId id = getNewSongId();
         remoteSong.reset(new network::RemoteSong(id, file, remoteId, length, artist, settings));
 
-        mp_Songs[SongList_t::REMOTE_SONGS].insert(mp_Songs[SongList_t::REMOTE_SONGS].cend(), remoteSong);
+        insertSong(SongList_t::REMOTE_SONGS, UNDEFINED_SONG, remoteSong);
     }
 
     return remoteSong;
@@ -410,19 +775,19 @@ std::shared_ptr<network::RemoteSong> Player::createRemoteSong(const QString& fil
 // ==============================
 // ==============================
 
-gui::SongListItem* Player::addNewSong(SongList_t list, SongList::mapped_type::const_iterator& pos, const QString& filePath,
-                                      gui::SongListItem *parentDir, bool forceItemCreation)
+gui::SongListItem* Player::addNewSong(SongList_t list, SongIt& pos, const QString& filePath,
+                                      gui::SongListItem *parentDir, bool forceItemCreation, const SongMetadata *metadata)
 {
     gui::SongListItem *item = nullptr;
 
     bool inFolder = (list == SongList_t::DIRECTORY_SONGS);
-    std::shared_ptr<Song> song = createLocalSong(pos, filePath, inFolder);
+    std::shared_ptr<Song> song = createLocalSong(pos, filePath, inFolder, metadata);
 
     if (song || forceItemCreation)
     {
         QFileInfo fileInfo(filePath);
         item = new gui::SongListItem(gui::SongListItem::ElementType::SONG, fileInfo.completeBaseName(), parentDir);
-        item->setAttachedSong(*pos);
+        item->setAttachedSong(m_Songs.get(pos));
     }
 
     return item;
@@ -433,7 +798,7 @@ gui::SongListItem* Player::addNewSong(SongList_t list, SongList::mapped_type::co
 
 gui::SongListItem* Player::addNewSong(SongList_t list, const QString& filePath, gui::SongListItem *parentDir)
 {
-    auto pos = mp_Songs[list].cend();
+    SongIt pos = UNDEFINED_SONG;
 
     return addNewSong(list, pos, filePath, parentDir);
 }
@@ -441,33 +806,40 @@ gui::SongListItem* Player::addNewSong(SongList_t list, const QString& filePath,
 // ==============================
 // ==============================
 
-gui::SongTreeRoot* Player::loadSongs(SongList::mapped_type::const_iterator& pos, const QString& dirPath, gui::SongTreeRoot *parentDir)
+gui::SongTreeRoot* Player::loadSongs(SongIt& pos, const QVector<SongScanner::Entry>& entries,
+                                     const QHash<QString, SongMetadata>& metadata, int& index, gui::SongTreeRoot *parentDir)
 {
     if (!parentDir)
         parentDir = new gui::SongTreeRoot(gui::SongListItem::ElementType::ROOT);
 
-    QDir dir(dirPath);
-    if (!dir.exists())
-        throw exceptions::FileLoadingException("Player::loadSongs", dirPath.toStdString());
+    if (index >= entries.size())
+        return parentDir;
 
-    QFileInfoList files = dir.entryInfoList(QDir::AllEntries | QDir::NoDotAndDotDot);
+    const unsigned int depth = entries.at(index).depth;
 
-    for (const QFileInfo& fileInfo : files)
+    while (index < entries.size() && entries.at(index).depth == depth)
     {
-        QString filePath = fileInfo.filePath();
+        const SongScanner::Entry& entry = entries.at(index++);
 
-        if (fileInfo.isDir())
+        if (entry.isDir)
         {
-            gui::SongListItem *item = new gui::SongListItem(gui::SongListItem::ElementType::DIRECTORY, fileInfo.completeBaseName());
-            loadSongs(pos, filePath, item);
+            gui::SongListItem *item = new gui::SongListItem(gui::SongListItem::ElementType::DIRECTORY, entry.name);
+
+            if (index < entries.size() && entries.at(index).depth > depth)
+                loadSongs(pos, entries, metadata, index, item);
 
             if (item->childCount() > 0)
                 item->setParent(parentDir);
+            else
+                delete item;
         }
         else
         {
-            addNewSong(SongList_t::DIRECTORY_SONGS, pos, filePath, parentDir, true);
-            ++pos;
+            auto fileMetadata = metadata.constFind(entry.canonicalPath);
+            const SongMetadata *probed = (fileMetadata != metadata.constEnd()) ? &fileMetadata.value() : nullptr;
+
+            addNewSong(SongList_t::DIRECTORY_SONGS, pos, entry.filePath, parentDir, true, probed);
+            pos = m_Songs.next(pos, SongList_t::DIRECTORY_SONGS);
         }
     }
 
@@ -479,22 +851,130 @@ gui::SongTreeRoot* Player::loadSongs(SongList::mapped_type::const_iterator& pos,
 
 gui::SongTreeRoot* Player::reloadSongs(const QString& dirPath)
 {
-    for (auto song : mp_Songs[SongList_t::DIRECTORY_SONGS])
-        song->setAvailable(false);
+    for (SongIt song = m_Songs.first(SongList_t::DIRECTORY_SONGS); song != UNDEFINED_SONG; song = m_Songs.next(song, SongList_t::DIRECTORY_SONGS))
+        m_Songs.setAvailable(song, false);
+
+    SongScanner scanner;
+    const QVector<SongScanner::Entry>& entries = scanner.walk(dirPath);
 
-    SongList::mapped_type::const_iterator pos = mp_Songs[SongList_t::DIRECTORY_SONGS].cbegin();
-    auto songTree = loadSongs(pos, dirPath);
+    // Seuls les fichiers inconnus du player et absents du cache sont lus (en parallèle)
+    QHash<QString, SongMetadata> metadata;
+    QHash<QString, const SongScanner::Entry*> newFiles;
 
-    auto it = mp_Songs.begin();
-    while (it != mp_Songs.end())
+    for (const SongScanner::Entry& entry : entries)
     {
-        if ((*it)->isInFolder() && !((*it)->isAvailable()))
-            it = mp_Songs.erase(it);
+        if (entry.isDir || getLocalSong(entry.canonicalPath))
+            continue;
+
+        SongMetadata cachedMetadata;
+        if (m_MetadataCache.find(entry.canonicalPath, entry.size, entry.mtime, cachedMetadata))
+            metadata.insert(entry.canonicalPath, cachedMetadata);
         else
-            ++it;
+            newFiles.insert(entry.canonicalPath, &entry);
     }
 
-    return songTree;
+    QHash<QString, SongMetadata> probedMetadata = scanner.probe(newFiles.keys());
+
+    for (auto it = probedMetadata.constBegin(); it != probedMetadata.constEnd(); ++it)
+    {
+        const SongScanner::Entry *entry = newFiles.value(it.key());
+        m_MetadataCache.insert(it.key(), entry->size, entry->mtime, it.value());
+        metadata.insert(it.key(), it.value());
+    }
+
+    if (m_MetadataCache.isDirty() && !m_MetadataCache.save())
+        qWarning() << "Cannot save metadata cache" << METADATA_CACHE_FILEPATH;
+
+    // Fusion dans l'ordre du parcours
+    SongIt pos = m_Songs.first(SongList_t::DIRECTORY_SONGS);
+    int index = 0;
+    auto songTree = loadSongs(pos, entries, metadata, index);
+
+    // Seules les musiques du répertoire sont parcourues : le suivant est lu avant la suppression
+    SongIt it = m_Songs.first(SongList_t::DIRECTORY_SONGS);
+    while (it != UNDEFINED_SONG)
+    {
+        SongIt next = m_Songs.next(it, SongList_t::DIRECTORY_SONGS);
+
+        if (!m_Songs.isAvailable(it) && it != m_Songs.getCursor())
+            eraseSong(it);
+
+        it = next;
+    }
+
+    m_LibraryWatcher.watch(dirPath, entries);
+
+    return songTree;
+}
+
+// ==============================
+// ==============================
+
+void Player::addWatchedSong(const QString& filePath)
+{
+    QFileInfo fileInfo(filePath);
+    QString canonicalPath = fileInfo.canonicalFilePath();
+
+    if (getLocalSong(canonicalPath))
+        return;
+
+    // Insertion à la place qu'aurait donnée un parcours complet, devant la musique suivante du parcours
+    auto next = m_DirectoryOrder.upperBound(SongScanner::walkOrderKey(canonicalPath));
+    SongIt pos = (next != m_DirectoryOrder.end()) ? next.value() : UNDEFINED_SONG;
+
+    gui::SongListItem *item = addNewSong(SongList_t::DIRECTORY_SONGS, pos, filePath);
+    if (!item)
+        return;
+
+    QStringList dirs;
+    QString relativeDir = QDir(m_LibraryWatcher.getRootPath()).relativeFilePath(fileInfo.path());
+
+    for (const QString& dir : relativeDir.split('/', QString::SkipEmptyParts))
+    {
+        if (dir != ".")
+            dirs.append(QFileInfo(dir).completeBaseName());
+    }
+
+    emit directorySongAdded(item, dirs);
+}
+
+// ==============================
+// ==============================
+
+void Player::removeWatchedSong(const QString& canonicalPath)
+{
+    std::shared_ptr<Song> song = getLocalSong(canonicalPath);
+
+    if (!song || !song->isInFolder())
+        return;
+
+    if (song == getCurrentSong())
+    {
+        m_Songs.setAvailable(m_Songs.getCursor(), false);
+        emit streamError(song->getId());
+        return;
+    }
+
+    SongId songId = song->getId();
+    eraseSong(findSong(songId));
+
+    emit directorySongRemoved(songId);
+}
+
+// ==============================
+// ==============================
+
+void Player::updateWatchedSong(const QString& filePath)
+{
+    std::shared_ptr<Song> song = getLocalSong(QFileInfo(filePath).canonicalFilePath());
+
+    if (song && song == getCurrentSong())
+        return;
+
+    if (song && song->isInFolder())
+        removeWatchedSong(song->getFile());
+
+    addWatchedSong(filePath);
 }
 
 // ==============================
@@ -509,7 +989,7 @@ void Player::firstSong(SongList_t list)
     else
     {
         stop();
-        m_CurrentSong = UNDEFINED_SONG;
+        m_Songs.setCursor(UNDEFINED_SONG);
         emit songChanged();
     }
 }
@@ -544,33 +1024,318 @@ void Player::nextSong()
 // ==============================
 // ==============================
 
+void Player::prepareNextSong()
+{
+    std::shared_ptr<Song> current = getCurrentSong();
+
+    if ((!m_Gapless && m_CrossfadeTime == 0) || !current || !current->isAvailable() || m_Loading)
+    {
+        cancelNextSong();
+        return;
+    }
+
+    SoundPos_t remaining = current->getLength() - std::min(current->getPosition(m_AudioThread), current->getLength());
+    SongIt next = UNDEFINED_SONG;
+
+    if (remaining <= std::max(GAPLESS_PRELOAD_TIME, GAPLESS_REMOTE_PRELOAD_TIME) + m_CrossfadeTime)
+    {
+        next = seekSong(m_Songs.getCursor(), true, true);
+
+        // Une musique ne peut pas être ouverte sur deux canaux (boucle sur une seule musique)
+        if (next == m_Songs.getCursor())
+            next = UNDEFINED_SONG;
+        else if (next != UNDEFINED_SONG && remaining > getPreloadTime(*m_Songs.get(next)) + m_CrossfadeTime)
+            next = UNDEFINED_SONG;
+    }
+
+    if (next == m_NextSong)
+    {
+        if (m_NextSongLoading)
+            startNextSong();
+
+        return;
+    }
+
+    cancelNextSong();
+
+    if (next == UNDEFINED_SONG)
+        return;
+
+    std::shared_ptr<Song> song = m_Songs.get(next);
+
+    try
+    {
+        if (!song->isRemote())
+            song->setSeekIndex(findSeekIndex(song->getFile()));
+
+        song->open(m_AudioThread, false);
+
+        m_NextSong = next;
+        m_NextSongLoading = true;
+    }
+    catch (FmodManager::StreamError error)
+    {
+        // Aucun canal disponible : la musique sera ouverte à la fin de la musique courante
+        if (error != FmodManager::StreamError::VOICE_ERROR)
+        {
+            m_Songs.setAvailable(next, false);
+            emit streamError(song->getId());
+        }
+
+        return;
+    }
+
+    startNextSong();
+}
+
+// ==============================
+// ==============================
+
+void Player::startNextSong()
+{
+    SongIt nextSong = m_NextSong;
+    std::shared_ptr<Song> current = getCurrentSong();
+    std::shared_ptr<Song> next = m_Songs.get(nextSong);
+
+    try
+    {
+        if (!next->isReady(m_AudioThread))
+            return;
+    }
+    catch (FmodManager::StreamError error)
+    {
+        cancelNextSong();
+        m_Songs.setAvailable(nextSong, false);
+        emit streamError(next->getId());
+        return;
+    }
+
+    m_NextSongLoading = false;
+
+    m_NextSongOverlap = getCrossfadeTime(*current, *next);
+    m_AudioThread.setEndSyncPoint(current->getSoundID(), m_NextSongOverlap);
+    next->playAfter(m_AudioThread, *current, m_NextSongOverlap, m_CrossfadeCurve);
+}
+
+// ==============================
+// ==============================
+
+void Player::scheduleNextSong()
+{
+    if (!m_Songs.isValid(m_NextSong))
+        return;
+
+    std::shared_ptr<Song> current = getCurrentSong();
+    std::shared_ptr<Song> next = m_Songs.get(m_NextSong);
+
+    if (!current || current->getPosition(m_AudioThread) + getPreloadTime(*next) + m_NextSongOverlap < current->getLength())
+    {
+        cancelNextSong();
+        return;
+    }
+
+    if (m_NextSongLoading)
+        return;
+
+    m_AudioThread.scheduleSound(next->getSoundID(), current->getSoundID(), m_NextSongOverlap, m_CrossfadeCurve);
+    next->pause(m_AudioThread, isPaused());
+}
+
+// ==============================
+// ==============================
+
+void Player::cancelNextSong()
+{
+    if (m_Songs.isValid(m_NextSong) && m_NextSong != m_Songs.getCursor())
+    {
+        m_Songs.get(m_NextSong)->release(m_AudioThread);
+
+        // Fondu de sortie programmé sur la musique courante
+        if (m_NextSongOverlap > 0 && getCurrentSong())
+        {
+            m_AudioThread.removeFadePoints(getCurrentSong()->getSoundID());
+            m_AudioThread.setEndSyncPoint(getCurrentSong()->getSoundID(), 0);
+        }
+    }
+
+    m_NextSong = UNDEFINED_SONG;
+    m_NextSongOverlap = 0;
+    m_NextSongLoading = false;
+}
+
+// ==============================
+// ==============================
+
+SoundPos_t Player::getPreloadTime(const Song& song) const
+{
+    return song.isRemote() ? GAPLESS_REMOTE_PRELOAD_TIME : GAPLESS_PRELOAD_TIME;
+}
+
+// ==============================
+// ==============================
+
+SoundPos_t Player::getCrossfadeTime(const Song& previous, const Song& next) const
+{
+    if (m_CrossfadeTime == 0)
+        return 0;
+
+    // Un stream distant sans avance suffisante risque de manquer de données pendant le fondu
+    if (m_SkipUnbufferedCrossfade)
+    {
+        if (previous.isRemote() && !m_AudioThread.isBuffered(previous.getSoundID()))
+            return 0;
+
+        if (next.isRemote() && !m_AudioThread.isBuffered(next.getSoundID()))
+            return 0;
+    }
+
+    return std::min(m_CrossfadeTime, std::min(previous.getLength(), next.getLength()) / 2);
+}
+
+// ==============================
+// ==============================
+
+void Player::stopFadingSong()
+{
+    if (mp_FadingSong)
+    {
+        mp_FadingSong->stop(m_AudioThread);
+        mp_FadingSong.reset();
+    }
+}
+
+// ==============================
+// ==============================
+
+void Player::finishLoading()
+{
+    std::shared_ptr<Song> song = getCurrentSong();
+
+    if (!m_Loading || !song)
+        return;
+
+    try
+    {
+        if (!song->isReady(m_AudioThread))
+            return;
+    }
+    catch (FmodManager::StreamError error)
+    {
+        m_Loading = false;
+        stopFadingSong();
+
+        m_Songs.setAvailable(m_Songs.getCursor(), false);
+        emit streamError(song->getId());
+        emit songChanged();
+
+        // Navigation : on passe à la musique disponible suivante, choix de l'utilisateur : arrêt
+        if (!m_LoadingSkip || moveCursor(m_LoadingForward, true) == UNDEFINED_SONG)
+            stop();
+
+        return;
+    }
+
+    m_Loading = false;
+
+    // Si le player n'est pas stoppé, on le joue
+    if (!isStopped())
+        song->play(m_AudioThread, isPaused());
+
+    // La musique précédente s'éteint en fondu enchaîné, ou est coupée
+    SoundPos_t crossfadeTime = (mp_FadingSong && isPlaying()) ? getCrossfadeTime(*mp_FadingSong, *song) : 0;
+
+    if (crossfadeTime > 0)
+    {
+        mp_FadingSong->m_SoundID = m_AudioThread.fadeOutSound(mp_FadingSong->getSoundID(), crossfadeTime, m_CrossfadeCurve);
+        m_AudioThread.fadeInSound(song->getSoundID(), crossfadeTime, m_CrossfadeCurve);
+    }
+    else
+    {
+        stopFadingSong();
+    }
+
+    requestPicture();
+
+    emit songLoaded();
+}
+
+// ==============================
+// ==============================
+
 bool Player::changeSong(SongIt song)
 {
-    if (song != UNDEFINED_SONG)
+    if (m_Songs.isValid(song))
     {
-        m_CurrentSong = song;
+        std::shared_ptr<Song> previous = getCurrentSong();
+
+        // Musique suivante déjà démarrée sur son canal secondaire : elle devient la musique principale
+        if (song == m_NextSong && !m_NextSongLoading && previous && previous->getPosition(m_AudioThread) + m_NextSongOverlap >= previous->getLength())
+        {
+            // La musique précédente termine son fondu de sortie sur un canal secondaire
+            if (m_NextSongOverlap > 0)
+            {
+                stopFadingSong();
+                previous->m_SoundID = m_AudioThread.moveToSecondaryCanal(previous->getSoundID());
+                mp_FadingSong = previous;
+            }
+
+            std::shared_ptr<Song> next = m_Songs.get(song);
+            next->m_SoundID = m_AudioThread.moveToMainCanal(next->getSoundID());
+
+            m_NextSong = UNDEFINED_SONG;
+            m_NextSongOverlap = 0;
+            m_Songs.setCursor(song);
+
+            requestPicture();
+
+            emit songChanged();
+            return true;
+        }
+
+        cancelNextSong();
+
+        if (m_Loading)
+        {
+            // Ouverture remplacée : la musique qui jouait avant reste sur son canal secondaire
+            getCurrentSong()->release(m_AudioThread);
+            m_Loading = false;
+        }
+        else if (isPlaying() && previous && previous->isAvailable() && song != m_Songs.getCursor() && m_Songs.isAvailable(song))
+        {
+            // La musique courante continue sur un canal secondaire jusqu'à l'ouverture de la suivante
+            stopFadingSong();
+            previous->m_SoundID = m_AudioThread.moveToSecondaryCanal(previous->getSoundID());
+            mp_FadingSong = previous;
+        }
+
+        if (mp_FadingSong == m_Songs.get(song))
+            stopFadingSong();
+
+        m_LoadingSkip = false;
+        m_Songs.setCursor(song);
 
         if (!getCurrentSong()->isAvailable())
         {
+            stopFadingSong();
             emit songChanged();
             return true;
         }
 
         try
         {
-            // Ouverture du fichier
-            getCurrentSong()->open();
-            getCurrentSong()->addDSP(SPECTRUM_WIDTH);
+            if (!getCurrentSong()->isRemote())
+                getCurrentSong()->setSeekIndex(findSeekIndex(getCurrentSong()->getFile()));
 
-            // Si le player n'est pas stoppé, on le joue
-            if (!isStopped())
-                getCurrentSong()->play();
+            // Ouverture du fichier en arrière-plan, la lecture démarre dans finishLoading
+            getCurrentSong()->open(m_AudioThread);
+            m_Loading = true;
 
             emit songChanged();
         }
         catch (FmodManager::StreamError error)
         {
-            getCurrentSong()->setAvailable(false);
+            stopFadingSong();
+            m_Songs.setAvailable(m_Songs.getCursor(), false);
             emit streamError(getCurrentSong()->getId());
             emit songChanged();
         }
@@ -580,7 +1345,7 @@ bool Player::changeSong(SongIt song)
         stop();
     }
 
-    return (m_CurrentSong == song);
+    return (m_Songs.getCursor() == song);
 }
 
 // ==============================
@@ -605,45 +1370,48 @@ void Player::removeSong(SongId songId)
 
     if (song != UNDEFINED_SONG)
     {
-        if (song != m_CurrentSong)
+        if (song != m_Songs.getCursor())
         {
-            mp_Songs.erase(song);
+            eraseSong(song);
             return;
         }
 
-        findNextSong((*song)->isAvailable());
-        if (song != m_CurrentSong)
+        // Seule la musique courante est disponible (boucle) : inutile de la rouvrir
+        if (seekSong(song, true, m_Songs.isAvailable(song)) != song)
+            findNextSong(m_Songs.isAvailable(song));
+
+        if (song != m_Songs.getCursor())
         {
-            mp_Songs.erase(song);
+            eraseSong(song);
             return;
         }
 
         if (!isLoop())
         {
-            findPrevSong((*song)->isAvailable());
-            if (song != m_CurrentSong)
+            findPrevSong(m_Songs.isAvailable(song));
+            if (song != m_Songs.getCursor())
             {
-                mp_Songs.erase(song);
+                eraseSong(song);
                 return;
             }
         }
 
         stop();
 
-        if ((*song)->isAvailable())
+        if (m_Songs.isAvailable(song))
         {
             findNextSong(false);
-            if (!isLoop() && m_CurrentSong == song)
+            if (!isLoop() && m_Songs.getCursor() == song)
                 findPrevSong(false);
         }
 
-        if (m_CurrentSong == song)
+        if (m_Songs.getCursor() == song)
         {
-            m_CurrentSong = UNDEFINED_SONG;
+            m_Songs.setCursor(UNDEFINED_SONG);
             emit songChanged();
         }
 
-        mp_Songs.erase(song);
+        eraseSong(song);
     }
 }
 
@@ -652,19 +1420,51 @@ void Player::removeSong(SongId songId)
 
 void Player::update()
 {
+    finishLoading();
+
     if (isPlaying())
-    {
-        if (getCurrentSong()->isFinished())
-            nextSong();
-    }
+        prepareNextSong();
+
+    // L'analyse de loudness ne concurrence ni l'ouverture des musiques, ni un stream distant, ni une preview
+    std::shared_ptr<Song> song = getCurrentSong();
+    bool remote = song && song->isRemote() && !isStopped();
+
+    m_SongAnalyzer.setThrottled(m_Loading || m_NextSongLoading || remote || mp_PreviewId != nullptr);
+
+    cuePreview();
+}
+
+// ==============================
+// ==============================
 
-    if (mp_PreviewId != nullptr && getPreviewPosition() >= getPreviewLength())
+void Player::checkSongEnd()
+{
+    if (!isPlaying() || m_Loading)
+        return;
+
+    // Fin de la musique, ou début du fondu enchaîné avec la musique suivante
+    if (getCurrentSong()->getPosition(m_AudioThread) + m_NextSongOverlap >= getCurrentSong()->getLength())
+        nextSong();
+}
+
+// ==============================
+// ==============================
+
+void Player::checkSoundEnd(SoundID_t id)
+{
+    // L'emplacement a pu être réutilisé depuis l'émission du signal
+    if (m_AudioThread.isPlaying(id))
+        return;
+
+    if (mp_FadingSong != nullptr && !m_Loading && mp_FadingSong->getSoundID() == id)
+        mp_FadingSong.reset();
+
+    // Un canal de preview arrêté peut signaler sa fin après l'ouverture d'une nouvelle preview au même emplacement
+    if (mp_PreviewId != nullptr && *mp_PreviewId == id && m_PreviewCued)
     {
         stopPreview();
         emit previewFinished();
     }
-
-    FmodManager::getInstance().update();
 }
 
 // ==============================
@@ -672,7 +1472,7 @@ void Player::update()
 
 bool Player::isPreviewing() const
 {
-    return (mp_PreviewId != nullptr && FmodManager::getInstance().isPlaying(*mp_PreviewId));
+    return (mp_PreviewId != nullptr && m_PreviewStarted);
 }
 
 // ==============================
@@ -680,10 +1480,12 @@ bool Player::isPreviewing() const
 
 SoundPos_t Player::getPreviewPosition() const
 {
-    if (!mp_PreviewId)
+    if (!isPreviewing() || !m_PreviewCued)
         return 0;
 
-    return FmodManager::getInstance().getSoundPosition(*mp_PreviewId);
+    SoundPos_t pos = m_AudioThread.getSoundPosition(*mp_PreviewId);
+
+    return (pos > m_PreviewOffset) ? (pos - m_PreviewOffset) : 0;
 }
 
 // ==============================
@@ -691,10 +1493,41 @@ SoundPos_t Player::getPreviewPosition() const
 
 SoundPos_t Player::getPreviewLength() const
 {
-    if (!mp_PreviewId)
+    if (!isPreviewing() || !m_PreviewCued)
         return 0;
 
-    return FmodManager::getInstance().getSoundLength(*mp_PreviewId);
+    SoundPos_t length = m_AudioThread.getSoundLength(*mp_PreviewId);
+
+    return (length > m_PreviewOffset) ? (length - m_PreviewOffset) : 0;
+}
+
+// ==============================
+// ==============================
+
+void Player::preparePreview(const QString& filePath)
+{
+    if (mp_PreviewId && m_PreviewFile == filePath)
+        return;
+
+    stopPreview();
+
+    try
+    {
+        mp_PreviewId = std::make_unique<SoundID_t>(m_AudioThread.openFromFile(filePath.toStdString(), VoiceRole::PREVIEW));
+    }
+    catch (FmodManager::StreamError error)
+    {
+        qWarning() << "Unable to preview" << filePath;
+        return;
+    }
+
+    m_PreviewFile = filePath;
+    m_PreviewOffset = 0;
+    m_PreviewScanned = false;
+    m_PreviewCued = false;
+    m_PreviewStarted = false;
+
+    m_PreviewScanner.scan(filePath);
 }
 
 // ==============================
@@ -702,10 +1535,102 @@ SoundPos_t Player::getPreviewLength() const
 
 void Player::startPreview(const QString& filePath)
 {
+    preparePreview(filePath);
+
+    if (!mp_PreviewId || m_PreviewStarted)
+        return;
+
     pause();
+    m_PreviewStarted = true;
+
+    // Position de la preview publiée par le thread audio pendant la pause de la musique
+    m_AudioThread.setActive(true);
+
+    if (m_PreviewCued)
+        m_AudioThread.pauseSound(*mp_PreviewId, false);
+    else
+        cuePreview();
+}
+
+// ==============================
+// ==============================
+
+void Player::cuePreview()
+{
+    if (!mp_PreviewId || m_PreviewCued)
+        return;
+
+    try
+    {
+        if (!m_AudioThread.isSoundReady(*mp_PreviewId))
+            return;
+    }
+    catch (FmodManager::StreamError error)
+    {
+        qWarning() << "Unable to preview" << m_PreviewFile;
+
+        const bool started = m_PreviewStarted;
+        stopPreview();
+
+        if (started)
+            emit previewFinished();
+
+        return;
+    }
+
+    // Une preview démarrée avant la fin de l'analyse commence au début du fichier
+    if (!m_PreviewScanned && !m_PreviewStarted)
+        return;
+
+    m_AudioThread.playSound(*mp_PreviewId, 1.0f, true);
+    m_AudioThread.setSoundPosition(*mp_PreviewId, m_PreviewOffset);
+    m_AudioThread.pauseSound(*mp_PreviewId, !m_PreviewStarted);
+
+    m_PreviewCued = true;
+}
+
+// ==============================
+// ==============================
 
-    mp_PreviewId = std::make_unique<SoundID_t>(FmodManager::getInstance().openFromFile(filePath.toStdString(), false));
-    FmodManager::getInstance().playSound(*mp_PreviewId);
+void Player::requestPicture()
+{
+    std::shared_ptr<Song> song = getCurrentSong();
+
+    m_Picture = QPixmap();
+
+    if (song && song->isAvailable())
+        m_PictureSerial = song->requestPicture(m_AudioThread);
+}
+
+// ==============================
+// ==============================
+
+void Player::storePicture(SoundID_t id, unsigned long long serial, const QByteArray& data)
+{
+    std::shared_ptr<Song> song = getCurrentSong();
+
+    // Musique changée depuis la demande
+    if (serial != m_PictureSerial || !song || song->getSoundID() != id)
+        return;
+
+    m_Picture = Song::buildPicture(data);
+
+    if (!m_Picture.isNull())
+        emit pictureChanged();
+}
+
+// ==============================
+// ==============================
+
+void Player::storePreviewOffset(const QString& file, quint32 pos)
+{
+    if (!mp_PreviewId || m_PreviewCued || file != m_PreviewFile)
+        return;
+
+    m_PreviewOffset = pos;
+    m_PreviewScanned = true;
+
+    cuePreview();
 }
 
 // ==============================
@@ -713,13 +1638,22 @@ void Player::startPreview(const QString& filePath)
 
 void Player::stopPreview()
 {
+    m_PreviewScanner.cancel();
+
     if (mp_PreviewId)
     {
-        FmodManager::getInstance().stopSound(*mp_PreviewId);
+        // Libération différée si l'ouverture de la preview n'est pas terminée
+        m_AudioThread.releaseSound(*mp_PreviewId);
         mp_PreviewId.reset(nullptr);
+        m_PreviewFile.clear();
 
-        if (isPaused())
+        if (m_PreviewStarted && isPaused())
             play();
+
+        m_PreviewCued = false;
+        m_PreviewStarted = false;
+
+        m_AudioThread.setActive(isPlaying());
     }
 }
 
@@ -730,6 +1664,8 @@ void Player::closeClientFile()
 {
     if (clientFile.isOpen())
         clientFile.close();
+
+    mp_ClientSeekIndex = nullptr;
 }
 
 // ==============================
@@ -749,7 +1685,7 @@ void Player::executeNetworkCommand(std::shared_ptr<network::commands::CommandReq
             SongIt song = findSong(songId);
             if (song != UNDEFINED_SONG)
             {
-                clientFile.setFileName((*song)->getFile());
+                clientFile.setFileName(m_Songs.get(song)->getFile());
                 clientFile.open(QIODevice::ReadOnly);
             }
 
@@ -760,13 +1696,15 @@ void Player::executeNetworkCommand(std::shared_ptr<network::commands::CommandReq
                 unsigned int fileSize = clientFile.size();
                 clientFile.seek(0);
 
+                mp_ClientSeekIndex = findSeekIndex(clientFile.fileName());
+
                 reply = std::make_shared<network::commands::OpenCommandReply>(songId, FMOD_OK, fileSize);
             }
             break;
         }
 
         case 'c':
-            clientFile.close();
+            closeClientFile();
             reply = std::make_shared<network::commands::CloseCommandReply>(songId, FMOD_OK);
             break;
 
@@ -781,11 +1719,33 @@ void Player::executeNetworkCommand(std::shared_ptr<network::commands::CommandReq
         }
 
         case 's':
-            if (clientFile.seek(std::static_pointer_cast<network::commands::SeekCommandRequest>(command)->getPos()))
-                reply = std::make_shared<network::commands::SeekCommandReply>(songId, FMOD_OK);
-            else
-                reply = std::make_shared<network::commands::SeekCommandReply>(songId, FMOD_ERR_FILE_COULDNOTSEEK);
+        {
+            std::shared_ptr<network::commands::SeekCommandRequest> request = std::static_pointer_cast<network::commands::SeekCommandRequest>(command);
+            unsigned int pos = request->getPos();
+            unsigned int time = network::commands::SeekCommandRequest::NO_TIME;
+
+            // Position demandée en ms : début de la trame indexée au lieu de l'estimation de FMOD,
+            // renvoyé au client qui corrige la position de son canal
+            if (request->hasTime() && mp_ClientSeekIndex)
+            {
+                SeekIndex::Entry entry = mp_ClientSeekIndex->find(request->getTime());
+                pos = entry.offset;
+                time = mp_ClientSeekIndex->getTime(entry);
+            }
+
+            if (!clientFile.seek(pos))
+            {
+                reply = std::make_shared<network::commands::SeekCommandReply>(songId, FMOD_ERR_FILE_COULDNOTSEEK, nullptr, 0);
+                break;
+            }
+
+            // Les premières données sont renvoyées avec la réponse : un seul aller-retour par déplacement
+            char *buffer = new char[request->getBytesToRead()];
+            unsigned int readBytes = std::max<qint64>(clientFile.read(buffer, request->getBytesToRead()), 0);
+
+            reply = std::make_shared<network::commands::SeekCommandReply>(songId, FMOD_OK, buffer, readBytes, time);
             break;
+        }
 
         default:
             break;
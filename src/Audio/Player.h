@@ -13,11 +13,25 @@
 #define __PLAYER_H__
 
 #include <QFile>
+#include <QHash>
+#include <QMap>
+#include <QFileInfo>
+#include <QPixmap>
 
 #include "FmodManager.h"
-#include "../Util/composedmap.h"
 #include "../Constants.h"
 #include "../Gui/SongListItem.h"
+#include "SongMetadata.h"
+#include "SongScanner.h"
+#include "MetadataCache.h"
+#include "LoudnessCache.h"
+#include "WaveformCache.h"
+#include "SeekIndexCache.h"
+#include "SongAnalyzer.h"
+#include "PreviewScanner.h"
+#include "LibraryWatcher.h"
+#include "SongStore.h"
+#include "AudioThread.h"
 
 
 namespace network
@@ -35,8 +49,8 @@ namespace network
 namespace audio {
 
 
-#define FIRST_SONG      mp_Songs.begin()
-#define UNDEFINED_SONG  mp_Songs.end()
+#define FIRST_SONG      m_Songs.first()
+#define UNDEFINED_SONG  SongStore::Handle()
 
 class Song;
 
@@ -51,16 +65,39 @@ class Player : public QObject
 
     private:
 
-        using SongList = util::ComposedMap<SongList_t, std::list<std::shared_ptr<Song>>>;
-        using SongIt = SongList::const_iterator;
+        using SongIt = SongStore::Handle;
 
         unsigned int m_Cpt;
 
-        SongList mp_Songs;
-        SongIt m_CurrentSong;
+        // Musiques et musique courante (curseur du store)
+        SongStore m_Songs;
+
+        // Index des musiques de m_Songs, tenus à jour par insertSong/eraseSong/clearSongs
+        QHash<QString, std::shared_ptr<Song>> m_LocalSongs;
+        QHash<SongId, std::shared_ptr<network::RemoteSong>> m_RemoteSongs;
+
+        // Musiques du répertoire triées dans l'ordre du parcours (clé : SongScanner::walkOrderKey)
+        QMap<QString, SongIt> m_DirectoryOrder;
 
         bool m_Playlist;
         bool m_Loop;
+        bool m_Gapless;
+
+        // Fondu enchaîné (durée en ms, 0 : désactivé)
+        SoundPos_t m_CrossfadeTime;
+        FadeCurve m_CrossfadeCurve;
+        bool m_SkipUnbufferedCrossfade;
+
+        // Musique suivante ouverte sur un canal secondaire, démarrée à la fin de la musique courante
+        // (ou m_NextSongOverlap ms avant en cas de fondu enchaîné)
+        SongIt m_NextSong;
+        SoundPos_t m_NextSongOverlap;
+        bool m_NextSongLoading;
+
+        // Ouverture asynchrone de la musique courante en cours (et sens de la navigation qui l'a lancée)
+        bool m_Loading;
+        bool m_LoadingSkip;
+        bool m_LoadingForward;
 
         bool m_Pause;
         bool m_Stop;
@@ -70,7 +107,39 @@ class Player : public QObject
 
         QFile clientFile;
 
+        // Index de déplacement du fichier ouvert par l'autre client (déplacements demandés en ms)
+        std::shared_ptr<const SeekIndex> mp_ClientSeekIndex;
+
+        MetadataCache m_MetadataCache;
+
+        // Loudness, forme d'onde et index de déplacement de chaque fichier, calculés en arrière-plan pour les fichiers inconnus
+        LoudnessCache m_LoudnessCache;
+        WaveformCache m_WaveformCache;
+        SeekIndexCache m_SeekIndexCache;
+        SongAnalyzer m_SongAnalyzer;
+
+        LibraryWatcher m_LibraryWatcher;
+
+        // Preview ouverte en arrière-plan dès l'entrée du glisser-déposer (voir preparePreview),
+        // puis créée en pause à m_PreviewOffset pour être pré-chargée avant son démarrage
         std::unique_ptr<SoundID_t> mp_PreviewId;
+        QString m_PreviewFile;
+        SoundPos_t m_PreviewOffset;
+        bool m_PreviewScanned;
+        bool m_PreviewCued;
+        bool m_PreviewStarted;
+        PreviewScanner m_PreviewScanner;
+
+        // Musique précédente, jouée sur un canal secondaire le temps de l'ouverture
+        // de la musique courante puis de son fondu de sortie
+        std::shared_ptr<Song> mp_FadingSong;
+
+        // Mise à jour de FMOD, commandes de lecture et état du canal principal
+        AudioThread m_AudioThread;
+
+        // Pochette de la musique courante, lue par le thread audio (voir requestPicture)
+        QPixmap m_Picture;
+        unsigned long long m_PictureSerial;
 
 
         /**
@@ -79,6 +148,27 @@ class Player : public QObject
          */
         SongId getNewSongId();
 
+        /**
+         * @brief Insère la musique dans la liste passée en paramètre et l'ajoute aux index.
+         * @param list Liste à laquelle la musique est ajoutée
+         * @param pos Musique devant laquelle la musique est ajoutée (fin de liste si nulle)
+         * @param song Musique à ajouter
+         * @return Position de la musique ajoutée
+         */
+        SongIt insertSong(SongList_t list, SongIt pos, const std::shared_ptr<Song>& song);
+
+        /**
+         * @brief Retire la musique des index.
+         * @param song Musique à retirer
+         */
+        void unindexSong(const std::shared_ptr<Song>& song);
+
+        /**
+         * @brief Supprime la musique de la liste et des index.
+         * @param song Musique à supprimer
+         */
+        void eraseSong(SongIt song);
+
         /**
          * @brief Récupère la musique du fichier passé en paramètre si elle est dans la liste.
          * @param filePath Chemin du fichier à chercher
@@ -86,6 +176,34 @@ class Player : public QObject
          */
         std::shared_ptr<Song> getLocalSong(const QString& filePath) const;
 
+        /**
+         * @brief Applique à la musique le gain de normalisation du cache, et demande l'analyse
+         *        du fichier s'il n'a pas encore été mesuré ou indexé.
+         * @param song Musique locale
+         * @param fileInfo Informations du fichier de la musique
+         */
+        void updateAnalyses(Song& song, const QFileInfo& fileInfo);
+
+        /**
+         * @brief Lit l'index de déplacement du fichier dans le cache, ou demande
+         *        sa construction en priorité s'il n'a pas encore été indexé.
+         * @param file Chemin canonique du fichier
+         * @return Index du fichier, nullptr s'il est inconnu ou vide
+         */
+        std::shared_ptr<const SeekIndex> findSeekIndex(const QString& file);
+
+        /**
+         * @brief Crée le canal de la preview en pause à sa position de départ dès que son ouverture
+         *        est terminée et que cette position est connue (ou que la preview a démarré).
+         *        La preview est abandonnée si son ouverture a échoué.
+         */
+        void cuePreview();
+
+        /**
+         * @brief Demande la pochette de la musique courante une fois ouverte (signal pictureChanged à sa réception).
+         */
+        void requestPicture();
+
         /**
          * @brief Récupère la musique distante d'identifiant passé en paramètre si elle est dans la liste.
          * @param id Identifiant de la musique distante
@@ -98,9 +216,11 @@ class Player : public QObject
          * @param pos Position à laquelle le nouveau son est ajouté
          * @param filePath Chemin du son à créer
          * @param inFolder Présence du son dans le dossier ou non
+         * @param metadata Informations du fichier déjà lues (lues depuis le fichier si nullptr)
          * @return Objet son créé, nullptr sinon
          */
-        std::shared_ptr<Song> createLocalSong(SongList::mapped_type::const_iterator& pos, const QString& filePath, bool inFolder);
+        std::shared_ptr<Song> createLocalSong(SongIt& pos, const QString& filePath, bool inFolder,
+                                              const SongMetadata *metadata = nullptr);
 
         /**
          * @brief Ajoute une nouvelle musique dans la liste du player.
@@ -109,15 +229,17 @@ class Player : public QObject
          * @param filePath Chemin du fichier à ajouter
          * @param parentDir Parent dans l'arborescence
          * @param forceItemCreation true si la création de l'item est forcée
+         * @param metadata Informations du fichier déjà lues (lues depuis le fichier si nullptr)
          * @return Elément de l'arborescence contenant la nouvelle musique
          */
-        gui::SongListItem* addNewSong(SongList_t list, SongList::mapped_type::const_iterator& pos, const QString& filePath,
-                                      gui::SongListItem *parentDir = nullptr, bool forceItemCreation = false);
+        gui::SongListItem* addNewSong(SongList_t list, SongIt& pos, const QString& filePath,
+                                      gui::SongListItem *parentDir = nullptr, bool forceItemCreation = false,
+                                      const SongMetadata *metadata = nullptr);
 
         /**
          * @brief Recherche une musique à partir de son identifiant.
          * @param songId Identifiant de la musique
-         * @return Itérateur sur le son correspondant à l'identifiant passé en paramètre (end si pas trouvé)
+         * @return Itérateur sur le son correspondant à l'identifiant passé en paramètre (nul si pas trouvé)
          */
         SongIt findSong(SongId songId) const;
 
@@ -129,38 +251,176 @@ class Player : public QObject
         SongIt first(SongList_t list = SongList_t::ALL_SONGS) const;
 
         /**
-         * @brief Retourne la musique précédente (la dernière si boucle).
+         * @brief Retourne la musique précédant celle passée en paramètre (la dernière si boucle).
+         * @param song Musique de départ (nulle : dernière musique)
          * @return Position de la musique précédente
          */
-        SongIt prev() const;
+        SongIt prev(SongIt song) const;
 
         /**
-         * @brief Retourne la musique suivante (la première si boucle).
+         * @brief Retourne la musique suivant celle passée en paramètre (la première si boucle).
+         * @param song Musique de départ
          * @return Position de la musique suivante
          */
-        SongIt next() const;
+        SongIt next(SongIt song) const;
 
         /**
-         * @brief Cherche la musique précédente avec la disponibilité indiquée.
+         * @brief Détermine la musique cible d'un déplacement, sans ouvrir aucun fichier
+         *        (seules les disponibilités connues du store sont consultées).
+         * @param from Musique de départ
+         * @param forward true pour chercher vers l'avant, false vers l'arrière
+         * @param available true pour ignorer les musiques indisponibles
+         * @return Position de la musique cible (nulle si aucune)
+         */
+        SongIt seekSong(SongIt from, bool forward, bool available) const;
+
+        /**
+         * @brief Lance la musique cible d'un déplacement depuis la musique courante.
+         *        Seule la cible est ouverte ; si son ouverture échoue, la recherche reprend au-delà.
+         * @param forward true pour avancer, false pour reculer
+         * @param available true pour ignorer les musiques indisponibles
+         * @return Position de la musique lancée (nulle si aucune, la musique courante est alors conservée)
+         */
+        SongIt moveCursor(bool forward, bool available);
+
+        /**
+         * @brief Lance la musique précédente avec la disponibilité indiquée.
          * @param available Disponibilité minimale de la musique cherchée
-         * @return Position de la musique précédente
+         * @return Position de la musique précédente (nulle si aucune)
          */
         SongIt findPrevSong(bool available);
 
         /**
-         * @brief Cherche la musique suivante avec la disponibilité indiquée.
+         * @brief Lance la musique suivante avec la disponibilité indiquée.
          * @param available Disponibilité minimale de la musique cherchée
-         * @return Position de la musique suivante
+         * @return Position de la musique suivante (nulle si aucune)
          */
         SongIt findNextSong(bool available);
 
+        /**
+         * @brief Ouvre la musique suivante sur un canal secondaire peu avant la fin de la musique courante
+         *        et la programme pour démarrer exactement à sa fin (mode sans blanc).
+         */
+        void prepareNextSong();
+
+        /**
+         * @brief Programme la musique suivante une fois son ouverture terminée.
+         */
+        void startNextSong();
+
+        /**
+         * @brief Lance la lecture de la musique courante une fois son ouverture terminée.
+         */
+        void finishLoading();
+
+        /**
+         * @brief Recale le démarrage de la musique suivante sur la position de la musique courante,
+         *        ou la libère si la fin de la musique courante est trop éloignée.
+         */
+        void scheduleNextSong();
+
+        /**
+         * @brief Libère la musique suivante préparée (et le fondu de sortie de la musique courante).
+         */
+        void cancelNextSong();
+
+        /**
+         * @brief Retourne l'avance avec laquelle la musique doit être ouverte pour être enchaînée.
+         * @param song Musique suivante
+         * @return Avance (ms)
+         */
+        SoundPos_t getPreloadTime(const Song& song) const;
+
+        /**
+         * @brief Calcule la durée du fondu enchaîné entre deux musiques ouvertes.
+         * @param previous Musique sortante
+         * @param next Musique entrante
+         * @return Durée du fondu (ms, 0 si désactivé ou si un stream distant n'est pas assez chargé)
+         */
+        SoundPos_t getCrossfadeTime(const Song& previous, const Song& next) const;
+
+        /**
+         * @brief Coupe la musique précédente en cours de fondu de sortie.
+         */
+        void stopFadingSong();
+
         /**
          * @brief Lance la musique passée en paramètre.
-         * @param song Itérateur sur la musique
+         * @param song Musique à lancer
          * @return true si la musique a bien été modifiée
          */
         bool changeSong(SongIt song);
 
+    private slots:
+
+        /**
+         * @brief Ajoute à sa place dans la liste le fichier apparu dans le répertoire des musiques.
+         * @param filePath Chemin du fichier ajouté
+         */
+        void addWatchedSong(const QString& filePath);
+
+        /**
+         * @brief Retire de la liste le fichier supprimé du répertoire des musiques.
+         *        La musique courante est conservée (indisponible) pour ne pas interrompre la lecture.
+         * @param canonicalPath Chemin canonique du fichier supprimé
+         */
+        void removeWatchedSong(const QString& canonicalPath);
+
+        /**
+         * @brief Relit le fichier modifié dans le répertoire des musiques (sauf s'il est en cours de lecture).
+         * @param filePath Chemin du fichier modifié
+         */
+        void updateWatchedSong(const QString& filePath);
+
+        /**
+         * @brief Passe à la musique suivante si la musique courante est terminée (signalé par le thread audio).
+         */
+        void checkSongEnd();
+
+        /**
+         * @brief Libère la musique en fondu de sortie ou termine la preview dont le canal s'est arrêté.
+         * @param id Identifiant du canal terminé
+         */
+        void checkSoundEnd(SoundID_t id);
+
+        /**
+         * @brief Conserve la loudness mesurée par le thread d'analyse et met à jour le gain de la musique.
+         * @param file Chemin du fichier mesuré
+         * @param loudness Loudness intégrée (LUFS)
+         * @param truePeak True peak (dBTP)
+         */
+        void storeLoudness(const QString& file, float loudness, float truePeak);
+
+        /**
+         * @brief Conserve la forme d'onde calculée par le thread d'analyse.
+         * @param file Chemin du fichier analysé
+         * @param peaks Forme d'onde (WAVEFORM_RESOLUTION WaveformPoint)
+         */
+        void storeWaveform(const QString& file, const QByteArray& peaks);
+
+        /**
+         * @brief Conserve l'index de déplacement construit par le thread d'analyse (utilisé à la prochaine ouverture).
+         * @param file Chemin du fichier indexé
+         * @param sampleRate Fréquence d'échantillonnage du fichier
+         * @param entries Entrées de l'index (SeekIndex::Entry)
+         */
+        void storeSeekIndex(const QString& file, quint32 sampleRate, const QByteArray& entries);
+
+        /**
+         * @brief Conserve la position de départ de la preview trouvée par PreviewScanner.
+         * @param file Fichier analysé
+         * @param pos Début de la section la plus forte du fichier (ms)
+         */
+        void storePreviewOffset(const QString& file, quint32 pos);
+
+        /**
+         * @brief Conserve la pochette lue par le thread audio si elle est celle de la dernière demande.
+         * @param id Identifiant du son
+         * @param serial Numéro de la demande
+         * @param data Données de l'image
+         */
+        void storePicture(SoundID_t id, unsigned long long serial, const QByteArray& data);
+
     signals:
 
         /**
@@ -168,6 +428,21 @@ class Player : public QObject
          */
         void songChanged();
 
+        /**
+         * @brief Signal émis lorsque la forme d'onde du son courant vient d'être calculée (voir getWaveform).
+         */
+        void waveformChanged();
+
+        /**
+         * @brief Signal émis lorsque l'ouverture du son courant est terminée et que sa lecture démarre.
+         */
+        void songLoaded();
+
+        /**
+         * @brief Signal émis lorsque la pochette de la musique courante a été lue (voir getPicture).
+         */
+        void pictureChanged();
+
         /**
          * @brief Signal émis lorsque le player change d'état.
          * @param state Nouvel état du player
@@ -185,12 +460,37 @@ class Player : public QObject
          */
         void previewFinished();
 
+        /**
+         * @brief Signal émis lorsqu'une musique apparaît dans le répertoire surveillé.
+         * @param item Elément de l'arborescence contenant la nouvelle musique
+         * @param dirs Noms des répertoires parents, depuis la racine du répertoire surveillé
+         */
+        void directorySongAdded(gui::SongListItem *item, const QStringList& dirs);
+
+        /**
+         * @brief Signal émis lorsqu'une musique du répertoire surveillé a été retirée de la liste.
+         * @param songId Identifiant de la musique retirée
+         */
+        void directorySongRemoved(audio::Player::SongId songId);
+
         /**
          * @brief Signal émis lorsque la commande reçue a été traitée et que la réponse est créée.
          * @param reply Réponse à la requête exécutée
          */
         void commandExecuted(std::shared_ptr<network::commands::CommandReply> reply);
 
+        /**
+         * @brief Signal émis lorsque l'état du moteur audio demandé par requestAudioStatus a été relevé.
+         * @param residents Sons chargés en mémoire, du plus récemment ouvert au plus ancien
+         */
+        void residentSoundsRead(const std::vector<audio::FmodManager::ResidentInfo>& residents);
+
+        /**
+         * @brief Signal émis lorsque l'état du moteur audio demandé par requestAudioStatus a été relevé.
+         * @param voices Canaux actifs du pool et lectures de durée en cours
+         */
+        void voicesRead(const std::vector<audio::FmodManager::VoiceInfo>& voices);
+
     public:
 
         Player();
@@ -202,6 +502,13 @@ class Player : public QObject
          */
         std::shared_ptr<Song> getCurrentSong();
 
+        /**
+         * @brief Cherche la forme d'onde du son courant dans le cache. Si elle n'a pas encore été
+         *        calculée, son calcul est demandé en priorité (signal waveformChanged une fois terminé).
+         * @return Forme d'onde (WAVEFORM_RESOLUTION WaveformPoint), vide si inconnue ou son distant
+         */
+        QByteArray getWaveform();
+
         /**
          * @brief Compte le nombre de musiques de la liste passée en paramètre.
          * @param list Liste dont on veut le nombre d'éléments
@@ -248,6 +555,12 @@ class Player : public QObject
          */
         bool isPaused() const;
 
+        /**
+         * @brief isLoading
+         * @return true si l'ouverture de la musique courante n'est pas terminée.
+         */
+        bool isLoading() const;
+
         /**
          * @brief isMuted
          * @return true si le player est mute.
@@ -266,6 +579,101 @@ class Player : public QObject
          */
         void setLoop(bool loop);
 
+        /**
+         * @brief isGapless
+         * @return true si la musique suivante est enchaînée sans blanc.
+         */
+        bool isGapless() const;
+
+        /**
+         * @brief Active ou désactive l'enchaînement sans blanc des musiques.
+         * @param gapless Valeur à affecter à l'attribut Gapless.
+         */
+        void setGapless(bool gapless);
+
+        /**
+         * @brief getCrossfadeTime
+         * @return Durée du fondu enchaîné (ms, 0 : désactivé).
+         */
+        SoundPos_t getCrossfadeTime() const;
+
+        /**
+         * @brief Modifie la durée du fondu enchaîné entre deux musiques.
+         * @param length Durée du fondu (ms, 0 pour le désactiver)
+         */
+        void setCrossfadeTime(SoundPos_t length);
+
+        /**
+         * @brief getCrossfadeCurve
+         * @return Courbe du fondu enchaîné.
+         */
+        FadeCurve getCrossfadeCurve() const;
+
+        /**
+         * @brief Modifie la courbe du fondu enchaîné.
+         * @param curve Courbe à appliquer
+         */
+        void setCrossfadeCurve(FadeCurve curve);
+
+        /**
+         * @brief isSkippingUnbufferedCrossfade
+         * @return true si les musiques distantes insuffisamment chargées sont enchaînées sans fondu.
+         */
+        bool isSkippingUnbufferedCrossfade() const;
+
+        /**
+         * @brief Active ou désactive le fondu enchaîné des musiques distantes insuffisamment chargées.
+         * @param skip true pour les enchaîner sans fondu
+         */
+        void setSkipUnbufferedCrossfade(bool skip);
+
+        /**
+         * @brief Modifie la position de la musique courante.
+         * @param pos Nouvelle position en ms
+         */
+        void setPosition(SoundPos_t pos);
+
+        /**
+         * @brief Arrête le thread audio (à appeler avant la destruction de FmodManager).
+         */
+        void stopAudioThread();
+
+        /**
+         * @brief getPosition
+         * @return Position de la musique courante (dernier état publié par le thread audio).
+         */
+        SoundPos_t getPosition() const;
+
+        /**
+         * @brief Récupère le dernier spectre publié par le DSP du groupe de canaux.
+         * @param frame Spectre récupéré (inchangé si aucun nouveau spectre n'a été publié)
+         * @return true si un nouveau spectre a été récupéré
+         */
+        bool getSpectrum(SpectrumFrame& frame);
+
+        /**
+         * @brief Active ou contourne le DSP du spectre.
+         * @param enabled true si le spectre est affiché
+         */
+        void setSpectrumEnabled(bool enabled);
+
+        /**
+         * @brief Modifie la mémoire maximale des sons chargés en mémoire.
+         * @param megabytes Mémoire maximale (Mo, 0 : tous les fichiers sont lus en stream)
+         */
+        void setSampleBudget(unsigned int megabytes);
+
+        /**
+         * @brief getPicture
+         * @return Pochette de la musique courante (vide si elle n'en a pas ou si elle n'a pas encore été lue).
+         */
+        const QPixmap& getPicture() const;
+
+        /**
+         * @brief Demande l'état du moteur audio (signaux voicesRead et residentSoundsRead).
+         */
+        void requestAudioStatus();
+
         /**
          * @brief getVolumeState
          * @return Etat du volume.
@@ -305,17 +713,21 @@ class Player : public QObject
         gui::SongListItem* addNewSong(SongList_t list, const QString& filePath, gui::SongListItem *parentDir = nullptr);
 
         /**
-         * @brief Remplit le vecteur Musiques à partir des fichiers
-         *        contenus dans le répertoire donné en paramètre.
+         * @brief Remplit le vecteur Musiques à partir des éléments d'un répertoire
+         *        parcouru par le SongScanner, dans l'ordre du parcours.
          * @param pos Position à laquelle les musiques du répertoire sont ajoutées
-         * @param dirPath Répertoire à parcourir
+         * @param entries Eléments du répertoire
+         * @param metadata Informations des nouveaux fichiers, lues par le SongScanner
+         * @param index Indice du premier élément à traiter (avancé jusqu'à la fin du répertoire courant)
          * @param parentDir Parent dans l'arborescence
          * @return Arborescence des fichiers lus
          */
-        gui::SongTreeRoot* loadSongs(SongList::mapped_type::const_iterator& pos, const QString& dirPath, gui::SongTreeRoot *parentDir = nullptr);
+        gui::SongTreeRoot* loadSongs(SongIt& pos, const QVector<SongScanner::Entry>& entries,
+                                     const QHash<QString, SongMetadata>& metadata, int& index, gui::SongTreeRoot *parentDir = nullptr);
 
         /**
          * @brief Recharge la liste des musiques locales avec le répertoire passé en paramètre.
+         *        Le répertoire est ensuite surveillé et les modifications appliquées fichier par fichier.
          * @param dirPath Répertoire à parcourir
          * @return Arborescence des fichiers lus
          */
@@ -338,7 +750,8 @@ class Player : public QObject
         void nextSong();
 
         /**
-         * @brief Met à jour Fmod et la lecture de musique en changeant si besoin.
+         * @brief Met à jour la lecture de musique (fin d'ouverture, préparation de la musique suivante).
+         *        FMOD est mis à jour par le thread audio.
          */
         void update();
 
@@ -350,24 +763,31 @@ class Player : public QObject
 
         /**
          * @brief Retourne la position de la chanson prévisualisée.
-         * @return Position courante de la prévisualisation
+         * @return Position courante de la prévisualisation (depuis sa position de départ)
          */
         SoundPos_t getPreviewPosition() const;
 
         /**
          * @brief Retourne la longueur de la chanson prévisualisée.
-         * @return Longueur de la chanson prévisualisée
+         * @return Longueur de la chanson prévisualisée après sa position de départ (0 tant qu'elle est en cours d'ouverture)
          */
         SoundPos_t getPreviewLength() const;
 
         /**
-         * @brief Démarre la preview de la chanson passée en paramètre.
+         * @brief Ouvre en arrière-plan la preview de la chanson passée en paramètre et cherche
+         *        sa section la plus forte, sans interrompre la lecture.
+         * @param filePath Chemin de la chanson à prévisualiser
+         */
+        void preparePreview(const QString& filePath);
+
+        /**
+         * @brief Démarre la preview de la chanson passée en paramètre (préparée si elle ne l'a pas été).
          * @param filePath Chemin de la chanson à lancer
          */
         void startPreview(const QString& filePath);
 
         /**
-         * @brief Arrête la preview et poursuit la lecture mise en pause.
+         * @brief Arrête ou abandonne la preview et poursuit la lecture mise en pause.
          */
         void stopPreview();
 
@@ -0,0 +1,205 @@
+/*************************************
+ * @file    PreviewScanner.cpp
+ * @date    17/10/26
+ * @author  Manuel
+ *
+ * Définitions de la classe PreviewScanner.
+ *************************************
+*/
+
+#include "PreviewScanner.h"
+#include "FmodManager.h"
+#include <QMutexLocker>
+#include <vector>
+
+
+namespace audio {
+
+
+namespace {
+
+/**
+ * @brief Cherche la fenêtre de plus forte énergie.
+ * @param energies Energie de chaque pas
+ * @param windowSteps Nombre de pas de la fenêtre
+ * @param lastStart Dernier pas auquel la fenêtre peut commencer
+ * @return Premier pas de la fenêtre la plus forte
+ */
+std::size_t findLoudestWindow(const std::vector<double>& energies, std::size_t windowSteps, std::size_t lastStart)
+{
+    if (energies.size() <= windowSteps)
+        return 0;
+
+    double sum = 0;
+
+    for (std::size_t i = 0; i < windowSteps; i++)
+        sum += energies[i];
+
+    double loudest = sum;
+    std::size_t start = 0;
+
+    for (std::size_t i = 1; i <= lastStart && i + windowSteps <= energies.size(); i++)
+    {
+        sum += energies[i + windowSteps - 1] - energies[i - 1];
+
+        if (sum > loudest)
+        {
+            loudest = sum;
+            start = i;
+        }
+    }
+
+    return start;
+}
+
+}
+
+// ==============================
+// ==============================
+
+PreviewScanner::PreviewScanner(QObject *parent)
+    : QThread(parent), m_Request(0)
+{
+
+}
+
+// ==============================
+// ==============================
+
+PreviewScanner::~PreviewScanner()
+{
+    stop();
+}
+
+// ==============================
+// ==============================
+
+void PreviewScanner::stop()
+{
+    {
+        QMutexLocker locker(&m_Mutex);
+        requestInterruption();
+        m_Condition.wakeAll();
+    }
+
+    wait();
+}
+
+// ==============================
+// ==============================
+
+void PreviewScanner::scan(const QString& file)
+{
+    QMutexLocker locker(&m_Mutex);
+
+    m_File = file;
+    m_Request++;
+
+    m_Condition.wakeOne();
+}
+
+// ==============================
+// ==============================
+
+void PreviewScanner::cancel()
+{
+    QMutexLocker locker(&m_Mutex);
+
+    m_File.clear();
+    m_Request++;
+}
+
+// ==============================
+// ==============================
+
+bool PreviewScanner::isCanceled(unsigned int request)
+{
+    QMutexLocker locker(&m_Mutex);
+
+    return (request != m_Request || isInterruptionRequested());
+}
+
+// ==============================
+// ==============================
+
+void PreviewScanner::run()
+{
+    while (!isInterruptionRequested())
+    {
+        QString file;
+        unsigned int request;
+
+        {
+            QMutexLocker locker(&m_Mutex);
+
+            while (m_File.isEmpty() && !isInterruptionRequested())
+                m_Condition.wait(&m_Mutex);
+
+            if (isInterruptionRequested())
+                break;
+
+            file = m_File;
+            request = m_Request;
+            m_File.clear();
+        }
+
+        scanFile(file, request);
+    }
+}
+
+// ==============================
+// ==============================
+
+void PreviewScanner::scanFile(const QString& file, unsigned int request)
+{
+    std::vector<double> energies;
+    unsigned long long stepFrames = 0, maxFrames = 0, frames = 0;
+    double energy = 0;
+    bool complete = false;
+
+    try
+    {
+        complete = FmodManager::getInstance().decodeFile(file.toStdString(),
+            [&](const float *samples, unsigned int count, int channels, int sampleRate) {
+                if (stepFrames == 0)
+                {
+                    stepFrames = static_cast<unsigned long long>(sampleRate) * PREVIEW_SCAN_STEP / 1000;
+                    maxFrames = static_cast<unsigned long long>(sampleRate) * PREVIEW_SCAN_LENGTH / 1000;
+                }
+
+                for (unsigned int i = 0; i < count; i++)
+                {
+                    for (int c = 0; c < channels; c++, samples++)
+                        energy += *samples * *samples;
+
+                    if (++frames % stepFrames == 0)
+                    {
+                        energies.push_back(energy);
+                        energy = 0;
+                    }
+                }
+
+                return (frames < maxFrames && !isCanceled(request));
+            });
+    }
+    catch (FmodManager::StreamError error)
+    {
+        energies.clear();
+    }
+
+    if (isCanceled(request))
+        return;
+
+    const std::size_t windowSteps = PREVIEW_SCAN_WINDOW / PREVIEW_SCAN_STEP;
+    const std::size_t lengthSteps = PREVIEW_LENGTH / PREVIEW_SCAN_STEP;
+    std::size_t lastStart = energies.size();
+
+    // Fichier entièrement décodé : la preview ne démarre pas trop près de la fin
+    if (complete)
+        lastStart = (energies.size() > lengthSteps) ? (energies.size() - lengthSteps) : 0;
+
+    emit offsetFound(file, static_cast<quint32>(findLoudestWindow(energies, windowSteps, lastStart) * PREVIEW_SCAN_STEP));
+}
+
+
+} // audio
@@ -0,0 +1,100 @@
+/*************************************
+ * @file    PreviewScanner.h
+ * @date    17/10/26
+ * @author  Manuel
+ *
+ * Déclarations de la classe PreviewScanner
+ * cherchant en arrière-plan la position
+ * de départ de la preview d'un fichier.
+ *************************************
+*/
+
+#ifndef __PREVIEWSCANNER_H__
+#define __PREVIEWSCANNER_H__
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QString>
+
+#include "../Constants.h"
+
+
+namespace audio {
+
+
+/**
+ * Le thread décode le début du fichier (PREVIEW_SCAN_LENGTH ms, FmodManager::decodeFile)
+ * et mesure son énergie par pas de PREVIEW_SCAN_STEP ms : la preview démarre au début
+ * des PREVIEW_SCAN_WINDOW ms les plus fortes.
+ * Seul le dernier fichier demandé est analysé, une nouvelle demande interrompt l'analyse en cours.
+ */
+class PreviewScanner : public QThread
+{
+    Q_OBJECT
+
+    private:
+
+        QMutex m_Mutex;
+        QWaitCondition m_Condition;
+
+        // Fichier en attente d'analyse (vide si aucun)
+        QString m_File;
+
+        // Incrémenté à chaque demande pour interrompre l'analyse en cours
+        unsigned int m_Request;
+
+
+        /**
+         * @brief Détermine si l'analyse de la demande passée en paramètre doit s'arrêter.
+         * @param request Numéro de la demande analysée
+         * @return true si une autre demande a été faite ou si le thread doit s'arrêter
+         */
+        bool isCanceled(unsigned int request);
+
+        /**
+         * @brief Décode le début du fichier et cherche sa section la plus forte.
+         * @param file Fichier à analyser
+         * @param request Numéro de la demande analysée
+         */
+        void scanFile(const QString& file, unsigned int request);
+
+    protected:
+
+        void run() override;
+
+    public:
+
+        PreviewScanner(QObject *parent = nullptr);
+        virtual ~PreviewScanner();
+
+        /**
+         * @brief Arrête le thread (l'analyse en cours est abandonnée).
+         */
+        void stop();
+
+        /**
+         * @brief Remplace le fichier à analyser (l'analyse en cours est abandonnée).
+         * @param file Fichier à analyser
+         */
+        void scan(const QString& file);
+
+        /**
+         * @brief Abandonne l'analyse en cours ou en attente.
+         */
+        void cancel();
+
+    signals:
+
+        /**
+         * @brief Emis depuis le thread lorsque la position de départ de la preview a été trouvée.
+         * @param file Fichier analysé
+         * @param pos Début de la section la plus forte (ms, 0 si le fichier n'a pas pu être décodé)
+         */
+        void offsetFound(const QString& file, quint32 pos);
+};
+
+
+} // audio
+
+#endif  // __PREVIEWSCANNER_H__
@@ -0,0 +1,352 @@
+/*************************************
+ * @file    SeekIndex.cpp
+ * @date    17/10/26
+ * @author  Manuel
+ *
+ * Définitions de la classe SeekIndex.
+ *************************************
+*/
+
+#include "SeekIndex.h"
+#include "../Constants.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+
+namespace audio {
+
+
+namespace {
+
+// Octets parcourus à la recherche de la première trame (après les tags ID3v2)
+constexpr unsigned int SYNC_SEARCH_SIZE = 65536;
+
+// Trames consécutives cohérentes nécessaires pour reconnaître un fichier MPEG
+constexpr unsigned int SYNC_FRAMES_NB = 4;
+
+// Lectures du fichier par blocs
+constexpr unsigned int READ_BLOCK_SIZE = 65536;
+
+// Débits (kbit/s) : MPEG-1 couches I, II, III, puis MPEG-2/2.5 couche I et couches II/III
+constexpr unsigned short BITRATES[5][14] = {
+    { 32, 64, 96, 128, 160, 192, 224, 256, 288, 320, 352, 384, 416, 448 },
+    { 32, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384 },
+    { 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320 },
+    { 32, 48, 56, 64, 80, 96, 112, 128, 144, 160, 176, 192, 224, 256 },
+    { 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160 }
+};
+
+constexpr unsigned int SAMPLE_RATES[3] = { 44100, 48000, 32000 };
+
+struct FrameHeader
+{
+    unsigned int format;            // Version, couche et fréquence (identiques dans tout le fichier)
+    unsigned int bitrate;           // bit/s
+    unsigned int sampleRate;
+    unsigned int samples;           // Echantillons par canal
+    unsigned int size;              // Octets (en-tête compris)
+    unsigned int tagOffset;         // Position d'un éventuel en-tête Xing/Info dans la trame (0 : couche I ou II)
+};
+
+/**
+ * @brief Décode l'en-tête de 4 octets d'une trame MPEG audio.
+ * @param bytes En-tête
+ * @param header En-tête décodé
+ * @return false si les octets ne forment pas un en-tête valide (débit libre compris)
+ */
+bool parseHeader(const unsigned char *bytes, FrameHeader& header)
+{
+    if (bytes[0] != 0xFF || (bytes[1] & 0xE0) != 0xE0)
+        return false;
+
+    const unsigned int version = (bytes[1] >> 3) & 0x03;       // 0 : MPEG-2.5, 2 : MPEG-2, 3 : MPEG-1
+    const unsigned int layer = (bytes[1] >> 1) & 0x03;         // 1 : couche III, 2 : couche II, 3 : couche I
+    const unsigned int bitrateIndex = bytes[2] >> 4;
+    const unsigned int rateIndex = (bytes[2] >> 2) & 0x03;
+    const unsigned int padding = (bytes[2] >> 1) & 0x01;
+    const bool mono = ((bytes[3] >> 6) == 0x03);
+
+    if (version == 1 || layer == 0 || bitrateIndex == 0 || bitrateIndex == 15 || rateIndex == 3)
+        return false;
+
+    const bool mpeg1 = (version == 3);
+    const unsigned int table = mpeg1 ? (3 - layer) : ((layer == 3) ? 3 : 4);
+
+    header.format = ((bytes[1] & 0xFE) << 8) | (bytes[2] & 0x0C);
+    header.bitrate = BITRATES[table][bitrateIndex - 1] * 1000;
+    header.sampleRate = SAMPLE_RATES[rateIndex] >> (mpeg1 ? 0 : ((version == 2) ? 1 : 2));
+
+    if (layer == 3)
+    {
+        header.samples = 384;
+        header.size = (12 * header.bitrate / header.sampleRate + padding) * 4;
+        header.tagOffset = 0;
+    }
+    else
+    {
+        header.samples = (layer == 1 && !mpeg1) ? 576 : 1152;
+        header.size = header.samples / 8 * header.bitrate / header.sampleRate + padding;
+        header.tagOffset = (layer == 1) ? (4 + (mpeg1 ? (mono ? 17 : 32) : (mono ? 9 : 17))) : 0;
+    }
+
+    return true;
+}
+
+/**
+ * Lecture d'un fichier par blocs, les positions demandées étant croissantes.
+ */
+class BlockReader
+{
+    private:
+
+        std::ifstream m_Stream;
+        std::vector<unsigned char> m_Block;
+        unsigned int m_BlockStart;
+
+    public:
+
+        BlockReader(const std::string& file)
+            : m_Stream(file, std::ios::binary), m_BlockStart(0)
+        {
+
+        }
+
+        bool isOpen() const
+        {
+            return m_Stream.is_open();
+        }
+
+        /**
+         * @brief Lit des octets du fichier.
+         * @param offset Position des octets
+         * @param length Nombre d'octets (au plus READ_BLOCK_SIZE)
+         * @return Octets lus, nullptr si la fin du fichier est atteinte
+         */
+        const unsigned char* read(unsigned int offset, unsigned int length)
+        {
+            if (offset < m_BlockStart || offset + length > m_BlockStart + m_Block.size())
+            {
+                m_Block.resize(READ_BLOCK_SIZE);
+
+                m_Stream.clear();
+                m_Stream.seekg(offset);
+                m_Stream.read(reinterpret_cast<char*>(m_Block.data()), m_Block.size());
+
+                m_Block.resize(m_Stream.gcount());
+                m_BlockStart = offset;
+
+                if (length > m_Block.size())
+                    return nullptr;
+            }
+
+            return m_Block.data() + (offset - m_BlockStart);
+        }
+};
+
+/**
+ * @brief Vérifie que des trames cohérentes se suivent à partir de la position passée en paramètre.
+ * @param reader Fichier lu
+ * @param offset Position de la première trame
+ * @param header En-tête de la première trame
+ * @return true si SYNC_FRAMES_NB trames de même format se suivent
+ */
+bool isSynchronized(BlockReader& reader, unsigned int offset, const FrameHeader& header)
+{
+    FrameHeader next = header;
+
+    for (unsigned int i = 1; i < SYNC_FRAMES_NB; i++)
+    {
+        offset += next.size;
+
+        const unsigned char *bytes = reader.read(offset, 4);
+        if (!bytes || !parseHeader(bytes, next) || next.format != header.format)
+            return false;
+    }
+
+    return true;
+}
+
+}
+
+// ==============================
+// ==============================
+
+SeekIndex::SeekIndex()
+    : m_SampleRate(0)
+{
+
+}
+
+// ==============================
+// ==============================
+
+SeekIndex::SeekIndex(unsigned int sampleRate, const Entry *entries, std::size_t count)
+    : m_SampleRate(sampleRate), m_Entries(entries, entries + count)
+{
+
+}
+
+// ==============================
+// ==============================
+
+SeekIndex SeekIndex::build(const std::string& file)
+{
+    BlockReader reader(file);
+
+    if (!reader.isOpen())
+        return SeekIndex();
+
+    /* Tags ID3v2 (taille "synchsafe" sur 4 x 7 bits, pied de page éventuel) */
+    unsigned int start = 0;
+    const unsigned char *bytes;
+
+    while ((bytes = reader.read(start, 10)) && std::memcmp(bytes, "ID3", 3) == 0)
+    {
+        start += 10 + ((bytes[6] & 0x7F) << 21 | (bytes[7] & 0x7F) << 14 | (bytes[8] & 0x7F) << 7 | (bytes[9] & 0x7F));
+
+        if (bytes[5] & 0x10)
+            start += 10;
+    }
+
+    /* Première trame suivie de trames cohérentes */
+    FrameHeader first;
+    unsigned int offset = start;
+
+    while (true)
+    {
+        if (offset >= start + SYNC_SEARCH_SIZE || !(bytes = reader.read(offset, 4)))
+            return SeekIndex();
+
+        if (parseHeader(bytes, first) && isSynchronized(reader, offset, first))
+            break;
+
+        offset++;
+    }
+
+    bool variable = false;
+
+    /* Trame Xing/Info (couche III) ou VBRI : résumé du fichier, sans son */
+    if (first.tagOffset && (bytes = reader.read(offset + first.tagOffset, 4)))
+    {
+        variable = (std::memcmp(bytes, "Xing", 4) == 0);
+
+        if (variable || std::memcmp(bytes, "Info", 4) == 0)
+            offset += first.size;
+    }
+
+    if (!variable && (bytes = reader.read(offset + 36, 4)) && std::memcmp(bytes, "VBRI", 4) == 0)
+    {
+        variable = true;
+        offset += first.size;
+    }
+
+    /* Parcours des trames jusqu'à la première donnée qui n'en est pas une (tags de fin, fin du fichier) */
+    SeekIndex index;
+    index.m_SampleRate = first.sampleRate;
+
+    const unsigned long long interval = static_cast<unsigned long long>(SEEK_INDEX_INTERVAL) * first.sampleRate / 1000;
+    unsigned long long sample = 0;
+    unsigned long long nextEntry = 0;
+    FrameHeader header;
+
+    while ((bytes = reader.read(offset, 4)) && parseHeader(bytes, header) && header.format == first.format)
+    {
+        if (sample >= nextEntry)
+        {
+            index.m_Entries.push_back({ static_cast<unsigned int>(sample), offset });
+            nextEntry = (sample / interval + 1) * interval;
+        }
+
+        if (header.bitrate != first.bitrate)
+            variable = true;
+
+        sample += header.samples;
+        offset += header.size;
+    }
+
+    // A débit constant, la position calculée par FMOD est exacte
+    if (!variable)
+        return SeekIndex();
+
+    return index;
+}
+
+// ==============================
+// ==============================
+
+bool SeekIndex::isEmpty() const
+{
+    return m_Entries.empty();
+}
+
+// ==============================
+// ==============================
+
+unsigned int SeekIndex::getSampleRate() const
+{
+    return m_SampleRate;
+}
+
+// ==============================
+// ==============================
+
+const std::vector<SeekIndex::Entry>& SeekIndex::getEntries() const
+{
+    return m_Entries;
+}
+
+// ==============================
+// ==============================
+
+SeekIndex::Entry SeekIndex::find(unsigned int pos) const
+{
+    if (m_Entries.empty())
+        return { 0, 0 };
+
+    const unsigned long long sample = static_cast<unsigned long long>(pos) * m_SampleRate / 1000;
+
+    auto entry = std::upper_bound(m_Entries.begin(), m_Entries.end(), sample, [](unsigned long long value, const Entry& e) {
+        return value < e.sample;
+    });
+
+    return (entry == m_Entries.begin()) ? *entry : *(entry - 1);
+}
+
+// ==============================
+// ==============================
+
+SeekIndex::Entry SeekIndex::locate(const std::string& file, unsigned int pos) const
+{
+    Entry entry = find(pos);
+
+    if (m_Entries.empty())
+        return entry;
+
+    const unsigned long long sample = static_cast<unsigned long long>(pos) * m_SampleRate / 1000;
+
+    // Au plus SEEK_INDEX_INTERVAL ms de trames entre l'entrée et la position
+    BlockReader reader(file);
+    FrameHeader header;
+    const unsigned char *bytes;
+
+    while (reader.isOpen() && (bytes = reader.read(entry.offset, 4)) && parseHeader(bytes, header)
+           && entry.sample + header.samples <= sample)
+    {
+        entry.sample += header.samples;
+        entry.offset += header.size;
+    }
+
+    return entry;
+}
+
+// ==============================
+// ==============================
+
+unsigned int SeekIndex::getTime(const Entry& entry) const
+{
+    return (m_SampleRate != 0) ? static_cast<unsigned int>(static_cast<unsigned long long>(entry.sample) * 1000 / m_SampleRate) : 0;
+}
+
+
+} // audio
@@ -0,0 +1,104 @@
+/*************************************
+ * @file    SeekIndex.h
+ * @date    17/10/26
+ * @author  Manuel
+ *
+ * Déclarations de la classe SeekIndex
+ * associant des positions d'un fichier
+ * MPEG à leur position dans le fichier.
+ *************************************
+*/
+
+#ifndef __SEEKINDEX_H__
+#define __SEEKINDEX_H__
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+
+namespace audio {
+
+
+/**
+ * Index de déplacement d'un fichier MPEG audio (mp3) à débit variable : une entrée toutes
+ * les SEEK_INDEX_INTERVAL ms, donnant le début exact (en échantillons) de la première trame
+ * commençant après cette durée et sa position dans le fichier.
+ * L'index est construit en lisant uniquement les en-têtes des trames, sans décodage.
+ * Un fichier à débit constant, ou qui n'est pas un fichier MPEG, a un index vide :
+ * FMOD calcule alors lui-même la position exacte.
+ */
+class SeekIndex
+{
+    public:
+
+        struct Entry
+        {
+            unsigned int sample;        // Début de la trame (échantillons depuis le début du son)
+            unsigned int offset;        // Position de la trame dans le fichier (octets)
+        };
+
+    private:
+
+        unsigned int m_SampleRate;
+
+        std::vector<Entry> m_Entries;
+
+    public:
+
+        SeekIndex();
+        SeekIndex(unsigned int sampleRate, const Entry *entries, std::size_t count);
+
+        /**
+         * @brief Construit l'index du fichier en parcourant ses trames.
+         * @param file Fichier à indexer
+         * @return Index du fichier (vide s'il n'est pas un fichier MPEG à débit variable)
+         */
+        static SeekIndex build(const std::string& file);
+
+        /**
+         * @brief isEmpty
+         * @return true si l'index ne contient aucune entrée.
+         */
+        bool isEmpty() const;
+
+        /**
+         * @brief getSampleRate
+         * @return Fréquence d'échantillonnage du fichier (Hz, 0 pour un index vide).
+         */
+        unsigned int getSampleRate() const;
+
+        /**
+         * @brief getEntries
+         * @return Entrées de l'index, triées.
+         */
+        const std::vector<Entry>& getEntries() const;
+
+        /**
+         * @brief Cherche la dernière trame indexée commençant au plus tard à la position passée en paramètre.
+         * @param pos Position recherchée (ms)
+         * @return Entrée trouvée (la première entrée si pos la précède)
+         */
+        Entry find(unsigned int pos) const;
+
+        /**
+         * @brief Cherche la trame contenant la position passée en paramètre : part de la trame indexée
+         *        qui la précède (voir find) et parcourt les en-têtes des trames suivantes.
+         * @param file Fichier indexé
+         * @param pos Position recherchée (ms)
+         * @return Trame contenant la position (trame indexée si le fichier ne peut pas être lu)
+         */
+        Entry locate(const std::string& file, unsigned int pos) const;
+
+        /**
+         * @brief Convertit le début d'une entrée en ms.
+         * @param entry Entrée de l'index
+         * @return Début de la trame (ms, arrondi à l'inférieur)
+         */
+        unsigned int getTime(const Entry& entry) const;
+};
+
+
+} // audio
+
+#endif  // __SEEKINDEX_H__
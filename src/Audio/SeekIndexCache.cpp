@@ -0,0 +1,228 @@
+/*************************************
+ * @file    SeekIndexCache.cpp
+ * @date    17/10/26
+ * @author  Manuel
+ *
+ * Définitions de la classe SeekIndexCache.
+ *************************************
+*/
+
+#include "SeekIndexCache.h"
+#include "MetadataCache.h"
+#include <QSaveFile>
+#include <cstring>
+
+
+namespace audio {
+
+
+namespace {
+
+constexpr char CACHE_MAGIC[4] = { 'P', 'S', 'I', 'C' };
+constexpr quint32 CACHE_VERSION = 1;
+
+}
+
+// ==============================
+// ==============================
+
+SeekIndexCache::SeekIndexCache(const QString& filePath)
+    : m_FilePath(filePath), m_UnusedSize(0)
+{
+    static_assert(sizeof(Header) == 8, "Unexpected cache header size");
+    static_assert(sizeof(Record) == 32, "Unexpected cache record size");
+    static_assert(sizeof(SeekIndex::Entry) == 8, "Unexpected seek index entry size");
+}
+
+// ==============================
+// ==============================
+
+bool SeekIndexCache::reset()
+{
+    m_Index.clear();
+    m_UnusedSize = 0;
+
+    Header header;
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.version = CACHE_VERSION;
+
+    return m_File.resize(0) && m_File.seek(0)
+           && m_File.write(reinterpret_cast<const char*>(&header), sizeof(Header)) == sizeof(Header);
+}
+
+// ==============================
+// ==============================
+
+bool SeekIndexCache::load()
+{
+    if (m_File.isOpen())
+        m_File.close();
+
+    m_Index.clear();
+    m_UnusedSize = 0;
+
+    m_File.setFileName(m_FilePath);
+    if (!m_File.open(QIODevice::ReadWrite))
+        return false;
+
+    Header header;
+    if (m_File.read(reinterpret_cast<char*>(&header), sizeof(Header)) != sizeof(Header)
+            || std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 || header.version != CACHE_VERSION)
+        return reset();
+
+    const qint64 fileSize = m_File.size();
+    qint64 position = sizeof(Header);
+
+    while (position + static_cast<qint64>(sizeof(Record)) <= fileSize)
+    {
+        Record record;
+
+        if (!m_File.seek(position) || m_File.read(reinterpret_cast<char*>(&record), sizeof(Record)) != sizeof(Record))
+            return reset();
+
+        const qint64 length = sizeof(Record) + static_cast<qint64>(record.count) * sizeof(SeekIndex::Entry);
+        if (position + length > fileSize)
+            break;
+
+        auto previous = m_Index.constFind(record.pathHash);
+        if (previous != m_Index.constEnd())
+            m_UnusedSize += previous->length;
+
+        m_Index.insert(record.pathHash, { position, length, record.size, record.mtime });
+        position += length;
+    }
+
+    // Un enregistrement écrit partiellement (arrêt pendant l'écriture) est retiré pour être remplacé par le suivant
+    if (position < fileSize && !m_File.resize(position))
+        return reset();
+
+    // Un échec de la réécriture laisse le cache utilisable tel quel
+    if (m_UnusedSize > position / 2)
+        compact();
+
+    return true;
+}
+
+// ==============================
+// ==============================
+
+bool SeekIndexCache::compact()
+{
+    QSaveFile file(m_FilePath);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    Header header;
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.version = CACHE_VERSION;
+
+    if (file.write(reinterpret_cast<const char*>(&header), sizeof(Header)) != sizeof(Header))
+        return false;
+
+    QHash<quint64, Location> index;
+
+    for (auto it = m_Index.constBegin(); it != m_Index.constEnd(); ++it)
+    {
+        if (!m_File.seek(it->position))
+            return false;
+
+        QByteArray data = m_File.read(it->length);
+        const qint64 position = file.pos();
+
+        if (data.size() != it->length || file.write(data) != data.size())
+            return false;
+
+        index.insert(it.key(), { position, it->length, it->size, it->mtime });
+    }
+
+    // Le fichier remplacé doit être fermé (Windows)
+    m_File.close();
+    const bool committed = file.commit();
+
+    if (!m_File.open(QIODevice::ReadWrite))
+    {
+        m_Index.clear();
+        return false;
+    }
+
+    if (!committed)
+        return false;
+
+    m_Index = index;
+    m_UnusedSize = 0;
+
+    return true;
+}
+
+// ==============================
+// ==============================
+
+bool SeekIndexCache::contains(const QString& path, qint64 size, qint64 mtime) const
+{
+    auto location = m_Index.constFind(MetadataCache::hashPath(path.toUtf8()));
+
+    return (location != m_Index.constEnd() && location->size == size && location->mtime == mtime);
+}
+
+// ==============================
+// ==============================
+
+bool SeekIndexCache::find(const QString& path, qint64 size, qint64 mtime, SeekIndex& index)
+{
+    auto location = m_Index.constFind(MetadataCache::hashPath(path.toUtf8()));
+
+    if (location == m_Index.constEnd() || location->size != size || location->mtime != mtime || !m_File.seek(location->position))
+        return false;
+
+    QByteArray data = m_File.read(location->length);
+    if (data.size() != location->length)
+        return false;
+
+    const Record *record = reinterpret_cast<const Record*>(data.constData());
+    index = SeekIndex(record->sampleRate, reinterpret_cast<const SeekIndex::Entry*>(data.constData() + sizeof(Record)), record->count);
+
+    return true;
+}
+
+// ==============================
+// ==============================
+
+bool SeekIndexCache::insert(const QString& path, qint64 size, qint64 mtime, const SeekIndex& index)
+{
+    if (!m_File.isOpen())
+        return false;
+
+    const std::vector<SeekIndex::Entry>& entries = index.getEntries();
+
+    Record record;
+    record.pathHash = MetadataCache::hashPath(path.toUtf8());
+    record.size = size;
+    record.mtime = mtime;
+    record.sampleRate = index.getSampleRate();
+    record.count = entries.size();
+
+    const qint64 position = m_File.size();
+    const qint64 entriesSize = static_cast<qint64>(entries.size() * sizeof(SeekIndex::Entry));
+
+    /* Ajout en fin de fichier : l'enregistrement précédent n'est remplacé qu'une fois le nouveau écrit */
+    if (!m_File.seek(position)
+            || m_File.write(reinterpret_cast<const char*>(&record), sizeof(Record)) != sizeof(Record)
+            || m_File.write(reinterpret_cast<const char*>(entries.data()), entriesSize) != entriesSize)
+    {
+        m_File.resize(position);
+        return false;
+    }
+
+    m_File.flush();
+
+    auto previous = m_Index.constFind(record.pathHash);
+    if (previous != m_Index.constEnd())
+        m_UnusedSize += previous->length;
+
+    m_Index.insert(record.pathHash, { position, static_cast<qint64>(sizeof(Record)) + entriesSize, size, mtime });
+
+    return true;
+}
+
+
+} // audio
@@ -0,0 +1,126 @@
+/*************************************
+ * @file    SeekIndexCache.h
+ * @date    17/10/26
+ * @author  Manuel
+ *
+ * Déclarations de la classe SeekIndexCache
+ * conservant sur disque l'index de
+ * déplacement de chaque fichier.
+ *************************************
+*/
+
+#ifndef __SEEKINDEXCACHE_H__
+#define __SEEKINDEXCACHE_H__
+
+#include <QFile>
+#include <QHash>
+#include <QString>
+#include "SeekIndex.h"
+#include "../Constants.h"
+
+
+namespace audio {
+
+
+/**
+ * Format du fichier (little endian) :
+ *  - Header
+ *  - Record, suivi des count entrées de l'index (voir SeekIndex::Entry), pour chaque fichier indexé
+ * Les index étant de tailles différentes, ils sont toujours ajoutés en fin de fichier : un fichier
+ * réindexé laisse son ancien enregistrement inutilisé, et le cache est réécrit au chargement
+ * lorsque les enregistrements inutilisés occupent plus de la moitié du fichier.
+ * Seuls la position, la taille et la date de chaque enregistrement sont gardées en mémoire.
+ */
+class SeekIndexCache
+{
+    private:
+
+        struct Header
+        {
+            char magic[4];
+            quint32 version;
+        };
+
+        struct Record
+        {
+            quint64 pathHash;
+            qint64 size;
+            qint64 mtime;
+            quint32 sampleRate;
+            quint32 count;
+        };
+
+        struct Location
+        {
+            qint64 position;
+            qint64 length;              // Taille de l'enregistrement et de ses entrées
+            qint64 size;
+            qint64 mtime;
+        };
+
+        QString m_FilePath;
+
+        QFile m_File;
+
+        QHash<quint64, Location> m_Index;
+
+        // Taille des enregistrements remplacés par un enregistrement plus récent
+        qint64 m_UnusedSize;
+
+
+        /**
+         * @brief Vide le fichier et y écrit un header sans enregistrement.
+         * @return true si l'écriture a réussi
+         */
+        bool reset();
+
+        /**
+         * @brief Réécrit le fichier sans ses enregistrements inutilisés.
+         * @return true si la réécriture a réussi
+         */
+        bool compact();
+
+    public:
+
+        SeekIndexCache(const QString& filePath = SEEK_INDEX_CACHE_FILEPATH);
+
+        /**
+         * @brief Ouvre le fichier du cache (créé s'il n'existe pas) et lit son index.
+         * @return true si le cache est utilisable (un fichier invalide est vidé)
+         */
+        bool load();
+
+        /**
+         * @brief Détermine si le cache contient un index à jour pour le fichier, sans le lire.
+         * @param path Chemin canonique du fichier
+         * @param size Taille actuelle du fichier
+         * @param mtime Date de modification actuelle du fichier (ms)
+         * @return true si une entrée à jour (taille et date identiques) existe
+         */
+        bool contains(const QString& path, qint64 size, qint64 mtime) const;
+
+        /**
+         * @brief Cherche l'index de déplacement du fichier dans le cache.
+         * @param path Chemin canonique du fichier
+         * @param size Taille actuelle du fichier
+         * @param mtime Date de modification actuelle du fichier (ms)
+         * @param index Index trouvé (éventuellement vide : débit constant)
+         * @return true si une entrée à jour existe
+         */
+        bool find(const QString& path, qint64 size, qint64 mtime, SeekIndex& index);
+
+        /**
+         * @brief Ajoute l'index de déplacement du fichier au cache.
+         * @param path Chemin canonique du fichier
+         * @param size Taille du fichier
+         * @param mtime Date de modification du fichier (ms)
+         * @param index Index du fichier
+         * @return true si l'écriture a réussi
+         */
+        bool insert(const QString& path, qint64 size, qint64 mtime, const SeekIndex& index);
+};
+
+
+} // audio
+
+#endif  // __SEEKINDEXCACHE_H__
@@ -8,6 +8,7 @@
 */
 
 #include "Song.h"
+#include "SongProbe.h"
 #include <QFileInfo>
 #include <taglib/fileref.h>
 
@@ -16,16 +17,17 @@ namespace audio {
 
 
 Song::Song(Player::SongId id, const QString& file, bool inFolder, bool openable)
-    : m_Id(id), m_InFolder(inFolder), m_Available(true), m_File(file), m_SoundID(0), m_Artist("")
+    : m_Id(id), m_InFolder(inFolder), m_Available(true), m_Gain(1.0f), m_File(file), m_SoundID(0), m_Artist("")
 {
     if (openable)
     {
-        SoundID_t fmodId = FmodManager::getInstance().openFromFile(m_File.toStdString(), false);
-        m_Length = FmodManager::getInstance().getSoundLength(fmodId);
+        SongMetadata metadata = readMetadata(m_File);
+        if (!metadata.valid)
+            throw metadata.error;
 
-        readTags();
-
-        FmodManager::getInstance().releaseSound(fmodId);
+        m_Title = metadata.title;
+        m_Artist = metadata.artist;
+        m_Length = metadata.length;
     }
     else
         m_Title = m_File;
@@ -34,6 +36,59 @@ Song::Song(Player::SongId id, const QString& file, bool inFolder, bool openable)
 // ==============================
 // ==============================
 
+Song::Song(Player::SongId id, const QString& file, const SongMetadata& metadata, bool inFolder)
+    : m_Id(id), m_Title(metadata.title), m_InFolder(inFolder), m_Available(true), m_Gain(1.0f),
+      m_File(file), m_Length(metadata.length), m_SoundID(0), m_Artist(metadata.artist)
+{
+    if (!metadata.valid)
+        throw metadata.error;
+}
+
+// ==============================
+// ==============================
+
+SongMetadata Song::readMetadata(const QString& file)
+{
+    SongMetadata metadata;
+
+    /* Lecture des en-têtes, FMOD et TagLib ne sont utilisés que pour les formats non gérés */
+    SongProbe::Result result = SongProbe::probe(file, metadata);
+
+    if (result == SongProbe::Result::REJECTED)
+    {
+        metadata.error = FmodManager::StreamError::FORMAT_ERROR;
+        return metadata;
+    }
+
+    try
+    {
+        if (result == SongProbe::Result::UNSUPPORTED)
+        {
+            metadata.length = FmodManager::getInstance().getFileLength(file.toStdString(), &metadata.format);
+            readTags(file, metadata);
+        }
+        else if (result == SongProbe::Result::UNREAD_TAGS)
+            readTags(file, metadata);
+
+        if (metadata.title.isEmpty())
+            metadata.title = QFileInfo(file).completeBaseName();
+
+        if (metadata.artist.isEmpty())
+            metadata.artist = "Artiste inconnu";
+
+        metadata.valid = true;
+    }
+    catch (FmodManager::StreamError error)
+    {
+        metadata.error = error;
+    }
+
+    return metadata;
+}
+
+// ==============================
+// ==============================
+
 SoundID_t Song::getSoundID() const
 {
     return m_SoundID;
@@ -114,40 +169,36 @@ const QString& Song::getArtist() const
 // ==============================
 // ==============================
 
-void Song::readTags()
+void Song::readTags(const QString& file, SongMetadata& metadata)
 {
-    TagLib::FileRef file(m_File.toStdString().c_str());
+    TagLib::FileRef fileRef(file.toStdString().c_str());
 
-    if (!file.isNull() && file.tag())
+    if (!fileRef.isNull() && fileRef.tag())
     {
-        TagLib::Tag *tag = file.tag();
+        TagLib::Tag *tag = fileRef.tag();
 
-        m_Title = QString::fromStdWString(tag->title().toWString());
-        m_Artist = QString::fromStdWString(tag->artist().toWString());
+        metadata.title = QString::fromStdWString(tag->title().toWString());
+        metadata.artist = QString::fromStdWString(tag->artist().toWString());
     }
+}
 
-    if (m_Title.isEmpty())
-    {
-        QFileInfo fileInfo(getFile());
-        m_Title = fileInfo.completeBaseName();
-    }
+// ==============================
+// ==============================
 
-    if (m_Artist.isEmpty())
-        m_Artist = "Artiste inconnu";
+unsigned long long Song::requestPicture(AudioThread& audio) const
+{
+    return audio.requestPicture(m_SoundID);
 }
 
 // ==============================
 // ==============================
 
-QPixmap Song::buildPicture() const
+QPixmap Song::buildPicture(const QByteArray& data)
 {
-    unsigned int pictureDataLength(0);
-    char *pictureData = FmodManager::getInstance().getSongPictureData(m_SoundID, &pictureDataLength);
-
     QPixmap pixmap;
 
-    if (pictureData)
-        pixmap.loadFromData(reinterpret_cast<uchar*>(pictureData), pictureDataLength);
+    if (!data.isEmpty())
+        pixmap.loadFromData(reinterpret_cast<const uchar*>(data.constData()), data.size());
 
     return pixmap;
 }
@@ -155,68 +206,100 @@ QPixmap Song::buildPicture() const
 // ==============================
 // ==============================
 
-void Song::open()
+void Song::setGain(float gain)
+{
+    m_Gain = gain;
+}
+
+// ==============================
+// ==============================
+
+void Song::setSeekIndex(std::shared_ptr<const SeekIndex> index)
+{
+    m_SeekIndex = index;
+}
+
+// ==============================
+// ==============================
+
+void Song::open(AudioThread& audio, bool mainCanal)
+{
+    m_SoundID = audio.openFromFile(m_File.toStdString(), mainCanal ? VoiceRole::MAIN : VoiceRole::NEXT, nullptr, m_SeekIndex);
+}
+
+// ==============================
+// ==============================
+
+bool Song::isReady(const AudioThread& audio) const
+{
+    return audio.isSoundReady(m_SoundID);
+}
+
+// ==============================
+// ==============================
+
+void Song::release(AudioThread& audio) const
 {
-    m_SoundID = FmodManager::getInstance().openFromFile(m_File.toStdString());
+    audio.releaseSound(m_SoundID);
 }
 
 // ==============================
 // ==============================
 
-void Song::addDSP(unsigned int size) const
+void Song::play(AudioThread& audio, bool paused) const
 {
-    FmodManager::getInstance().addDSP(m_SoundID, size);
+    audio.playSound(m_SoundID, m_Gain, paused);
 }
 
 // ==============================
 // ==============================
 
-void Song::play() const
+void Song::playAfter(AudioThread& audio, const Song& previous, SoundPos_t overlap, FadeCurve curve) const
 {
-    FmodManager::getInstance().playSound(m_SoundID);
+    audio.playSoundAfter(m_SoundID, previous.m_SoundID, overlap, curve, m_Gain);
 }
 
 // ==============================
 // ==============================
 
-void Song::pause(bool paused) const
+void Song::pause(AudioThread& audio, bool paused) const
 {
-    FmodManager::getInstance().pauseSound(m_SoundID, paused);
+    audio.pauseSound(m_SoundID, paused);
 }
 
 // ==============================
 // ==============================
 
-void Song::stop() const
+void Song::stop(AudioThread& audio) const
 {
-    FmodManager::getInstance().stopSound(m_SoundID);
+    audio.stopSound(m_SoundID);
 }
 
 // ==============================
 // ==============================
 
-SoundPos_t Song::getPosition() const
+SoundPos_t Song::getPosition(const AudioThread& audio) const
 {
-    return FmodManager::getInstance().getSoundPosition(m_SoundID);
+    return audio.getSoundPosition(m_SoundID);
 }
 
 // ==============================
 // ==============================
 
-void Song::setPosition(SoundPos_t pos) const
+void Song::setPosition(AudioThread& audio, SoundPos_t pos) const
 {
     if (pos >= m_Length)
         pos = m_Length - 1;
 
-    FmodManager::getInstance().setSoundPosition(m_SoundID, pos);
+    audio.setSoundPosition(m_SoundID, pos);
 }
 
 // ==============================
 // ==============================
 
-bool Song::isFinished() const
+bool Song::isFinished(const AudioThread& audio) const
 {
-    return !(getPosition() < getLength());
+    return !(getPosition(audio) < getLength());
 }
 
 
@@ -14,6 +14,7 @@
 #include <QString>
 #include "FmodManager.h"
 #include "Player.h"
+#include "SongMetadata.h"
 #include <QPixmap>
 
 
@@ -32,6 +33,12 @@ class Song
 
         bool m_Available;
 
+        // Gain de normalisation appliqué au canal à chaque lecture (voir SongAnalyzer)
+        float m_Gain;
+
+        // Index de déplacement du fichier, chargé par le Player avant l'ouverture (voir SeekIndex)
+        std::shared_ptr<const SeekIndex> m_SeekIndex;
+
 
         /**
          * @brief Modifie la disponibilité de la musique.
@@ -40,13 +47,16 @@ class Song
         void setAvailable(bool value);
 
         /**
-         * @brief Remplit les champs de la musique à partir des tags.
+         * @brief Remplit les champs titre et artiste à partir des tags du fichier (TagLib).
+         * @param file Fichier à lire
+         * @param metadata Informations à compléter
          */
-        void readTags();
+        static void readTags(const QString& file, SongMetadata& metadata);
 
     protected:
 
         friend class Player;
+        friend class SongStore;
 
         QString m_File;
 
@@ -58,10 +68,27 @@ class Song
 
         Song(Player::SongId id, const QString& file = "", bool inFolder = true, bool openable = true);
 
+        /**
+         * @brief Construit la musique à partir d'informations déjà lues.
+         * @param id Identifiant de la musique
+         * @param file Chemin du fichier
+         * @param metadata Informations du fichier (exception StreamError si invalides)
+         * @param inFolder Présence du son dans le dossier ou non
+         */
+        Song(Player::SongId id, const QString& file, const SongMetadata& metadata, bool inFolder = true);
+
     public:
 
         virtual ~Song() = default;
 
+        /**
+         * @brief Lit la durée et les tags du fichier passé en paramètre.
+         *        Ne dépend d'aucun canal FMOD et peut donc être appelée depuis un thread de chargement.
+         * @param file Fichier à lire
+         * @return Informations lues (invalides si le fichier n'a pas pu être ouvert)
+         */
+        static SongMetadata readMetadata(const QString& file);
+
         SoundID_t getSoundID() const;
         Player::SongId getId() const;
         const QString& getFile() const;
@@ -98,55 +125,100 @@ class Song
         const QString& getArtist() const;
 
         /**
-         * @brief Construit l'image de la pochette du son depuis le fichier.
+         * @brief Demande au thread audio la pochette du son ouvert (voir AudioThread::pictureRead).
+         * @param audio Thread audio
+         * @return Numéro de la demande
+         */
+        unsigned long long requestPicture(AudioThread& audio) const;
+
+        /**
+         * @brief Construit l'image de la pochette à partir des données lues dans les tags.
+         * @param data Données de l'image
          * @return Image associée au fichier, image vide sinon
          */
-        QPixmap buildPicture() const;
+        static QPixmap buildPicture(const QByteArray& data);
 
         /**
-         * @brief Ouvre le fichier avec FMOD pour stream.
+         * @brief Modifie le gain de normalisation, appliqué à la prochaine lecture.
+         * @param gain Gain linéaire (1 : aucun)
          */
-        virtual void open();
+        void setGain(float gain);
 
         /**
-         * @brief Ajoute un DSP sur le son.
-         * @param size Taille des données spectrales à récupérer
+         * @brief Modifie l'index de déplacement du fichier, utilisé à la prochaine ouverture.
+         * @param index Index du fichier (nullptr : déplacements calculés par FMOD)
          */
-        void addDSP(unsigned int size) const;
+        void setSeekIndex(std::shared_ptr<const SeekIndex> index);
+
+        /**
+         * @brief Lance l'ouverture du fichier par le thread audio pour stream, sans attendre sa fin (voir isReady).
+         * @param audio Thread audio exécutant l'ouverture
+         * @param mainCanal true pour ouvrir le son sur le canal principal, false sur le canal de la musique suivante
+         */
+        virtual void open(AudioThread& audio, bool mainCanal = true);
+
+        /**
+         * @brief Détermine si l'ouverture du fichier est terminée (dernier état publié par le thread audio).
+         * @param audio Thread audio exécutant l'ouverture
+         * @return true si le son peut être joué (exception StreamError si l'ouverture a échoué)
+         */
+        bool isReady(const AudioThread& audio) const;
+
+        /**
+         * @brief Libère le son ouvert avec FMOD.
+         * @param audio Thread audio exécutant la commande
+         */
+        void release(AudioThread& audio) const;
 
         /**
          * @brief Joue le son ouvert avec FMOD.
+         * @param audio Thread audio exécutant la commande
+         * @param paused true pour créer le canal en pause
+         */
+        void play(AudioThread& audio, bool paused = false) const;
+
+        /**
+         * @brief Joue le son ouvert avec FMOD dès la fin de la musique passée en paramètre.
+         * @param audio Thread audio exécutant la commande
+         * @param previous Musique en cours de lecture
+         * @param overlap Durée du fondu enchaîné avec la musique précédente (ms, 0 : aucun)
+         * @param curve Courbe du fondu enchaîné
          */
-        void play() const;
+        void playAfter(AudioThread& audio, const Song& previous, SoundPos_t overlap = 0, FadeCurve curve = FadeCurve::EQUAL_POWER) const;
 
         /**
          * @brief Met le son en pause ou le redémarre.
+         * @param audio Thread audio exécutant la commande
          * @param paused Etat pause à mettre
          */
-        void pause(bool paused) const;
+        void pause(AudioThread& audio, bool paused) const;
 
         /**
          * @brief Stoppe le son.
+         * @param audio Thread audio exécutant la commande
          */
-        void stop() const;
+        void stop(AudioThread& audio) const;
 
         /**
          * @brief getPosition
+         * @param audio Thread audio publiant la position
          * @return Position de la musique (ms)
          */
-        SoundPos_t getPosition() const;
+        SoundPos_t getPosition(const AudioThread& audio) const;
 
         /**
          * @brief Modifie la position de la musique.
+         * @param audio Thread audio exécutant la commande
          * @param pos Nouvelle position en ms
          */
-        void setPosition(SoundPos_t pos) const;
+        void setPosition(AudioThread& audio, SoundPos_t pos) const;
 
         /**
          * @brief isFinished
+         * @param audio Thread audio publiant la position
          * @return true si la musique est terminée.
          */
-        bool isFinished() const;
+        bool isFinished(const AudioThread& audio) const;
 };
 
 
@@ -0,0 +1,208 @@
+/*************************************
+ * @file    SongAnalyzer.cpp
+ * @date    17/10/26
+ * @author  Manuel
+ *
+ * Définitions de la classe SongAnalyzer.
+ *************************************
+*/
+
+#include "SongAnalyzer.h"
+#include "LoudnessMeter.h"
+#include "WaveformBuilder.h"
+#include "SeekIndex.h"
+#include "FmodManager.h"
+#include <QMutexLocker>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+
+namespace audio {
+
+
+SongAnalyzer::SongAnalyzer(QObject *parent)
+    : QThread(parent), m_Throttled(false)
+{
+
+}
+
+// ==============================
+// ==============================
+
+SongAnalyzer::~SongAnalyzer()
+{
+    stop();
+}
+
+// ==============================
+// ==============================
+
+void SongAnalyzer::stop()
+{
+    {
+        QMutexLocker locker(&m_Mutex);
+        requestInterruption();
+        m_Condition.wakeAll();
+    }
+
+    wait();
+}
+
+// ==============================
+// ==============================
+
+void SongAnalyzer::analyze(const QString& file, int analyses, bool urgent)
+{
+    QMutexLocker locker(&m_Mutex);
+
+    for (int i = 0; i < m_Queue.size(); ++i)
+    {
+        if (m_Queue[i].file == file)
+        {
+            m_Queue[i].analyses |= analyses;
+
+            if (urgent)
+                m_Queue.move(i, 0);
+
+            return;
+        }
+    }
+
+    if (urgent)
+        m_Queue.prepend({ file, analyses });
+    else
+        m_Queue.append({ file, analyses });
+
+    m_Condition.wakeOne();
+}
+
+// ==============================
+// ==============================
+
+void SongAnalyzer::setThrottled(bool throttled)
+{
+    m_Throttled = throttled;
+}
+
+// ==============================
+// ==============================
+
+bool SongAnalyzer::waitTurn()
+{
+    while (m_Throttled && !isInterruptionRequested())
+        msleep(LOUDNESS_THROTTLE_TIME);
+
+    if (isInterruptionRequested())
+        return false;
+
+    // Laisse le disque et le processeur aux lectures en cours
+    msleep(LOUDNESS_IDLE_TIME);
+
+    return true;
+}
+
+// ==============================
+// ==============================
+
+void SongAnalyzer::run()
+{
+    while (!isInterruptionRequested())
+    {
+        Request request;
+
+        {
+            QMutexLocker locker(&m_Mutex);
+
+            while (m_Queue.isEmpty() && !isInterruptionRequested())
+                m_Condition.wait(&m_Mutex);
+
+            if (isInterruptionRequested())
+                break;
+
+            request = m_Queue.takeFirst();
+        }
+
+        if (waitTurn())
+            analyzeFile(request);
+    }
+}
+
+// ==============================
+// ==============================
+
+void SongAnalyzer::analyzeFile(const Request& request)
+{
+    if (request.analyses & SEEK_INDEX)
+    {
+        SeekIndex index = SeekIndex::build(request.file.toStdString());
+        const std::vector<SeekIndex::Entry>& entries = index.getEntries();
+
+        emit seekIndexAnalyzed(request.file, index.getSampleRate(),
+                               QByteArray(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(SeekIndex::Entry)));
+    }
+
+    // Aucun décodage pour le seul index de déplacement
+    if (!(request.analyses & (LOUDNESS | WAVEFORM)))
+        return;
+
+    std::unique_ptr<LoudnessMeter> meter;
+    std::unique_ptr<WaveformBuilder> waveform;
+
+    try
+    {
+        bool complete = FmodManager::getInstance().decodeFile(request.file.toStdString(),
+            [this, &request, &meter, &waveform](const float *samples, unsigned int frames, int channels, int sampleRate) {
+                if ((request.analyses & LOUDNESS) && !meter)
+                    meter = std::make_unique<LoudnessMeter>(channels, sampleRate);
+
+                if ((request.analyses & WAVEFORM) && !waveform)
+                    waveform = std::make_unique<WaveformBuilder>(sampleRate);
+
+                if (meter)
+                    meter->process(samples, frames);
+
+                if (waveform)
+                    waveform->process(samples, frames, channels);
+
+                return waitTurn();
+            });
+
+        if (!complete)
+            return;
+    }
+    catch (FmodManager::StreamError error)
+    {
+        return;
+    }
+
+    if (meter)
+        emit loudnessAnalyzed(request.file, meter->getIntegratedLoudness(), meter->getTruePeak());
+
+    if (waveform)
+    {
+        std::vector<WaveformPoint> points = waveform->finish(WAVEFORM_RESOLUTION);
+
+        if (!points.empty())
+            emit waveformAnalyzed(request.file, QByteArray(reinterpret_cast<const char*>(points.data()), points.size() * sizeof(WaveformPoint)));
+    }
+}
+
+// ==============================
+// ==============================
+
+float SongAnalyzer::getGain(const LoudnessInfo& info)
+{
+    if (!std::isfinite(info.loudness))
+        return 1.0f;
+
+    float gain = std::min(LOUDNESS_TARGET - info.loudness, LOUDNESS_MAX_GAIN);
+
+    if (std::isfinite(info.truePeak))
+        gain = std::min(gain, LOUDNESS_MAX_TRUE_PEAK - info.truePeak);
+
+    return std::pow(10.0f, gain / 20.0f);
+}
+
+
+} // audio
@@ -0,0 +1,138 @@
+/*************************************
+ * @file    SongAnalyzer.h
+ * @date    17/10/26
+ * @author  Manuel
+ *
+ * Déclarations de la classe SongAnalyzer
+ * analysant en arrière-plan les fichiers
+ * de musique (loudness, forme d'onde,
+ * index de déplacement).
+ *************************************
+*/
+
+#ifndef __SONGANALYZER_H__
+#define __SONGANALYZER_H__
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QByteArray>
+#include <QList>
+#include <atomic>
+
+#include "LoudnessCache.h"
+#include "../Constants.h"
+
+
+namespace audio {
+
+
+/**
+ * Le thread d'analyse décode les fichiers en attente plus vite que le temps réel
+ * (FmodManager::decodeFile, sans canal) et calcule en un seul décodage les analyses
+ * demandées pour chacun : loudness (LoudnessMeter) et forme d'onde (WaveformBuilder).
+ * L'index de déplacement (SeekIndex) est construit à partir des en-têtes des trames, sans décodage.
+ * Il tourne en priorité minimale, s'interrompt brièvement entre deux blocs décodés
+ * et attend entre deux blocs tant que la lecture est prioritaire (voir setThrottled).
+ */
+class SongAnalyzer : public QThread
+{
+    Q_OBJECT
+
+    public:
+
+        enum Analysis { LOUDNESS = 1, WAVEFORM = 2, SEEK_INDEX = 4 };
+
+    private:
+
+        struct Request
+        {
+            QString file;
+            int analyses;
+        };
+
+        QMutex m_Mutex;
+        QWaitCondition m_Condition;
+        QList<Request> m_Queue;
+
+        std::atomic<bool> m_Throttled;
+
+
+        /**
+         * @brief Attend que l'analyse puisse continuer (entre deux blocs décodés).
+         * @return false si le thread doit s'arrêter
+         */
+        bool waitTurn();
+
+        /**
+         * @brief Décode le fichier de la demande et émet le résultat de chaque analyse demandée.
+         * @param request Fichier et analyses à calculer
+         */
+        void analyzeFile(const Request& request);
+
+    protected:
+
+        void run() override;
+
+    public:
+
+        SongAnalyzer(QObject *parent = nullptr);
+        virtual ~SongAnalyzer();
+
+        /**
+         * @brief Arrête le thread (l'analyse en cours est abandonnée).
+         */
+        void stop();
+
+        /**
+         * @brief Ajoute le fichier aux analyses en attente (les analyses d'un fichier déjà en attente sont regroupées).
+         * @param file Chemin canonique du fichier
+         * @param analyses Analyses à calculer (combinaison de Analysis)
+         * @param urgent true pour analyser le fichier avant les autres fichiers en attente
+         */
+        void analyze(const QString& file, int analyses, bool urgent = false);
+
+        /**
+         * @brief Suspend ou reprend l'analyse, entre deux blocs décodés.
+         * @param throttled true tant que la lecture ne doit pas être concurrencée
+         */
+        void setThrottled(bool throttled);
+
+        /**
+         * @brief Calcule le gain ramenant la loudness à LOUDNESS_TARGET, limité par LOUDNESS_MAX_GAIN
+         *        et par le true peak (LOUDNESS_MAX_TRUE_PEAK après gain).
+         * @param info Loudness du fichier
+         * @return Gain linéaire (1 pour un silence)
+         */
+        static float getGain(const LoudnessInfo& info);
+
+    signals:
+
+        /**
+         * @brief Emis depuis le thread d'analyse lorsque la loudness d'un fichier a été mesurée.
+         * @param file Chemin du fichier
+         * @param loudness Loudness intégrée (LUFS)
+         * @param truePeak True peak (dBTP)
+         */
+        void loudnessAnalyzed(const QString& file, float loudness, float truePeak);
+
+        /**
+         * @brief Emis depuis le thread d'analyse lorsque la forme d'onde d'un fichier a été calculée.
+         * @param file Chemin du fichier
+         * @param peaks Forme d'onde (WAVEFORM_RESOLUTION WaveformPoint)
+         */
+        void waveformAnalyzed(const QString& file, const QByteArray& peaks);
+
+        /**
+         * @brief Emis depuis le thread d'analyse lorsque l'index de déplacement d'un fichier a été construit.
+         * @param file Chemin du fichier
+         * @param sampleRate Fréquence d'échantillonnage du fichier (voir SeekIndex)
+         * @param entries Entrées de l'index (SeekIndex::Entry, aucune pour un fichier à débit constant)
+         */
+        void seekIndexAnalyzed(const QString& file, quint32 sampleRate, const QByteArray& entries);
+};
+
+
+} // audio
+
+#endif  // __SONGANALYZER_H__
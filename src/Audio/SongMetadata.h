@@ -0,0 +1,37 @@
+/*************************************
+ * @file    SongMetadata.h
+ * @date    17/10/26
+ * @author  Manuel
+ *
+ * Déclarations de la structure SongMetadata
+ * contenant les informations lues dans
+ * un fichier de musique.
+ *************************************
+*/
+
+#ifndef __SONGMETADATA_H__
+#define __SONGMETADATA_H__
+
+#include <QString>
+#include "FmodManager.h"
+
+
+namespace audio {
+
+
+struct SongMetadata
+{
+    QString title;
+    QString artist;
+    SoundPos_t length = 0;
+    FMOD_SOUND_TYPE format = FMOD_SOUND_TYPE_UNKNOWN;
+
+    // false si le fichier n'a pas pu être lu (error indique alors la cause)
+    bool valid = false;
+    FmodManager::StreamError error = FmodManager::StreamError::FILE_ERROR;
+};
+
+
+} // audio
+
+#endif  // __SONGMETADATA_H__
@@ -0,0 +1,662 @@
+/*************************************
+ * @file    SongProbe.cpp
+ * @date    17/10/26
+ * @author  Manuel
+ *
+ * Définitions de la classe SongProbe.
+ *************************************
+*/
+
+#include "SongProbe.h"
+#include <algorithm>
+#include <cstring>
+
+
+namespace audio {
+
+
+namespace {
+
+constexpr int HEAD_SIZE         = 4096;
+constexpr int MPEG_SEARCH_SIZE  = 16384;
+constexpr int OGG_HEAD_SIZE     = 65536;
+constexpr int OGG_TAIL_SIZE     = 65536;
+constexpr int MAX_TAG_FRAME     = 4096;     // Taille max d'une frame de texte lue
+
+inline quint32 readBE32(const char *p)
+{
+    const uchar *u = reinterpret_cast<const uchar*>(p);
+    return (quint32(u[0]) << 24) | (quint32(u[1]) << 16) | (quint32(u[2]) << 8) | u[3];
+}
+
+inline quint32 readBE24(const char *p)
+{
+    const uchar *u = reinterpret_cast<const uchar*>(p);
+    return (quint32(u[0]) << 16) | (quint32(u[1]) << 8) | u[2];
+}
+
+inline quint32 readLE32(const char *p)
+{
+    const uchar *u = reinterpret_cast<const uchar*>(p);
+    return (quint32(u[3]) << 24) | (quint32(u[2]) << 16) | (quint32(u[1]) << 8) | u[0];
+}
+
+inline quint64 readLE64(const char *p)
+{
+    return (quint64(readLE32(p + 4)) << 32) | readLE32(p);
+}
+
+inline quint32 readSyncSafe(const char *p)
+{
+    const uchar *u = reinterpret_cast<const uchar*>(p);
+    return ((u[0] & 0x7F) << 21) | ((u[1] & 0x7F) << 14) | ((u[2] & 0x7F) << 7) | (u[3] & 0x7F);
+}
+
+// ==============================
+// ==============================
+
+struct MpegHeader
+{
+    unsigned int bitrate;           // kbit/s
+    unsigned int sampleRate;
+    unsigned int samplesPerFrame;
+    unsigned int frameLength;       // octets
+    unsigned int sideInfoSize;
+};
+
+bool parseMpegHeader(const char *p, MpegHeader& header)
+{
+    static const unsigned short BITRATES[2][3][15] = {
+        { { 0, 32, 64, 96, 128, 160, 192, 224, 256, 288, 320, 352, 384, 416, 448 },      // MPEG1 L1
+          { 0, 32, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384 },         // MPEG1 L2
+          { 0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320 } },        // MPEG1 L3
+        { { 0, 32, 48, 56, 64, 80, 96, 112, 128, 144, 160, 176, 192, 224, 256 },         // MPEG2/2.5 L1
+          { 0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160 },              // MPEG2/2.5 L2
+          { 0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160 } }             // MPEG2/2.5 L3
+    };
+    static const unsigned int SAMPLE_RATES[3] = { 44100, 48000, 32000 };
+
+    const uchar *u = reinterpret_cast<const uchar*>(p);
+
+    if (u[0] != 0xFF || (u[1] & 0xE0) != 0xE0)
+        return false;
+
+    unsigned int version = (u[1] >> 3) & 0x03;         // 0 : MPEG2.5, 2 : MPEG2, 3 : MPEG1
+    unsigned int layer = 4 - ((u[1] >> 1) & 0x03);      // 4 : réservé
+    unsigned int bitrateIndex = u[2] >> 4;
+    unsigned int sampleRateIndex = (u[2] >> 2) & 0x03;
+    unsigned int padding = (u[2] >> 1) & 0x01;
+    bool mono = ((u[3] >> 6) == 3);
+
+    if (version == 1 || layer == 4 || bitrateIndex == 0 || bitrateIndex == 15 || sampleRateIndex == 3)
+        return false;
+
+    bool mpeg1 = (version == 3);
+
+    header.bitrate = BITRATES[mpeg1 ? 0 : 1][layer - 1][bitrateIndex];
+    header.sampleRate = SAMPLE_RATES[sampleRateIndex] >> (mpeg1 ? 0 : (version == 2 ? 1 : 2));
+
+    if (layer == 1)
+        header.samplesPerFrame = 384;
+    else if (layer == 2 || mpeg1)
+        header.samplesPerFrame = 1152;
+    else
+        header.samplesPerFrame = 576;
+
+    if (layer == 1)
+        header.frameLength = (12000 * header.bitrate / header.sampleRate + padding) * 4;
+    else
+        header.frameLength = (header.samplesPerFrame / 8) * 1000 * header.bitrate / header.sampleRate + padding;
+
+    if (layer != 3)
+        header.sideInfoSize = 0;
+    else if (mpeg1)
+        header.sideInfoSize = mono ? 17 : 32;
+    else
+        header.sideInfoSize = mono ? 9 : 17;
+
+    return header.frameLength > 4;
+}
+
+// ==============================
+// ==============================
+
+QString decodeId3Text(const char *data, int size)
+{
+    if (size < 1)
+        return QString();
+
+    char encoding = data[0];
+    ++data;
+    --size;
+
+    QString text;
+
+    if (encoding == 0)
+        text = QString::fromLatin1(data, qstrnlen(data, size));
+    else if (encoding == 3)
+        text = QString::fromUtf8(data, qstrnlen(data, size));
+    else
+    {
+        bool bigEndian = (encoding == 2);
+
+        if (encoding == 1 && size >= 2)
+        {
+            bigEndian = (static_cast<uchar>(data[0]) == 0xFE && static_cast<uchar>(data[1]) == 0xFF);
+            data += 2;
+            size -= 2;
+        }
+
+        for (int i = 0; i + 1 < size; i += 2)
+        {
+            ushort c = bigEndian ? ushort((uchar(data[i]) << 8) | uchar(data[i + 1]))
+                                 : ushort((uchar(data[i + 1]) << 8) | uchar(data[i]));
+            if (c == 0)
+                break;
+
+            text.append(QChar(c));
+        }
+    }
+
+    return text.trimmed();
+}
+
+}
+
+// ==============================
+// ==============================
+
+bool SongProbe::isNonAudio(const QByteArray& head)
+{
+    static const char *MAGICS[] = { "\xFF\xD8\xFF", "\x89PNG", "GIF8", "%PDF", "PK\x03\x04", "BM" };
+
+    for (const char *magic : MAGICS)
+    {
+        if (head.startsWith(magic))
+            return true;
+    }
+
+    /* Fichier texte : aucun octet de contrôle hors espaces */
+    if (head.isEmpty())
+        return true;
+
+    for (char c : head)
+    {
+        uchar u = static_cast<uchar>(c);
+        if (u < 0x20 && u != '\n' && u != '\r' && u != '\t')
+            return false;
+    }
+
+    return true;
+}
+
+// ==============================
+// ==============================
+
+qint64 SongProbe::readId3v2(QFile& file, SongMetadata& metadata)
+{
+    file.seek(0);
+    QByteArray header = file.read(10);
+
+    if (header.size() < 10 || !header.startsWith("ID3"))
+        return 0;
+
+    int majorVersion = header.at(3);
+    char flags = header.at(5);
+    qint64 tagEnd = 10 + readSyncSafe(header.constData() + 6) + ((flags & 0x10) ? 10 : 0);
+
+    if (majorVersion < 2 || majorVersion > 4 || (flags & 0x80))       // Désynchronisation non gérée
+        return tagEnd;
+
+    qint64 pos = 10;
+    const int frameHeaderSize = (majorVersion == 2) ? 6 : 10;
+
+    /* En-tête étendu */
+    if (majorVersion >= 3 && (flags & 0x40))
+    {
+        file.seek(pos);
+        QByteArray extSize = file.read(4);
+        if (extSize.size() < 4)
+            return tagEnd;
+
+        pos += (majorVersion == 4) ? readSyncSafe(extSize.constData()) : readBE32(extSize.constData()) + 4;
+    }
+
+    while (pos + frameHeaderSize <= tagEnd && (metadata.title.isEmpty() || metadata.artist.isEmpty()))
+    {
+        file.seek(pos);
+        QByteArray frameHeader = file.read(frameHeaderSize);
+        if (frameHeader.size() < frameHeaderSize || frameHeader.at(0) == '\0')
+            break;                                                      // Padding
+
+        QByteArray id;
+        quint32 size;
+        bool readable = true;
+
+        if (majorVersion == 2)
+        {
+            id = frameHeader.left(3);
+            size = readBE24(frameHeader.constData() + 3);
+        }
+        else
+        {
+            id = frameHeader.left(4);
+            size = (majorVersion == 4) ? readSyncSafe(frameHeader.constData() + 4) : readBE32(frameHeader.constData() + 4);
+            readable = !(frameHeader.at(9) & ((majorVersion == 4) ? 0x0E : 0xC0));    // Compression/chiffrement
+        }
+
+        pos += frameHeaderSize;
+
+        if (readable && size <= static_cast<quint32>(MAX_TAG_FRAME))
+        {
+            QString *field = nullptr;
+
+            if (id == "TIT2" || id == "TT2")
+                field = &metadata.title;
+            else if (id == "TPE1" || id == "TP1")
+                field = &metadata.artist;
+
+            if (field && field->isEmpty())
+            {
+                QByteArray content = file.read(size);
+                *field = decodeId3Text(content.constData(), content.size());
+            }
+        }
+
+        pos += size;
+    }
+
+    return tagEnd;
+}
+
+// ==============================
+// ==============================
+
+qint64 SongProbe::readId3v1(QFile& file, SongMetadata& metadata)
+{
+    qint64 fileSize = file.size();
+    if (fileSize < 128)
+        return fileSize;
+
+    file.seek(fileSize - 128);
+    QByteArray tag = file.read(128);
+
+    if (tag.size() < 128 || !tag.startsWith("TAG"))
+        return fileSize;
+
+    if (metadata.title.isEmpty())
+        metadata.title = QString::fromLatin1(tag.constData() + 3, qstrnlen(tag.constData() + 3, 30)).trimmed();
+
+    if (metadata.artist.isEmpty())
+        metadata.artist = QString::fromLatin1(tag.constData() + 33, qstrnlen(tag.constData() + 33, 30)).trimmed();
+
+    return fileSize - 128;
+}
+
+// ==============================
+// ==============================
+
+void SongProbe::readVorbisComments(const char *data, int size, SongMetadata& metadata)
+{
+    if (size < 8)
+        return;
+
+    quint32 vendorLength = readLE32(data);
+    if (vendorLength > static_cast<quint32>(size - 8))
+        return;
+
+    int pos = 4 + vendorLength;
+    quint32 count = readLE32(data + pos);
+    pos += 4;
+
+    for (quint32 i = 0; i < count && pos + 4 <= size; ++i)
+    {
+        quint32 length = readLE32(data + pos);
+        pos += 4;
+
+        if (length > static_cast<quint32>(size - pos))
+            return;
+
+        QByteArray comment = QByteArray::fromRawData(data + pos, length);
+        int separator = comment.indexOf('=');
+
+        if (separator > 0)
+        {
+            QByteArray key = comment.left(separator).toUpper();
+
+            if (key == "TITLE" && metadata.title.isEmpty())
+                metadata.title = QString::fromUtf8(comment.mid(separator + 1)).trimmed();
+            else if (key == "ARTIST" && metadata.artist.isEmpty())
+                metadata.artist = QString::fromUtf8(comment.mid(separator + 1)).trimmed();
+        }
+
+        pos += length;
+    }
+}
+
+// ==============================
+// ==============================
+
+SongProbe::Result SongProbe::probeMpeg(QFile& file, SongMetadata& metadata)
+{
+    qint64 audioStart = readId3v2(file, metadata);
+    qint64 audioEnd = readId3v1(file, metadata);
+
+    file.seek(audioStart);
+    QByteArray data = file.read(MPEG_SEARCH_SIZE);
+
+    /* Recherche de la première frame (confirmée par la suivante) */
+    MpegHeader header;
+    int framePos = -1;
+
+    for (int i = 0; i + 4 <= data.size(); ++i)
+    {
+        if (!parseMpegHeader(data.constData() + i, header))
+            continue;
+
+        MpegHeader nextHeader;
+        int nextPos = i + header.frameLength;
+
+        if (nextPos + 4 > data.size() || parseMpegHeader(data.constData() + nextPos, nextHeader))
+        {
+            framePos = i;
+            break;
+        }
+    }
+
+    if (framePos < 0)
+        return Result::UNSUPPORTED;
+
+    const char *frame = data.constData() + framePos;
+    int frameAvailable = data.size() - framePos;
+    quint64 samples = 0;
+
+    /* En-tête Xing/Info (et délais d'encodage LAME) */
+    int xingPos = 4 + header.sideInfoSize;
+    if (header.sideInfoSize && xingPos + 8 <= frameAvailable
+            && (std::memcmp(frame + xingPos, "Xing", 4) == 0 || std::memcmp(frame + xingPos, "Info", 4) == 0))
+    {
+        quint32 flags = readBE32(frame + xingPos + 4);
+
+        if ((flags & 0x01) && xingPos + 12 <= frameAvailable)
+        {
+            samples = static_cast<quint64>(readBE32(frame + xingPos + 8)) * header.samplesPerFrame;
+
+            int lamePos = xingPos + 120;
+            if ((flags & 0x0F) == 0x0F && lamePos + 24 <= frameAvailable
+                    && (std::memcmp(frame + lamePos, "LAME", 4) == 0 || std::memcmp(frame + lamePos, "Lav", 3) == 0))
+            {
+                quint32 delays = readBE24(frame + lamePos + 21);
+                quint64 encoderSamples = (delays >> 12) + (delays & 0xFFF);
+
+                if (encoderSamples < samples)
+                    samples -= encoderSamples;
+            }
+        }
+    }
+    /* En-tête VBRI (Fraunhofer), toujours 32 octets après l'en-tête de frame */
+    else if (36 + 18 <= frameAvailable && std::memcmp(frame + 36, "VBRI", 4) == 0)
+    {
+        samples = static_cast<quint64>(readBE32(frame + 36 + 14)) * header.samplesPerFrame;
+    }
+
+    if (samples > 0)
+        metadata.length = samples * 1000 / header.sampleRate;
+    else
+    {
+        /* CBR : durée déduite du débit */
+        qint64 audioBytes = audioEnd - (audioStart + framePos);
+        metadata.length = audioBytes * 8 / header.bitrate;
+    }
+
+    metadata.format = FMOD_SOUND_TYPE_MPEG;
+
+    // Tag ID3v2 présent mais dont aucun texte n'a été extrait : lu par TagLib
+    if (audioStart > 0 && metadata.title.isEmpty() && metadata.artist.isEmpty())
+        return Result::UNREAD_TAGS;
+
+    return Result::PROBED;
+}
+
+// ==============================
+// ==============================
+
+SongProbe::Result SongProbe::probeOgg(QFile& file, const QByteArray& head, SongMetadata& metadata)
+{
+    QByteArray data = head;
+    if (data.size() < OGG_HEAD_SIZE)
+    {
+        file.seek(data.size());
+        data.append(file.read(OGG_HEAD_SIZE - data.size()));
+    }
+
+    /* Concaténation des données des pages du flux */
+    QByteArray packets;
+    QByteArray firstPacket;
+    quint32 serial = 0;
+    int pos = 0;
+
+    while (pos + 27 <= data.size() && std::memcmp(data.constData() + pos, "OggS", 4) == 0)
+    {
+        int segments = static_cast<uchar>(data.at(pos + 26));
+        if (pos + 27 + segments > data.size())
+            break;
+
+        int payloadSize = 0;
+        for (int i = 0; i < segments; ++i)
+            payloadSize += static_cast<uchar>(data.at(pos + 27 + i));
+
+        int payloadPos = pos + 27 + segments;
+        quint32 pageSerial = readLE32(data.constData() + pos + 14);
+
+        if (firstPacket.isEmpty())
+        {
+            serial = pageSerial;
+            firstPacket = data.mid(payloadPos, payloadSize);
+        }
+        else if (pageSerial == serial)
+            packets.append(data.mid(payloadPos, std::min(payloadSize, data.size() - payloadPos)));
+
+        pos = payloadPos + payloadSize;
+    }
+
+    /* Seul Vorbis est lu ici, les autres codecs Ogg sont laissés à FMOD */
+    if (firstPacket.size() < 16 || !firstPacket.startsWith("\x01vorbis") || !packets.startsWith("\x03vorbis"))
+        return Result::UNSUPPORTED;
+
+    const int commentsPos = 7;
+    unsigned int sampleRate = readLE32(firstPacket.constData() + 12);
+
+    if (sampleRate == 0)
+        return Result::UNSUPPORTED;
+
+    readVorbisComments(packets.constData() + commentsPos, packets.size() - commentsPos, metadata);
+
+    /* Dernière granule : dernière page du flux */
+    qint64 fileSize = file.size();
+    qint64 tailPos = std::max<qint64>(0, fileSize - OGG_TAIL_SIZE);
+    file.seek(tailPos);
+    QByteArray tail = file.read(fileSize - tailPos);
+
+    for (int i = tail.size() - 27; i >= 0; --i)
+    {
+        if (tail.at(i) != 'O' || std::memcmp(tail.constData() + i, "OggS", 4) != 0)
+            continue;
+
+        quint64 granule = readLE64(tail.constData() + i + 6);
+        if (readLE32(tail.constData() + i + 14) == serial && granule != ~quint64(0))
+        {
+            metadata.length = granule * 1000 / sampleRate;
+            metadata.format = FMOD_SOUND_TYPE_OGGVORBIS;
+            return Result::PROBED;
+        }
+    }
+
+    return Result::UNSUPPORTED;
+}
+
+// ==============================
+// ==============================
+
+SongProbe::Result SongProbe::probeWav(QFile& file, SongMetadata& metadata)
+{
+    qint64 fileSize = file.size();
+    qint64 pos = 12;
+
+    quint32 byteRate = 0;
+    quint32 sampleRate = 0;
+    quint32 factSamples = 0;
+    qint64 dataSize = -1;
+
+    while (pos + 8 <= fileSize)
+    {
+        file.seek(pos);
+        QByteArray chunkHeader = file.read(8);
+        if (chunkHeader.size() < 8)
+            break;
+
+        QByteArray id = chunkHeader.left(4);
+        quint32 size = readLE32(chunkHeader.constData() + 4);
+
+        if (id == "fmt " && size >= 16)
+        {
+            QByteArray fmt = file.read(16);
+            if (fmt.size() < 16)
+                break;
+
+            sampleRate = readLE32(fmt.constData() + 4);
+            byteRate = readLE32(fmt.constData() + 8);
+        }
+        else if (id == "fact" && size >= 4)
+        {
+            QByteArray fact = file.read(4);
+            if (fact.size() == 4)
+                factSamples = readLE32(fact.constData());
+        }
+        else if (id == "data")
+        {
+            dataSize = std::min<qint64>(size, fileSize - pos - 8);
+        }
+        else if (id == "LIST" && size <= static_cast<quint32>(MAX_TAG_FRAME) * 4)
+        {
+            QByteArray list = file.read(size);
+
+            if (list.startsWith("INFO"))
+            {
+                int infoPos = 4;
+                while (infoPos + 8 <= list.size())
+                {
+                    QByteArray infoId = list.mid(infoPos, 4);
+                    quint32 infoSize = readLE32(list.constData() + infoPos + 4);
+                    if (infoSize > static_cast<quint32>(list.size() - infoPos - 8))
+                        break;
+
+                    const char *value = list.constData() + infoPos + 8;
+                    if (infoId == "INAM" && metadata.title.isEmpty())
+                        metadata.title = QString::fromUtf8(value, qstrnlen(value, infoSize)).trimmed();
+                    else if (infoId == "IART" && metadata.artist.isEmpty())
+                        metadata.artist = QString::fromUtf8(value, qstrnlen(value, infoSize)).trimmed();
+
+                    infoPos += 8 + infoSize + (infoSize & 1);
+                }
+            }
+        }
+
+        pos += 8 + static_cast<qint64>(size) + (size & 1);
+    }
+
+    if (dataSize < 0 || byteRate == 0)
+        return Result::UNSUPPORTED;
+
+    if (factSamples > 0 && sampleRate > 0)
+        metadata.length = static_cast<quint64>(factSamples) * 1000 / sampleRate;
+    else
+        metadata.length = static_cast<quint64>(dataSize) * 1000 / byteRate;
+
+    metadata.format = FMOD_SOUND_TYPE_WAV;
+    return Result::PROBED;
+}
+
+// ==============================
+// ==============================
+
+SongProbe::Result SongProbe::probeFlac(QFile& file, SongMetadata& metadata)
+{
+    qint64 pos = 4;
+    bool lastBlock = false;
+    quint64 totalSamples = 0;
+    unsigned int sampleRate = 0;
+
+    while (!lastBlock)
+    {
+        file.seek(pos);
+        QByteArray blockHeader = file.read(4);
+        if (blockHeader.size() < 4)
+            break;
+
+        lastBlock = (blockHeader.at(0) & 0x80);
+        int type = blockHeader.at(0) & 0x7F;
+        quint32 size = readBE24(blockHeader.constData() + 1);
+
+        if (type == 0 && size >= 18)                // STREAMINFO
+        {
+            QByteArray info = file.read(18);
+            if (info.size() < 18)
+                break;
+
+            const uchar *u = reinterpret_cast<const uchar*>(info.constData());
+            sampleRate = (u[10] << 12) | (u[11] << 4) | (u[12] >> 4);
+            totalSamples = (static_cast<quint64>(u[13] & 0x0F) << 32) | readBE32(info.constData() + 14);
+        }
+        else if (type == 4 && size <= static_cast<quint32>(MAX_TAG_FRAME) * 16)    // VORBIS_COMMENT
+        {
+            QByteArray comments = file.read(size);
+            readVorbisComments(comments.constData(), comments.size(), metadata);
+        }
+
+        pos += 4 + static_cast<qint64>(size);
+    }
+
+    if (sampleRate == 0 || totalSamples == 0)
+        return Result::UNSUPPORTED;
+
+    metadata.length = totalSamples * 1000 / sampleRate;
+    metadata.format = FMOD_SOUND_TYPE_FLAC;
+    return Result::PROBED;
+}
+
+// ==============================
+// ==============================
+
+SongProbe::Result SongProbe::probe(const QString& filePath, SongMetadata& metadata)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly))
+        return Result::UNSUPPORTED;
+
+    QByteArray head = file.read(HEAD_SIZE);
+    Result result = Result::UNSUPPORTED;
+
+    if (head.startsWith("RIFF") && head.mid(8, 4) == "WAVE")
+        result = probeWav(file, metadata);
+    else if (head.startsWith("OggS"))
+        result = probeOgg(file, head, metadata);
+    else if (head.startsWith("fLaC"))
+        result = probeFlac(file, metadata);
+    else if (head.startsWith("ID3") || (head.size() >= 4 && static_cast<uchar>(head.at(0)) == 0xFF
+                                        && (static_cast<uchar>(head.at(1)) & 0xE0) == 0xE0))
+        result = probeMpeg(file, metadata);
+    else if (isNonAudio(head))
+        result = Result::REJECTED;
+
+    if (result == Result::UNSUPPORTED)
+    {
+        metadata.title.clear();
+        metadata.artist.clear();
+    }
+
+    return result;
+}
+
+
+} // audio
@@ -0,0 +1,84 @@
+/*************************************
+ * @file    SongProbe.h
+ * @date    17/10/26
+ * @author  Manuel
+ *
+ * Déclarations de la classe SongProbe
+ * lisant la durée et les tags d'un fichier
+ * depuis ses en-têtes, sans décodeur.
+ *************************************
+*/
+
+#ifndef __SONGPROBE_H__
+#define __SONGPROBE_H__
+
+#include <QFile>
+#include <QByteArray>
+#include "SongMetadata.h"
+
+
+namespace audio {
+
+
+class SongProbe
+{
+    public:
+
+        enum class Result { PROBED, UNREAD_TAGS, UNSUPPORTED, REJECTED };
+
+    private:
+
+        /**
+         * @brief Détermine à partir des premiers octets si le fichier n'est pas un son (image, texte, archive).
+         * @param head Début du fichier
+         * @return true si le fichier peut être rejeté sans décodeur
+         */
+        static bool isNonAudio(const QByteArray& head);
+
+        /**
+         * @brief Lit le tag ID3v2 en début de fichier (titre et artiste uniquement).
+         * @param file Fichier ouvert
+         * @param metadata Informations à compléter
+         * @return Position du premier octet suivant le tag
+         */
+        static qint64 readId3v2(QFile& file, SongMetadata& metadata);
+
+        /**
+         * @brief Lit le tag ID3v1 en fin de fichier s'il existe.
+         * @param file Fichier ouvert
+         * @param metadata Informations à compléter (champs vides uniquement)
+         * @return Position du premier octet du tag (taille du fichier si absent)
+         */
+        static qint64 readId3v1(QFile& file, SongMetadata& metadata);
+
+        /**
+         * @brief Lit les commentaires Vorbis (utilisés par Ogg et FLAC).
+         * @param data Début du bloc de commentaires (longueur du vendeur)
+         * @param size Taille disponible
+         * @param metadata Informations à compléter
+         */
+        static void readVorbisComments(const char *data, int size, SongMetadata& metadata);
+
+        static Result probeMpeg(QFile& file, SongMetadata& metadata);
+        static Result probeOgg(QFile& file, const QByteArray& head, SongMetadata& metadata);
+        static Result probeWav(QFile& file, SongMetadata& metadata);
+        static Result probeFlac(QFile& file, SongMetadata& metadata);
+
+    public:
+
+        /**
+         * @brief Lit la durée et les tags du fichier à partir de ses en-têtes (MP3 Xing/VBRI/LAME, Ogg, WAV, FLAC).
+         *        Le fichier n'est ouvert qu'une seule fois et n'est jamais décodé.
+         * @param filePath Fichier à lire
+         * @param metadata Informations lues (format, durée, titre et artiste si présents)
+         * @return PROBED si la durée a été lue, UNREAD_TAGS si la durée a été lue mais que le tag présent
+         *         n'a pas pu l'être (désynchronisation, frames trop grandes), REJECTED si le fichier
+         *         n'est pas un son, UNSUPPORTED si le format doit être lu par FMOD
+         */
+        static Result probe(const QString& filePath, SongMetadata& metadata);
+};
+
+
+} // audio
+
+#endif  // __SONGPROBE_H__
@@ -0,0 +1,136 @@
+/*************************************
+ * @file    SongScanner.cpp
+ * @date    17/10/26
+ * @author  Manuel
+ *
+ * Définitions de la classe SongScanner.
+ *************************************
+*/
+
+#include "SongScanner.h"
+#include "Song.h"
+#include "../Exceptions/BaseException.h"
+#include "../Exceptions/FileLoadingException.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QThread>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+
+namespace audio {
+
+
+SongScanner::SongScanner(unsigned int threadsNb)
+    : m_ThreadsNb(threadsNb)
+{
+    if (m_ThreadsNb == 0)
+        m_ThreadsNb = std::max(1, QThread::idealThreadCount());
+}
+
+// ==============================
+// ==============================
+
+const QVector<SongScanner::Entry>& SongScanner::walk(const QString& dirPath)
+{
+    QDir dir(dirPath);
+    if (!dir.exists())
+        throw exceptions::FileLoadingException("SongScanner::walk", dirPath.toStdString());
+
+    m_Entries.clear();
+    walk(dirPath, 0);
+
+    return m_Entries;
+}
+
+// ==============================
+// ==============================
+
+void SongScanner::walk(const QString& dirPath, unsigned int depth)
+{
+    QDir dir(dirPath);
+    QFileInfoList files = dir.entryInfoList(QDir::AllEntries | QDir::NoDotAndDotDot);
+
+    for (const QFileInfo& fileInfo : files)
+    {
+        m_Entries.append({ fileInfo.filePath(), fileInfo.canonicalFilePath(), fileInfo.completeBaseName(),
+                           fileInfo.size(), fileInfo.lastModified().toMSecsSinceEpoch(), depth, fileInfo.isDir() });
+
+        if (fileInfo.isDir())
+            walk(fileInfo.filePath(), depth + 1);
+    }
+}
+
+// ==============================
+// ==============================
+
+QHash<QString, SongMetadata> SongScanner::probe(const QStringList& files)
+{
+    std::vector<SongMetadata> results(files.size());
+    std::atomic<int> nextFile(0);
+
+    // Le singleton doit être créé par le thread appelant avant d'être partagé
+    FmodManager::getInstance();
+
+    auto worker = [&files, &results, &nextFile]() {
+        int i;
+
+        while ((i = nextFile++) < files.size())
+        {
+            try
+            {
+                results[i] = Song::readMetadata(files.at(i));
+            }
+            catch (exceptions::BaseException&)
+            {
+                results[i].valid = false;
+            }
+        }
+    };
+
+    unsigned int threadsNb = std::min<unsigned int>(m_ThreadsNb, files.size());
+
+    if (threadsNb <= 1)
+        worker();
+    else
+    {
+        std::vector<std::thread> threads;
+        for (unsigned int t = 0; t < threadsNb; ++t)
+            threads.emplace_back(worker);
+
+        for (std::thread& thread : threads)
+            thread.join();
+    }
+
+    QHash<QString, SongMetadata> metadata;
+    metadata.reserve(files.size());
+
+    for (int i = 0; i < files.size(); ++i)
+        metadata.insert(files.at(i), results[i]);
+
+    return metadata;
+}
+
+// ==============================
+// ==============================
+
+QString SongScanner::walkOrderKey(const QString& path)
+{
+    // Séparateur inférieur à tout caractère d'un nom : un nom précède ceux dont il est le préfixe
+    return path.toLower().replace('/', QChar(1));
+}
+
+// ==============================
+// ==============================
+
+const QVector<SongScanner::Entry>& SongScanner::getEntries() const
+{
+    return m_Entries;
+}
+
+
+} // audio
@@ -0,0 +1,95 @@
+/*************************************
+ * @file    SongScanner.h
+ * @date    17/10/26
+ * @author  Manuel
+ *
+ * Déclarations de la classe SongScanner
+ * parcourant le répertoire des musiques
+ * et lisant les fichiers en parallèle.
+ *************************************
+*/
+
+#ifndef __SONGSCANNER_H__
+#define __SONGSCANNER_H__
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+#include "SongMetadata.h"
+#include "../Constants.h"
+
+
+namespace audio {
+
+
+class SongScanner
+{
+    public:
+
+        struct Entry
+        {
+            QString filePath;
+            QString canonicalPath;
+            QString name;
+            qint64 size;
+            qint64 mtime;       // Date de modification (ms)
+            unsigned int depth;
+            bool isDir;
+        };
+
+    private:
+
+        unsigned int m_ThreadsNb;
+
+        QVector<Entry> m_Entries;
+
+
+        /**
+         * @brief Ajoute récursivement les éléments du répertoire passé en paramètre.
+         * @param dirPath Répertoire à parcourir
+         * @param depth Profondeur du répertoire dans l'arborescence
+         */
+        void walk(const QString& dirPath, unsigned int depth);
+
+    public:
+
+        /**
+         * @param threadsNb Nombre de threads de lecture (0 : nombre de coeurs, 1 : séquentiel)
+         */
+        SongScanner(unsigned int threadsNb = SCAN_THREADS_NB);
+        virtual ~SongScanner() = default;
+
+        /**
+         * @brief Parcourt le répertoire et liste ses éléments dans l'ordre d'affichage (parcours en profondeur).
+         * @param dirPath Répertoire à parcourir
+         * @return Eléments trouvés, un répertoire précédant son contenu
+         */
+        const QVector<Entry>& walk(const QString& dirPath);
+
+        /**
+         * @brief Lit la durée et les tags des fichiers passés en paramètre avec le pool de threads.
+         * @param files Chemins canoniques des fichiers à lire
+         * @return Informations lues associées à chaque chemin
+         */
+        QHash<QString, SongMetadata> probe(const QStringList& files);
+
+        /**
+         * @brief Calcule la clé de tri d'un chemin dans l'ordre du parcours (noms triés sans tenir compte
+         *        de la casse, un répertoire précédant son contenu) : les clés se comparent comme des chaînes.
+         * @param path Chemin
+         * @return Clé du chemin
+         */
+        static QString walkOrderKey(const QString& path);
+
+        /**
+         * @brief getEntries
+         * @return Eléments trouvés lors du dernier parcours.
+         */
+        const QVector<Entry>& getEntries() const;
+};
+
+
+} // audio
+
+#endif  // __SONGSCANNER_H__
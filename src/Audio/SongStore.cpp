@@ -0,0 +1,367 @@
+/*************************************
+ * @file    SongStore.cpp
+ * @date    17/10/26
+ * @author  Manuel
+ *
+ * Définitions de la classe SongStore.
+ *************************************
+*/
+
+#include "SongStore.h"
+#include "Song.h"
+
+
+namespace audio {
+
+
+constexpr quint32 SongStore::NO_SLOT;
+
+// ==============================
+// ==============================
+
+SongStore::SongStore()
+    : m_DetachedCursor(NO_SLOT)
+{
+    for (unsigned int i = 0; i < LISTS_NB; ++i)
+    {
+        m_Heads[i] = NO_SLOT;
+        m_Tails[i] = NO_SLOT;
+        m_Counts[i] = 0;
+    }
+}
+
+// ==============================
+// ==============================
+
+unsigned int SongStore::listIndex(SongList_t list)
+{
+    if (list == SongList_t::DIRECTORY_SONGS)
+        return 0;
+    else if (list == SongList_t::IMPORTED_SONGS)
+        return 1;
+    else
+        return 2;
+}
+
+// ==============================
+// ==============================
+
+bool SongStore::hasList(unsigned int index, SongList_t lists)
+{
+    static const SongList_t LISTS[LISTS_NB] = { SongList_t::DIRECTORY_SONGS, SongList_t::IMPORTED_SONGS, SongList_t::REMOTE_SONGS };
+    return (lists & LISTS[index]);
+}
+
+// ==============================
+// ==============================
+
+SongStore::Handle SongStore::handle(quint32 slot) const
+{
+    if (slot == NO_SLOT)
+        return Handle();
+
+    return Handle(slot, m_Generations[slot]);
+}
+
+// ==============================
+// ==============================
+
+SongStore::Handle SongStore::insert(SongList_t list, Handle before, const std::shared_ptr<Song>& song)
+{
+    quint32 slot;
+
+    if (!m_FreeSlots.empty())
+    {
+        slot = m_FreeSlots.back();
+        m_FreeSlots.pop_back();
+    }
+    else
+    {
+        slot = m_Songs.size();
+
+        m_Available.push_back(0);
+        m_Lists.push_back(0);
+        m_Generations.push_back(0);
+        m_Prev.push_back(NO_SLOT);
+        m_Next.push_back(NO_SLOT);
+        m_Songs.push_back(nullptr);
+    }
+
+    const unsigned int l = listIndex(list);
+
+    m_Available[slot] = song->isAvailable();
+    m_Lists[slot] = l;
+    m_Songs[slot] = song;
+
+    // Chaînage devant "before" s'il appartient à la liste, en fin de liste sinon
+    quint32 next = (isValid(before) && before.index != m_DetachedCursor && m_Lists[before.index] == l) ? before.index : NO_SLOT;
+    quint32 prev = (next != NO_SLOT) ? m_Prev[next] : m_Tails[l];
+
+    m_Prev[slot] = prev;
+    m_Next[slot] = next;
+
+    if (prev != NO_SLOT)
+        m_Next[prev] = slot;
+    else
+        m_Heads[l] = slot;
+
+    if (next != NO_SLOT)
+        m_Prev[next] = slot;
+    else
+        m_Tails[l] = slot;
+
+    m_Counts[l]++;
+    m_Slots.insert(song->getId(), slot);
+
+    return handle(slot);
+}
+
+// ==============================
+// ==============================
+
+void SongStore::unlink(quint32 slot)
+{
+    const unsigned int l = m_Lists[slot];
+    const quint32 prev = m_Prev[slot];
+    const quint32 next = m_Next[slot];
+
+    if (prev != NO_SLOT)
+        m_Next[prev] = next;
+    else
+        m_Heads[l] = next;
+
+    if (next != NO_SLOT)
+        m_Prev[next] = prev;
+    else
+        m_Tails[l] = prev;
+
+    // Le curseur détaché garde des voisins valides
+    if (m_DetachedCursor != NO_SLOT && m_DetachedCursor != slot)
+    {
+        if (m_Next[m_DetachedCursor] == slot)
+            m_Next[m_DetachedCursor] = next;
+
+        if (m_Prev[m_DetachedCursor] == slot)
+            m_Prev[m_DetachedCursor] = prev;
+    }
+
+    m_Counts[l]--;
+    m_Slots.remove(m_Songs[slot]->getId());
+}
+
+// ==============================
+// ==============================
+
+void SongStore::release(quint32 slot)
+{
+    m_Generations[slot]++;
+    m_Songs[slot].reset();
+    m_Prev[slot] = NO_SLOT;
+    m_Next[slot] = NO_SLOT;
+
+    m_FreeSlots.push_back(slot);
+}
+
+// ==============================
+// ==============================
+
+void SongStore::erase(Handle song)
+{
+    if (!isValid(song) || song.index == m_DetachedCursor)
+        return;
+
+    unlink(song.index);
+
+    if (song == m_Cursor)
+        m_DetachedCursor = song.index;
+    else
+        release(song.index);
+}
+
+// ==============================
+// ==============================
+
+void SongStore::clear(SongList_t lists)
+{
+    for (unsigned int l = 0; l < LISTS_NB; ++l)
+    {
+        if (!hasList(l, lists))
+            continue;
+
+        while (m_Heads[l] != NO_SLOT)
+            erase(handle(m_Heads[l]));
+    }
+}
+
+// ==============================
+// ==============================
+
+unsigned int SongStore::count(SongList_t lists) const
+{
+    unsigned int count = 0;
+
+    for (unsigned int l = 0; l < LISTS_NB; ++l)
+    {
+        if (hasList(l, lists))
+            count += m_Counts[l];
+    }
+
+    return count;
+}
+
+// ==============================
+// ==============================
+
+bool SongStore::isValid(Handle song) const
+{
+    return (song.index < m_Generations.size() && m_Generations[song.index] == song.generation && m_Songs[song.index]);
+}
+
+// ==============================
+// ==============================
+
+SongStore::Handle SongStore::find(SongId id) const
+{
+    auto slot = m_Slots.constFind(id);
+
+    if (slot == m_Slots.constEnd())
+        return Handle();
+
+    return handle(slot.value());
+}
+
+// ==============================
+// ==============================
+
+SongStore::Handle SongStore::first(SongList_t lists) const
+{
+    for (unsigned int l = 0; l < LISTS_NB; ++l)
+    {
+        if (hasList(l, lists) && m_Heads[l] != NO_SLOT)
+            return handle(m_Heads[l]);
+    }
+
+    return Handle();
+}
+
+// ==============================
+// ==============================
+
+SongStore::Handle SongStore::last(SongList_t lists) const
+{
+    for (unsigned int l = LISTS_NB; l > 0; --l)
+    {
+        if (hasList(l - 1, lists) && m_Tails[l - 1] != NO_SLOT)
+            return handle(m_Tails[l - 1]);
+    }
+
+    return Handle();
+}
+
+// ==============================
+// ==============================
+
+SongStore::Handle SongStore::next(Handle song, SongList_t lists) const
+{
+    if (!isValid(song))
+        return Handle();
+
+    if (m_Next[song.index] != NO_SLOT)
+        return handle(m_Next[song.index]);
+
+    for (unsigned int l = m_Lists[song.index] + 1; l < LISTS_NB; ++l)
+    {
+        if (hasList(l, lists) && m_Heads[l] != NO_SLOT)
+            return handle(m_Heads[l]);
+    }
+
+    return Handle();
+}
+
+// ==============================
+// ==============================
+
+SongStore::Handle SongStore::prev(Handle song, SongList_t lists) const
+{
+    if (!isValid(song))
+        return Handle();
+
+    if (m_Prev[song.index] != NO_SLOT)
+        return handle(m_Prev[song.index]);
+
+    for (unsigned int l = m_Lists[song.index]; l > 0; --l)
+    {
+        if (hasList(l - 1, lists) && m_Tails[l - 1] != NO_SLOT)
+            return handle(m_Tails[l - 1]);
+    }
+
+    return Handle();
+}
+
+// ==============================
+// ==============================
+
+std::shared_ptr<Song> SongStore::get(Handle song) const
+{
+    if (!isValid(song))
+        return nullptr;
+
+    return m_Songs[song.index];
+}
+
+// ==============================
+// ==============================
+
+SongList_t SongStore::getList(Handle song) const
+{
+    static const SongList_t LISTS[LISTS_NB] = { SongList_t::DIRECTORY_SONGS, SongList_t::IMPORTED_SONGS, SongList_t::REMOTE_SONGS };
+    return LISTS[m_Lists[song.index]];
+}
+
+// ==============================
+// ==============================
+
+bool SongStore::isAvailable(Handle song) const
+{
+    return isValid(song) && m_Available[song.index];
+}
+
+// ==============================
+// ==============================
+
+void SongStore::setAvailable(Handle song, bool available)
+{
+    if (!isValid(song))
+        return;
+
+    m_Available[song.index] = available;
+    m_Songs[song.index]->setAvailable(available);
+}
+
+// ==============================
+// ==============================
+
+SongStore::Handle SongStore::getCursor() const
+{
+    return m_Cursor;
+}
+
+// ==============================
+// ==============================
+
+void SongStore::setCursor(Handle song)
+{
+    if (song == m_Cursor)
+        return;
+
+    m_Cursor = isValid(song) ? song : Handle();
+
+    if (m_DetachedCursor != NO_SLOT)
+    {
+        release(m_DetachedCursor);
+        m_DetachedCursor = NO_SLOT;
+    }
+}
+
+
+} // audio
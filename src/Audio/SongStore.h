@@ -0,0 +1,208 @@
+/*************************************
+ * @file    SongStore.h
+ * @date    17/10/26
+ * @author  Manuel
+ *
+ * Déclarations de la classe SongStore
+ * rangeant les musiques du player dans
+ * des tableaux contigus (un par champ).
+ *************************************
+*/
+
+#ifndef __SONGSTORE_H__
+#define __SONGSTORE_H__
+
+#include <QHash>
+#include <memory>
+#include <vector>
+#include "FmodManager.h"
+#include "../Constants.h"
+
+
+namespace audio {
+
+
+class Song;
+
+
+/**
+ * Les musiques sont rangées par emplacement : les champs parcourus lors de la navigation
+ * (disponibilité, liste, chaînage) sont stockés dans des tableaux séparés, l'objet Song
+ * (titre, fichier, canal FMOD) n'étant consulté que pour la lecture et l'affichage.
+ * L'ordre de lecture de chaque liste est une liste chaînée d'indices dans ces tableaux.
+ *
+ * Une musique est désignée par un Handle (emplacement + génération) : un Handle sur une musique
+ * supprimée devient invalide, même si l'emplacement est réutilisé.
+ */
+class SongStore
+{
+    public:
+
+        using SongId = unsigned int;
+
+        struct Handle
+        {
+            quint32 index;
+            quint32 generation;
+
+            Handle() : index(NO_SLOT), generation(0) {}
+            Handle(quint32 i, quint32 g) : index(i), generation(g) {}
+
+            inline bool isNull() const { return index == NO_SLOT; }
+            inline bool operator==(const Handle& other) const { return index == other.index && generation == other.generation; }
+            inline bool operator!=(const Handle& other) const { return !(*this == other); }
+        };
+
+        static constexpr quint32 NO_SLOT = 0xFFFFFFFF;
+
+    private:
+
+        static constexpr unsigned int LISTS_NB = 3;
+
+        /** Colonnes, indicées par emplacement **/
+        std::vector<quint8> m_Available;
+        std::vector<quint8> m_Lists;            // Indice de la liste (0 : dossier, 1 : importées, 2 : distantes)
+        std::vector<quint32> m_Generations;
+        std::vector<quint32> m_Prev;
+        std::vector<quint32> m_Next;
+        std::vector<std::shared_ptr<Song>> m_Songs;
+
+        std::vector<quint32> m_FreeSlots;
+
+        quint32 m_Heads[LISTS_NB];
+        quint32 m_Tails[LISTS_NB];
+        unsigned int m_Counts[LISTS_NB];
+
+        QHash<SongId, quint32> m_Slots;
+
+        Handle m_Cursor;
+
+        // Musique courante supprimée, conservée jusqu'au déplacement du curseur
+        quint32 m_DetachedCursor;
+
+
+        /**
+         * @brief Retourne l'indice de la liste passée en paramètre (drapeau simple).
+         * @param list Liste
+         * @return Indice de la liste
+         */
+        static unsigned int listIndex(SongList_t list);
+
+        /**
+         * @brief Détermine si la liste d'indice passé en paramètre fait partie des listes composées.
+         * @param index Indice de la liste
+         * @param lists Listes composées
+         * @return true si la liste est incluse
+         */
+        static bool hasList(unsigned int index, SongList_t lists);
+
+        /**
+         * @brief Retire l'emplacement de l'ordre de lecture de sa liste.
+         * @param slot Emplacement à retirer
+         */
+        void unlink(quint32 slot);
+
+        /**
+         * @brief Libère l'emplacement (les Handle qui le désignent deviennent invalides).
+         * @param slot Emplacement à libérer
+         */
+        void release(quint32 slot);
+
+        Handle handle(quint32 slot) const;
+
+    public:
+
+        SongStore();
+        virtual ~SongStore() = default;
+
+        /**
+         * @brief Insère une musique dans une liste.
+         * @param list Liste à laquelle la musique est ajoutée
+         * @param before Musique de la même liste devant laquelle insérer (fin de liste si nul)
+         * @param song Musique à insérer
+         * @return Handle de la musique insérée
+         */
+        Handle insert(SongList_t list, Handle before, const std::shared_ptr<Song>& song);
+
+        /**
+         * @brief Supprime la musique. S'il s'agit de la musique courante, le curseur reste utilisable
+         *        (musique et voisins conservés) jusqu'à son prochain déplacement.
+         * @param song Musique à supprimer
+         */
+        void erase(Handle song);
+
+        /**
+         * @brief Supprime les musiques des listes passées en paramètre.
+         * @param lists Listes à vider
+         */
+        void clear(SongList_t lists = SongList_t::ALL_SONGS);
+
+        /**
+         * @brief Compte les musiques des listes passées en paramètre.
+         * @param lists Listes à compter
+         * @return Nombre de musiques
+         */
+        unsigned int count(SongList_t lists = SongList_t::ALL_SONGS) const;
+
+        /**
+         * @brief isValid
+         * @param song Handle à vérifier
+         * @return true si le Handle désigne une musique du store (ou la musique courante supprimée).
+         */
+        bool isValid(Handle song) const;
+
+        /**
+         * @brief Cherche la musique d'identifiant passé en paramètre.
+         * @param id Identifiant de la musique
+         * @return Handle de la musique, nul si absente
+         */
+        Handle find(SongId id) const;
+
+        Handle first(SongList_t lists = SongList_t::ALL_SONGS) const;
+        Handle last(SongList_t lists = SongList_t::ALL_SONGS) const;
+
+        /**
+         * @brief Retourne la musique suivante dans l'ordre de lecture des listes passées en paramètre.
+         * @param song Musique de départ
+         * @param lists Listes parcourues
+         * @return Musique suivante, nulle en fin de parcours
+         */
+        Handle next(Handle song, SongList_t lists = SongList_t::ALL_SONGS) const;
+
+        /**
+         * @brief Retourne la musique précédente dans l'ordre de lecture des listes passées en paramètre.
+         * @param song Musique de départ
+         * @param lists Listes parcourues
+         * @return Musique précédente, nulle en début de parcours
+         */
+        Handle prev(Handle song, SongList_t lists = SongList_t::ALL_SONGS) const;
+
+        std::shared_ptr<Song> get(Handle song) const;
+        SongList_t getList(Handle song) const;
+
+        bool isAvailable(Handle song) const;
+
+        /**
+         * @brief Modifie la disponibilité de la musique (store et objet Song).
+         * @param song Musique à modifier
+         * @param available Nouvelle disponibilité
+         */
+        void setAvailable(Handle song, bool available);
+
+        /**
+         * @brief getCursor
+         * @return Musique courante (nulle si aucune).
+         */
+        Handle getCursor() const;
+
+        /**
+         * @brief Déplace le curseur sur la musique passée en paramètre.
+         * @param song Nouvelle musique courante (Handle nul pour aucune)
+         */
+        void setCursor(Handle song);
+};
+
+
+} // audio
+
+#endif  // __SONGSTORE_H__
@@ -0,0 +1,143 @@
+/*************************************
+ * @file    SpectrumDsp.cpp
+ * @date    17/10/26
+ * @author  Manuel
+ *
+ * Définitions de la classe SpectrumDsp.
+ *************************************
+*/
+
+#include "SpectrumDsp.h"
+#include "SpectrumKernels.h"
+#include "../Exceptions/LibException.h"
+#include <fmod_errors.h>
+#include <algorithm>
+#include <cstring>
+
+
+namespace audio {
+
+
+SpectrumDsp::SpectrumDsp(unsigned int size, SpectrumFrames *frames)
+    : mp_Frames(frames), m_Mono(SPECTRUM_FFT_SIZE),
+      m_Engine(SPECTRUM_FFT_SIZE, size, FftEngine::Window::HANN, SPECTRUM_OVERLAP)
+{
+    m_Frame.clock = 0;
+    m_Frame.size = size;
+    m_Frame.values.fill(0.0f);
+}
+
+// ==============================
+// ==============================
+
+FMOD_DSP* SpectrumDsp::create(FMOD_SYSTEM *system, unsigned int size, SpectrumFrames *frames)
+{
+    static FMOD_DSP_DESCRIPTION description;
+
+    if (!description.read)
+    {
+        std::memset(&description, 0, sizeof(description));
+
+        description.pluginsdkversion = FMOD_PLUGIN_SDK_VERSION;
+        std::strncpy(description.name, "Player spectrum", sizeof(description.name) - 1);
+        description.version = 0x00010000;
+        description.numinputbuffers = 1;
+        description.numoutputbuffers = 1;
+        description.read = readCallback;
+        description.release = releaseCallback;
+    }
+
+    FMOD_RESULT res;
+    FMOD_DSP *dsp = nullptr;
+
+    if ((res = FMOD_System_CreateDSP(system, &description, &dsp)) != FMOD_OK)
+        throw exceptions::LibException("SpectrumDsp::create", "FMOD_System_CreateDSP", FMOD_ErrorString(res));
+
+    SpectrumDsp *spectrumDsp = new SpectrumDsp(std::min(size, SPECTRUM_WIDTH), frames);
+
+    if ((res = FMOD_DSP_SetUserData(dsp, spectrumDsp)) != FMOD_OK)
+    {
+        delete spectrumDsp;
+        FMOD_DSP_Release(dsp);
+        throw exceptions::LibException("SpectrumDsp::create", "FMOD_DSP_SetUserData", FMOD_ErrorString(res));
+    }
+
+    return dsp;
+}
+
+// ==============================
+// ==============================
+
+FMOD_RESULT F_CALLBACK SpectrumDsp::readCallback(FMOD_DSP_STATE *dspState, float *inBuffer, float *outBuffer,
+                                                 unsigned int length, int inChannels, int* /*outChannels*/)
+{
+    // Le son n'est pas modifié
+    std::copy(inBuffer, inBuffer + length * inChannels, outBuffer);
+
+    void *userData = nullptr;
+    FMOD_DSP_GetUserData(static_cast<FMOD_DSP*>(dspState->instance), &userData);
+
+    SpectrumDsp *spectrumDsp = static_cast<SpectrumDsp*>(userData);
+
+    if (!spectrumDsp)
+        return FMOD_OK;
+
+    unsigned long long clock = 0;
+    unsigned int offset = 0, clockLength = 0;
+    dspState->functions->getclock(dspState, &clock, &offset, &clockLength);
+
+    spectrumDsp->process(inBuffer, length, inChannels, clock + length);
+
+    return FMOD_OK;
+}
+
+// ==============================
+// ==============================
+
+FMOD_RESULT F_CALLBACK SpectrumDsp::releaseCallback(FMOD_DSP_STATE *dspState)
+{
+    void *userData = nullptr;
+    FMOD_DSP_GetUserData(static_cast<FMOD_DSP*>(dspState->instance), &userData);
+
+    delete static_cast<SpectrumDsp*>(userData);
+
+    return FMOD_OK;
+}
+
+// ==============================
+// ==============================
+
+void SpectrumDsp::process(const float *buffer, unsigned int length, int channels, unsigned long long clock)
+{
+    if (channels <= 0)
+        return;
+
+    unsigned int read = 0;
+
+    while (read < length)
+    {
+        const unsigned int count = std::min<unsigned int>(length - read, m_Mono.size());
+        SpectrumKernels::get().downmix(buffer + read * channels, m_Mono.data(), count, channels);
+
+        unsigned int written = 0;
+
+        while (written < count)
+        {
+            written += m_Engine.write(m_Mono.data() + written, count - written);
+
+            if (m_Engine.isFrameReady())
+            {
+                m_Engine.compute(m_Frame.values.data());
+
+                // File pleine : le spectre le plus ancien est retiré, le consommateur garde les plus récents
+                m_Frame.clock = clock - (length - read - written);
+                mp_Frames->pushOverwrite(m_Frame);
+            }
+        }
+
+        read += count;
+    }
+}
+
+
+} // audio
@@ -0,0 +1,89 @@
+/*************************************
+ * @file    SpectrumDsp.h
+ * @date    17/10/26
+ * @author  Manuel
+ *
+ * Déclarations de la classe SpectrumDsp
+ * calculant le spectre du son dans un
+ * DSP FMOD personnalisé.
+ *************************************
+*/
+
+#ifndef __SPECTRUMDSP_H__
+#define __SPECTRUMDSP_H__
+
+#include <fmod.h>
+#include <array>
+#include <vector>
+
+#include "FftEngine.h"
+#include "../Constants.h"
+#include "../Util/spscqueue.h"
+
+
+namespace audio {
+
+
+// Spectre d'une fenêtre de son, daté par l'horloge du mixeur
+struct SpectrumFrame
+{
+    unsigned long long clock;                       // Horloge du mixeur à la fin de la fenêtre (échantillons)
+    unsigned int size;                              // Nombre de valeurs utilisées
+    std::array<float, SPECTRUM_WIDTH> values;
+};
+
+using SpectrumFrames = util::SpscQueue<SpectrumFrame, SPECTRUM_FRAMES_NB>;
+
+
+/**
+ * DSP laissant passer le son et calculant, dans le thread de mixage de FMOD, le spectre
+ * des trames successives du mixage (voir FftEngine). Les spectres sont déposés dans une file sans verrou
+ * lue par le thread audio, qui les retire à mesure que le son correspondant est entendu (voir
+ * FmodManager::getSpectrumFrame) : aucune allocation ni aucun verrou après la création du DSP.
+ */
+class SpectrumDsp
+{
+    private:
+
+        SpectrumFrames *mp_Frames;
+
+        // Echantillons du buffer courant ramenés en mono
+        std::vector<float> m_Mono;
+
+        FftEngine m_Engine;
+
+        SpectrumFrame m_Frame;
+
+
+        SpectrumDsp(unsigned int size, SpectrumFrames *frames);
+
+        /**
+         * @brief Ajoute les échantillons (moyenne des canaux) au moteur de FFT et publie chaque spectre calculé.
+         * @param buffer Echantillons entrelacés
+         * @param length Nombre d'échantillons par canal
+         * @param channels Nombre de canaux
+         * @param clock Horloge du mixeur à la fin du buffer
+         */
+        void process(const float *buffer, unsigned int length, int channels, unsigned long long clock);
+
+        static FMOD_RESULT F_CALLBACK readCallback(FMOD_DSP_STATE *dspState, float *inBuffer, float *outBuffer,
+                                                   unsigned int length, int inChannels, int *outChannels);
+
+        static FMOD_RESULT F_CALLBACK releaseCallback(FMOD_DSP_STATE *dspState);
+
+    public:
+
+        /**
+         * @brief Crée un DSP de spectre (détruit avec FMOD_DSP_Release).
+         * @param system Système FMOD
+         * @param size Nombre de valeurs du spectre (au plus SPECTRUM_WIDTH, indépendant de SPECTRUM_FFT_SIZE)
+         * @param frames File dans laquelle les spectres sont publiés
+         * @return DSP créé
+         */
+        static FMOD_DSP* create(FMOD_SYSTEM *system, unsigned int size, SpectrumFrames *frames);
+};
+
+
+} // audio
+
+#endif  // __SPECTRUMDSP_H__
@@ -0,0 +1,536 @@
+/*************************************
+ * @file    SpectrumKernels.cpp
+ * @date    17/10/26
+ * @author  Manuel
+ *
+ * Définitions de la classe SpectrumKernels.
+ *************************************
+*/
+
+#include "SpectrumKernels.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    #define SPECTRUM_KERNELS_X86
+    #include <immintrin.h>
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+    #endif
+#endif
+
+// Les fonctions vectorisées sont compilées pour leur jeu d'instructions, quelles que soient les options du projet
+#if defined(__GNUC__)
+    #define TARGET_SSE2 __attribute__((target("sse2")))
+    #define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+    #define TARGET_SSE2
+    #define TARGET_AVX2
+#endif
+
+
+namespace audio {
+
+
+namespace {
+
+constexpr float DB_FACTOR = 8.68588963806503655302f;       // 20 / ln(10)
+constexpr float LN_2 = 0.693147180559945309417f;
+
+
+/*******************************
+/** Versions scalaires
+/*******************************/
+
+void downmixScalar(const float *in, float *out, unsigned int frames, int channels)
+{
+    const float factor = 1.0f / channels;
+
+    for (unsigned int i = 0; i < frames; i++)
+    {
+        float sum = 0.0f;
+
+        for (int c = 0; c < channels; c++)
+            sum += in[i * channels + c];
+
+        out[i] = sum * factor;
+    }
+}
+
+// ==============================
+// ==============================
+
+void toDecibelsScalar(const float *in, float *out, unsigned int size, float floorDb)
+{
+    for (unsigned int i = 0; i < size; i++)
+    {
+        float value = in[i] > FLT_MIN ? in[i] : FLT_MIN;
+        out[i] = std::max(DB_FACTOR * std::log(value), floorDb);
+    }
+}
+
+// ==============================
+// ==============================
+
+void scaleClampScalar(const float *in, float *out, unsigned int size, float scale, float low, float high)
+{
+    for (unsigned int i = 0; i < size; i++)
+    {
+        float value = in[i] * scale;
+        out[i] = value > low ? (value < high ? value : high) : low;
+    }
+}
+
+// ==============================
+// ==============================
+
+void toHeightsScalar(const float *in, int *out, unsigned int size, float scale, int maxHeight)
+{
+    const float high = static_cast<float>(maxHeight);
+
+    for (unsigned int i = 0; i < size; i++)
+    {
+        float value = in[i] * scale;
+        out[i] = static_cast<int>(value > 0.0f ? (value < high ? value : high) : 0.0f);
+    }
+}
+
+// ==============================
+// ==============================
+
+void aggregateBandsScalar(const float *in, const unsigned int *edges, float *out, unsigned int bandsNb)
+{
+    for (unsigned int b = 0; b < bandsNb; b++)
+    {
+        const unsigned int begin = edges[b];
+        const unsigned int end = std::max(edges[b + 1], begin + 1);
+        float result = in[begin];
+
+        for (unsigned int i = begin + 1; i < end; i++)
+            result = std::max(result, in[i]);
+
+        out[b] = result;
+    }
+}
+
+
+#if defined(SPECTRUM_KERNELS_X86)
+
+/*******************************
+/** Versions SSE2
+/*******************************/
+
+// Logarithme népérien de valeurs normales positives : exposant + série de atanh sur la mantisse (erreur < 1e-6)
+TARGET_SSE2 inline __m128 logSse2(__m128 x)
+{
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128i bits = _mm_castps_si128(x);
+
+    __m128 exponent = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(127)));
+    __m128 mantissa = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(0x007FFFFF)), _mm_set1_epi32(0x3F800000)));
+
+    __m128 t = _mm_div_ps(_mm_sub_ps(mantissa, one), _mm_add_ps(mantissa, one));
+    __m128 t2 = _mm_mul_ps(t, t);
+
+    __m128 poly = _mm_set1_ps(1.0f / 9.0f);
+    poly = _mm_add_ps(_mm_mul_ps(poly, t2), _mm_set1_ps(1.0f / 7.0f));
+    poly = _mm_add_ps(_mm_mul_ps(poly, t2), _mm_set1_ps(1.0f / 5.0f));
+    poly = _mm_add_ps(_mm_mul_ps(poly, t2), _mm_set1_ps(1.0f / 3.0f));
+    poly = _mm_add_ps(_mm_mul_ps(poly, t2), one);
+
+    return _mm_add_ps(_mm_mul_ps(exponent, _mm_set1_ps(LN_2)), _mm_mul_ps(_mm_add_ps(t, t), poly));
+}
+
+// ==============================
+// ==============================
+
+TARGET_SSE2 void downmixSse2(const float *in, float *out, unsigned int frames, int channels)
+{
+    if (channels != 2)
+    {
+        downmixScalar(in, out, frames, channels);
+        return;
+    }
+
+    const __m128 half = _mm_set1_ps(0.5f);
+    unsigned int i = 0;
+
+    for (; i + 4 <= frames; i += 4)
+    {
+        __m128 a = _mm_loadu_ps(in + 2 * i);
+        __m128 b = _mm_loadu_ps(in + 2 * i + 4);
+
+        __m128 left = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+        __m128 right = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+
+        _mm_storeu_ps(out + i, _mm_mul_ps(_mm_add_ps(left, right), half));
+    }
+
+    downmixScalar(in + 2 * i, out + i, frames - i, channels);
+}
+
+// ==============================
+// ==============================
+
+TARGET_SSE2 void toDecibelsSse2(const float *in, float *out, unsigned int size, float floorDb)
+{
+    const __m128 minimum = _mm_set1_ps(FLT_MIN);
+    const __m128 factor = _mm_set1_ps(DB_FACTOR);
+    const __m128 floor = _mm_set1_ps(floorDb);
+    unsigned int i = 0;
+
+    for (; i + 4 <= size; i += 4)
+    {
+        __m128 value = _mm_max_ps(_mm_loadu_ps(in + i), minimum);
+        _mm_storeu_ps(out + i, _mm_max_ps(_mm_mul_ps(logSse2(value), factor), floor));
+    }
+
+    toDecibelsScalar(in + i, out + i, size - i, floorDb);
+}
+
+// ==============================
+// ==============================
+
+TARGET_SSE2 void scaleClampSse2(const float *in, float *out, unsigned int size, float scale, float low, float high)
+{
+    const __m128 factor = _mm_set1_ps(scale);
+    const __m128 lowValue = _mm_set1_ps(low);
+    const __m128 highValue = _mm_set1_ps(high);
+    unsigned int i = 0;
+
+    for (; i + 4 <= size; i += 4)
+    {
+        __m128 value = _mm_mul_ps(_mm_loadu_ps(in + i), factor);
+        _mm_storeu_ps(out + i, _mm_min_ps(_mm_max_ps(value, lowValue), highValue));
+    }
+
+    scaleClampScalar(in + i, out + i, size - i, scale, low, high);
+}
+
+// ==============================
+// ==============================
+
+TARGET_SSE2 void toHeightsSse2(const float *in, int *out, unsigned int size, float scale, int maxHeight)
+{
+    const __m128 factor = _mm_set1_ps(scale);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 high = _mm_set1_ps(static_cast<float>(maxHeight));
+    unsigned int i = 0;
+
+    for (; i + 4 <= size; i += 4)
+    {
+        __m128 value = _mm_mul_ps(_mm_loadu_ps(in + i), factor);
+        value = _mm_min_ps(_mm_max_ps(value, zero), high);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_cvttps_epi32(value));
+    }
+
+    toHeightsScalar(in + i, out + i, size - i, scale, maxHeight);
+}
+
+// ==============================
+// ==============================
+
+TARGET_SSE2 inline float horizontalMaxSse2(__m128 value)
+{
+    value = _mm_max_ps(value, _mm_shuffle_ps(value, value, _MM_SHUFFLE(2, 3, 0, 1)));
+    value = _mm_max_ps(value, _mm_shuffle_ps(value, value, _MM_SHUFFLE(1, 0, 3, 2)));
+
+    return _mm_cvtss_f32(value);
+}
+
+// ==============================
+// ==============================
+
+TARGET_SSE2 void aggregateBandsSse2(const float *in, const unsigned int *edges, float *out, unsigned int bandsNb)
+{
+    for (unsigned int b = 0; b < bandsNb; b++)
+    {
+        const unsigned int begin = edges[b];
+        const unsigned int end = std::max(edges[b + 1], begin + 1);
+        unsigned int i = begin;
+
+        __m128 maximum = _mm_set1_ps(in[begin]);
+
+        for (; i + 4 <= end; i += 4)
+            maximum = _mm_max_ps(maximum, _mm_loadu_ps(in + i));
+
+        float result = horizontalMaxSse2(maximum);
+
+        for (; i < end; i++)
+            result = std::max(result, in[i]);
+
+        out[b] = result;
+    }
+}
+
+
+/*******************************
+/** Versions AVX2
+/*******************************/
+
+TARGET_AVX2 inline __m256 logAvx2(__m256 x)
+{
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256i bits = _mm256_castps_si256(x);
+
+    __m256 exponent = _mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(127)));
+    __m256 mantissa = _mm256_castsi256_ps(_mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi32(0x007FFFFF)), _mm256_set1_epi32(0x3F800000)));
+
+    __m256 t = _mm256_div_ps(_mm256_sub_ps(mantissa, one), _mm256_add_ps(mantissa, one));
+    __m256 t2 = _mm256_mul_ps(t, t);
+
+    __m256 poly = _mm256_set1_ps(1.0f / 9.0f);
+    poly = _mm256_add_ps(_mm256_mul_ps(poly, t2), _mm256_set1_ps(1.0f / 7.0f));
+    poly = _mm256_add_ps(_mm256_mul_ps(poly, t2), _mm256_set1_ps(1.0f / 5.0f));
+    poly = _mm256_add_ps(_mm256_mul_ps(poly, t2), _mm256_set1_ps(1.0f / 3.0f));
+    poly = _mm256_add_ps(_mm256_mul_ps(poly, t2), one);
+
+    return _mm256_add_ps(_mm256_mul_ps(exponent, _mm256_set1_ps(LN_2)), _mm256_mul_ps(_mm256_add_ps(t, t), poly));
+}
+
+// ==============================
+// ==============================
+
+TARGET_AVX2 void downmixAvx2(const float *in, float *out, unsigned int frames, int channels)
+{
+    if (channels != 2)
+    {
+        downmixScalar(in, out, frames, channels);
+        return;
+    }
+
+    const __m256 half = _mm256_set1_ps(0.5f);
+    unsigned int i = 0;
+
+    for (; i + 8 <= frames; i += 8)
+    {
+        __m256 a = _mm256_loadu_ps(in + 2 * i);
+        __m256 b = _mm256_loadu_ps(in + 2 * i + 8);
+
+        // Trames dans l'ordre 0 1 4 5 | 2 3 6 7 (mélange par moitié de registre), remises dans l'ordre ensuite
+        __m256 left = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+        __m256 right = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+        __m256 mono = _mm256_mul_ps(_mm256_add_ps(left, right), half);
+
+        mono = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(mono), _MM_SHUFFLE(3, 1, 2, 0)));
+        _mm256_storeu_ps(out + i, mono);
+    }
+
+    downmixScalar(in + 2 * i, out + i, frames - i, channels);
+}
+
+// ==============================
+// ==============================
+
+TARGET_AVX2 void toDecibelsAvx2(const float *in, float *out, unsigned int size, float floorDb)
+{
+    const __m256 minimum = _mm256_set1_ps(FLT_MIN);
+    const __m256 factor = _mm256_set1_ps(DB_FACTOR);
+    const __m256 floor = _mm256_set1_ps(floorDb);
+    unsigned int i = 0;
+
+    for (; i + 8 <= size; i += 8)
+    {
+        __m256 value = _mm256_max_ps(_mm256_loadu_ps(in + i), minimum);
+        _mm256_storeu_ps(out + i, _mm256_max_ps(_mm256_mul_ps(logAvx2(value), factor), floor));
+    }
+
+    toDecibelsScalar(in + i, out + i, size - i, floorDb);
+}
+
+// ==============================
+// ==============================
+
+TARGET_AVX2 void scaleClampAvx2(const float *in, float *out, unsigned int size, float scale, float low, float high)
+{
+    const __m256 factor = _mm256_set1_ps(scale);
+    const __m256 lowValue = _mm256_set1_ps(low);
+    const __m256 highValue = _mm256_set1_ps(high);
+    unsigned int i = 0;
+
+    for (; i + 8 <= size; i += 8)
+    {
+        __m256 value = _mm256_mul_ps(_mm256_loadu_ps(in + i), factor);
+        _mm256_storeu_ps(out + i, _mm256_min_ps(_mm256_max_ps(value, lowValue), highValue));
+    }
+
+    scaleClampScalar(in + i, out + i, size - i, scale, low, high);
+}
+
+// ==============================
+// ==============================
+
+TARGET_AVX2 void toHeightsAvx2(const float *in, int *out, unsigned int size, float scale, int maxHeight)
+{
+    const __m256 factor = _mm256_set1_ps(scale);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 high = _mm256_set1_ps(static_cast<float>(maxHeight));
+    unsigned int i = 0;
+
+    for (; i + 8 <= size; i += 8)
+    {
+        __m256 value = _mm256_mul_ps(_mm256_loadu_ps(in + i), factor);
+        value = _mm256_min_ps(_mm256_max_ps(value, zero), high);
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_cvttps_epi32(value));
+    }
+
+    toHeightsScalar(in + i, out + i, size - i, scale, maxHeight);
+}
+
+// ==============================
+// ==============================
+
+TARGET_AVX2 void aggregateBandsAvx2(const float *in, const unsigned int *edges, float *out, unsigned int bandsNb)
+{
+    for (unsigned int b = 0; b < bandsNb; b++)
+    {
+        const unsigned int begin = edges[b];
+        const unsigned int end = std::max(edges[b + 1], begin + 1);
+        unsigned int i = begin;
+
+        __m256 maximum = _mm256_set1_ps(in[begin]);
+
+        for (; i + 8 <= end; i += 8)
+            maximum = _mm256_max_ps(maximum, _mm256_loadu_ps(in + i));
+
+        __m128 half = _mm_max_ps(_mm256_castps256_ps128(maximum), _mm256_extractf128_ps(maximum, 1));
+
+        for (; i + 4 <= end; i += 4)
+            half = _mm_max_ps(half, _mm_loadu_ps(in + i));
+
+        half = _mm_max_ps(half, _mm_shuffle_ps(half, half, _MM_SHUFFLE(2, 3, 0, 1)));
+        half = _mm_max_ps(half, _mm_shuffle_ps(half, half, _MM_SHUFFLE(1, 0, 3, 2)));
+
+        float result = _mm_cvtss_f32(half);
+
+        for (; i < end; i++)
+            result = std::max(result, in[i]);
+
+        out[b] = result;
+    }
+}
+
+#endif
+
+
+const SpectrumKernels::Functions SCALAR_FUNCTIONS = {
+    downmixScalar, toDecibelsScalar, scaleClampScalar, toHeightsScalar, aggregateBandsScalar
+};
+
+#if defined(SPECTRUM_KERNELS_X86)
+const SpectrumKernels::Functions SSE2_FUNCTIONS = {
+    downmixSse2, toDecibelsSse2, scaleClampSse2, toHeightsSse2, aggregateBandsSse2
+};
+
+const SpectrumKernels::Functions AVX2_FUNCTIONS = {
+    downmixAvx2, toDecibelsAvx2, scaleClampAvx2, toHeightsAvx2, aggregateBandsAvx2
+};
+#endif
+
+}
+
+// ==============================
+// ==============================
+
+bool SpectrumKernels::isSupported(Variant variant)
+{
+    if (variant == Variant::SCALAR)
+        return true;
+
+#if defined(SPECTRUM_KERNELS_X86) && defined(__GNUC__)
+    __builtin_cpu_init();
+
+    if (variant == Variant::SSE2)
+        return __builtin_cpu_supports("sse2");
+
+    return __builtin_cpu_supports("avx2");
+#elif defined(SPECTRUM_KERNELS_X86) && defined(_MSC_VER)
+    int info[4];
+
+    __cpuid(info, 0);
+    const int maxLeaf = info[0];
+
+    __cpuid(info, 1);
+
+    if (variant == Variant::SSE2)
+        return (info[3] & (1 << 26)) != 0;
+
+    // AVX activé par le système (registres sauvegardés) puis AVX2
+    const bool osSupport = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && (_xgetbv(0) & 0x6) == 0x6;
+
+    if (!osSupport || maxLeaf < 7)
+        return false;
+
+    __cpuidex(info, 7, 0);
+
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return false;
+#endif
+}
+
+// ==============================
+// ==============================
+
+SpectrumKernels::Variant SpectrumKernels::getBestVariant()
+{
+    if (isSupported(Variant::AVX2))
+        return Variant::AVX2;
+
+    if (isSupported(Variant::SSE2))
+        return Variant::SSE2;
+
+    return Variant::SCALAR;
+}
+
+// ==============================
+// ==============================
+
+const char* SpectrumKernels::getName(Variant variant)
+{
+    switch (variant)
+    {
+        case Variant::SSE2:
+            return "SSE2";
+
+        case Variant::AVX2:
+            return "AVX2";
+
+        default:
+            return "Scalar";
+    }
+}
+
+// ==============================
+// ==============================
+
+const SpectrumKernels::Functions& SpectrumKernels::get()
+{
+    static const Functions& functions = get(getBestVariant());
+    return functions;
+}
+
+// ==============================
+// ==============================
+
+const SpectrumKernels::Functions& SpectrumKernels::get(Variant variant)
+{
+#if defined(SPECTRUM_KERNELS_X86)
+    if (isSupported(variant))
+    {
+        if (variant == Variant::AVX2)
+            return AVX2_FUNCTIONS;
+
+        if (variant == Variant::SSE2)
+            return SSE2_FUNCTIONS;
+    }
+#endif
+
+    return SCALAR_FUNCTIONS;
+}
+
+
+} // audio
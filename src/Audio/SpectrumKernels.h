@@ -0,0 +1,86 @@
+/*************************************
+ * @file    SpectrumKernels.h
+ * @date    17/10/26
+ * @author  Manuel
+ *
+ * Déclarations de la classe SpectrumKernels
+ * contenant les traitements vectorisés
+ * des valeurs du spectre.
+ *************************************
+*/
+
+#ifndef __SPECTRUMKERNELS_H__
+#define __SPECTRUMKERNELS_H__
+
+
+namespace audio {
+
+
+/**
+ * Traitements appliqués à chaque valeur du spectre, en versions SSE2, AVX2 et scalaire.
+ * La variante la plus rapide supportée par le processeur est choisie à l'exécution (get()).
+ * Les buffers n'ont pas besoin d'être alignés.
+ */
+class SpectrumKernels
+{
+    public:
+
+        enum class Variant { SCALAR, SSE2, AVX2 };
+
+        struct Functions
+        {
+            // Moyenne des canaux d'échantillons entrelacés
+            void (*downmix)(const float *in, float *out, unsigned int frames, int channels);
+
+            // Conversion en dB (20 log10), bornée par floorDb
+            void (*toDecibels)(const float *in, float *out, unsigned int size, float floorDb);
+
+            // Multiplication par scale puis limitation à [low, high]
+            void (*scaleClamp)(const float *in, float *out, unsigned int size, float scale, float low, float high);
+
+            // Hauteurs des colonnes : valeur * scale limitée à [0, maxHeight], tronquée
+            void (*toHeights)(const float *in, int *out, unsigned int size, float scale, int maxHeight);
+
+            // Maximum des valeurs de chaque bande [edges[b], edges[b + 1]) (au moins une valeur par bande)
+            void (*aggregateBands)(const float *in, const unsigned int *edges, float *out, unsigned int bandsNb);
+        };
+
+
+        /**
+         * @brief Détermine si le processeur supporte la variante passée en paramètre.
+         * @param variant Variante à tester
+         * @return true si la variante est supportée
+         */
+        static bool isSupported(Variant variant);
+
+        /**
+         * @brief getBestVariant
+         * @return Variante la plus rapide supportée par le processeur.
+         */
+        static Variant getBestVariant();
+
+        /**
+         * @brief getName
+         * @param variant Variante
+         * @return Nom de la variante.
+         */
+        static const char* getName(Variant variant);
+
+        /**
+         * @brief get
+         * @return Traitements de la variante la plus rapide (choisie au premier appel).
+         */
+        static const Functions& get();
+
+        /**
+         * @brief get
+         * @param variant Variante souhaitée (scalaire si elle n'est pas supportée)
+         * @return Traitements de la variante.
+         */
+        static const Functions& get(Variant variant);
+};
+
+
+} // audio
+
+#endif  // __SPECTRUMKERNELS_H__
@@ -0,0 +1,132 @@
+/*************************************
+ * @file    WaveformBuilder.cpp
+ * @date    17/10/26
+ * @author  Manuel
+ *
+ * Définitions de la classe WaveformBuilder.
+ *************************************
+*/
+
+#include "WaveformBuilder.h"
+#include "../Constants.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+
+namespace audio {
+
+
+namespace {
+
+constexpr float MAX_VALUE = std::numeric_limits<float>::max();
+
+inline signed char toPeak(float value)
+{
+    return static_cast<signed char>(std::lround(std::min(std::max(value, -1.0f), 1.0f) * 127.0f));
+}
+
+}
+
+// ==============================
+// ==============================
+
+WaveformBuilder::WaveformBuilder(int sampleRate)
+    : m_BlockSize(std::max(1u, static_cast<unsigned int>(std::max(sampleRate, 1)) * WAVEFORM_BLOCK_TIME / 1000)),
+      m_BlockFrames(0), m_Block({ MAX_VALUE, -MAX_VALUE, 0.0, 0 })
+{
+
+}
+
+// ==============================
+// ==============================
+
+void WaveformBuilder::process(const float *samples, unsigned int frames, int channels)
+{
+    while (frames > 0)
+    {
+        const unsigned int count = std::min(frames, m_BlockSize - m_BlockFrames);
+        const unsigned int samplesNb = count * channels;
+
+        float minimum = m_Block.minimum, maximum = m_Block.maximum;
+        float energy = 0.0f;
+
+        for (unsigned int i = 0; i < samplesNb; i++)
+        {
+            minimum = std::min(minimum, samples[i]);
+            maximum = std::max(maximum, samples[i]);
+            energy += samples[i] * samples[i];
+        }
+
+        m_Block.minimum = minimum;
+        m_Block.maximum = maximum;
+        m_Block.energy += energy;
+        m_Block.samplesNb += samplesNb;
+
+        m_BlockFrames += count;
+        samples += samplesNb;
+        frames -= count;
+
+        if (m_BlockFrames == m_BlockSize)
+            finishBlock();
+    }
+}
+
+// ==============================
+// ==============================
+
+void WaveformBuilder::finishBlock()
+{
+    m_Blocks.push_back(m_Block);
+
+    m_Block = { MAX_VALUE, -MAX_VALUE, 0.0, 0 };
+    m_BlockFrames = 0;
+}
+
+// ==============================
+// ==============================
+
+std::vector<WaveformPoint> WaveformBuilder::finish(unsigned int resolution)
+{
+    if (m_BlockFrames > 0)
+        finishBlock();
+
+    std::vector<WaveformPoint> points;
+
+    if (m_Blocks.empty() || resolution == 0)
+        return points;
+
+    points.resize(resolution);
+
+    const std::size_t blocksNb = m_Blocks.size();
+
+    for (unsigned int p = 0; p < resolution; p++)
+    {
+        // Au moins un bloc par point (répété si le son est plus court que la résolution)
+        std::size_t begin = std::min(p * blocksNb / resolution, blocksNb - 1);
+        std::size_t end = std::max((p + 1) * blocksNb / resolution, begin + 1);
+
+        float minimum = MAX_VALUE, maximum = -MAX_VALUE;
+        double energy = 0.0;
+        unsigned long long samplesNb = 0;
+
+        for (std::size_t b = begin; b < end; b++)
+        {
+            minimum = std::min(minimum, m_Blocks[b].minimum);
+            maximum = std::max(maximum, m_Blocks[b].maximum);
+            energy += m_Blocks[b].energy;
+            samplesNb += m_Blocks[b].samplesNb;
+        }
+
+        const double rms = samplesNb ? std::sqrt(energy / samplesNb) : 0.0;
+
+        points[p].minimum = toPeak(minimum);
+        points[p].maximum = toPeak(maximum);
+        points[p].rms = static_cast<unsigned char>(std::lround(std::min(rms, 1.0) * 255.0));
+    }
+
+    return points;
+}
+
+
+} // audio
@@ -0,0 +1,88 @@
+/*************************************
+ * @file    WaveformBuilder.h
+ * @date    17/10/26
+ * @author  Manuel
+ *
+ * Déclarations de la classe WaveformBuilder
+ * calculant la forme d'onde résumée
+ * d'un son complet.
+ *************************************
+*/
+
+#ifndef __WAVEFORMBUILDER_H__
+#define __WAVEFORMBUILDER_H__
+
+#include <vector>
+
+
+namespace audio {
+
+
+// Point de la forme d'onde : minimum et maximum des échantillons (sur 127), moyenne quadratique (sur 255)
+struct WaveformPoint
+{
+    signed char minimum;
+    signed char maximum;
+    unsigned char rms;
+};
+
+
+/**
+ * Les échantillons de tous les canaux sont résumés par blocs de WAVEFORM_BLOCK_TIME ms
+ * (minimum, maximum, énergie), puis les blocs sont regroupés en une forme d'onde
+ * d'une résolution fixe une fois la durée du son connue (finish).
+ */
+class WaveformBuilder
+{
+    private:
+
+        struct Block
+        {
+            float minimum;
+            float maximum;
+            double energy;
+            unsigned int samplesNb;
+        };
+
+        unsigned int m_BlockSize;
+
+        unsigned int m_BlockFrames;
+
+        Block m_Block;
+
+        std::vector<Block> m_Blocks;
+
+
+        /**
+         * @brief Termine le bloc en cours.
+         */
+        void finishBlock();
+
+    public:
+
+        /**
+         * @brief Crée le calcul de la forme d'onde d'un son.
+         * @param sampleRate Fréquence d'échantillonnage (Hz)
+         */
+        WaveformBuilder(int sampleRate);
+
+        /**
+         * @brief Ajoute des échantillons à la forme d'onde.
+         * @param samples Echantillons entrelacés
+         * @param frames Nombre d'échantillons par canal
+         * @param channels Nombre de canaux
+         */
+        void process(const float *samples, unsigned int frames, int channels);
+
+        /**
+         * @brief Regroupe les échantillons ajoutés en points répartis sur toute la durée du son.
+         * @param resolution Nombre de points
+         * @return Forme d'onde (vide si aucun échantillon n'a été ajouté)
+         */
+        std::vector<WaveformPoint> finish(unsigned int resolution);
+};
+
+
+} // audio
+
+#endif  // __WAVEFORMBUILDER_H__
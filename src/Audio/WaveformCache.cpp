@@ -0,0 +1,168 @@
+/*************************************
+ * @file    WaveformCache.cpp
+ * @date    17/10/26
+ * @author  Manuel
+ *
+ * Définitions de la classe WaveformCache.
+ *************************************
+*/
+
+#include "WaveformCache.h"
+#include "WaveformBuilder.h"
+#include "MetadataCache.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+
+namespace audio {
+
+
+namespace {
+
+constexpr char CACHE_MAGIC[4] = { 'P', 'W', 'F', 'C' };
+constexpr quint32 CACHE_VERSION = 1;
+
+}
+
+// ==============================
+// ==============================
+
+WaveformCache::WaveformCache(const QString& filePath)
+    : m_FilePath(filePath), m_Count(0)
+{
+    static_assert(sizeof(Header) == 16, "Unexpected cache header size");
+    static_assert(sizeof(Record) == 24, "Unexpected cache record size");
+    static_assert(sizeof(WaveformPoint) == 3, "Unexpected waveform point size");
+}
+
+// ==============================
+// ==============================
+
+qint64 WaveformCache::getRecordSize()
+{
+    return sizeof(Record) + WAVEFORM_RESOLUTION * sizeof(WaveformPoint);
+}
+
+// ==============================
+// ==============================
+
+bool WaveformCache::reset()
+{
+    m_Index.clear();
+    m_Count = 0;
+
+    Header header;
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.version = CACHE_VERSION;
+    header.resolution = WAVEFORM_RESOLUTION;
+    header.count = 0;
+
+    return m_File.resize(0) && m_File.seek(0)
+           && m_File.write(reinterpret_cast<const char*>(&header), sizeof(Header)) == sizeof(Header);
+}
+
+// ==============================
+// ==============================
+
+bool WaveformCache::load()
+{
+    if (m_File.isOpen())
+        m_File.close();
+
+    m_Index.clear();
+    m_Count = 0;
+
+    m_File.setFileName(m_FilePath);
+    if (!m_File.open(QIODevice::ReadWrite))
+        return false;
+
+    Header header;
+    if (m_File.read(reinterpret_cast<char*>(&header), sizeof(Header)) != sizeof(Header)
+            || std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0
+            || header.version != CACHE_VERSION || header.resolution != WAVEFORM_RESOLUTION)
+        return reset();
+
+    // Un enregistrement écrit partiellement (arrêt pendant l'écriture) n'est pas compté
+    const quint32 count = std::min<qint64>(header.count, (m_File.size() - sizeof(Header)) / getRecordSize());
+
+    for (quint32 i = 0; i < count; ++i)
+    {
+        Record record;
+
+        if (!m_File.seek(sizeof(Header) + i * getRecordSize())
+                || m_File.read(reinterpret_cast<char*>(&record), sizeof(Record)) != sizeof(Record))
+            return reset();
+
+        m_Index.insert(record.pathHash, i);
+    }
+
+    m_Count = count;
+
+    return true;
+}
+
+// ==============================
+// ==============================
+
+bool WaveformCache::find(const QString& path, qint64 size, qint64 mtime, QByteArray& peaks)
+{
+    auto index = m_Index.constFind(MetadataCache::hashPath(path.toUtf8()));
+
+    if (index == m_Index.constEnd() || !m_File.seek(sizeof(Header) + index.value() * getRecordSize()))
+        return false;
+
+    QByteArray data = m_File.read(getRecordSize());
+    if (data.size() != getRecordSize())
+        return false;
+
+    const Record *record = reinterpret_cast<const Record*>(data.constData());
+    if (record->size != size || record->mtime != mtime)
+        return false;
+
+    peaks = data.mid(sizeof(Record));
+
+    return true;
+}
+
+// ==============================
+// ==============================
+
+bool WaveformCache::insert(const QString& path, qint64 size, qint64 mtime, const QByteArray& peaks)
+{
+    if (!m_File.isOpen() || peaks.size() != static_cast<int>(WAVEFORM_RESOLUTION * sizeof(WaveformPoint)))
+        return false;
+
+    Record record;
+    record.pathHash = MetadataCache::hashPath(path.toUtf8());
+    record.size = size;
+    record.mtime = mtime;
+
+    auto index = m_Index.constFind(record.pathHash);
+    const quint32 position = (index != m_Index.constEnd()) ? index.value() : m_Count;
+
+    if (!m_File.seek(sizeof(Header) + position * getRecordSize())
+            || m_File.write(reinterpret_cast<const char*>(&record), sizeof(Record)) != sizeof(Record)
+            || m_File.write(peaks) != peaks.size())
+        return false;
+
+    /* Nouvel enregistrement : le nombre d'entrées n'est mis à jour qu'une fois la forme d'onde écrite */
+    if (position == m_Count)
+    {
+        const quint32 count = m_Count + 1;
+
+        if (!m_File.seek(offsetof(Header, count))
+                || m_File.write(reinterpret_cast<const char*>(&count), sizeof(count)) != sizeof(count))
+            return false;
+
+        m_Index.insert(record.pathHash, position);
+        m_Count = count;
+    }
+
+    m_File.flush();
+
+    return true;
+}
+
+
+} // audio
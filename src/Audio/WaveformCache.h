@@ -0,0 +1,108 @@
+/*************************************
+ * @file    WaveformCache.h
+ * @date    17/10/26
+ * @author  Manuel
+ *
+ * Déclarations de la classe WaveformCache
+ * conservant sur disque la forme d'onde
+ * de chaque fichier.
+ *************************************
+*/
+
+#ifndef __WAVEFORMCACHE_H__
+#define __WAVEFORMCACHE_H__
+
+#include <QFile>
+#include <QHash>
+#include <QString>
+#include <QByteArray>
+#include "../Constants.h"
+
+
+namespace audio {
+
+
+/**
+ * Format du fichier (little endian) :
+ *  - Header
+ *  - Record[count], de taille fixe : chaque Record est suivi des WAVEFORM_RESOLUTION points
+ *    de la forme d'onde (voir WaveformPoint)
+ * Seul l'index (hash du chemin -> numéro d'enregistrement) est gardé en mémoire : une recherche
+ * est une lecture à une position connue. Les formes d'onde sont ajoutées en fin de fichier,
+ * ou réécrites à leur place, sans réécrire le reste du cache.
+ */
+class WaveformCache
+{
+    private:
+
+        struct Header
+        {
+            char magic[4];
+            quint32 version;
+            quint32 resolution;
+            quint32 count;
+        };
+
+        struct Record
+        {
+            quint64 pathHash;
+            qint64 size;
+            qint64 mtime;
+        };
+
+        QString m_FilePath;
+
+        QFile m_File;
+
+        QHash<quint64, quint32> m_Index;
+
+        quint32 m_Count;
+
+
+        /**
+         * @brief getRecordSize
+         * @return Taille d'un enregistrement et de sa forme d'onde (octets).
+         */
+        static qint64 getRecordSize();
+
+        /**
+         * @brief Vide le fichier et y écrit un header sans enregistrement.
+         * @return true si l'écriture a réussi
+         */
+        bool reset();
+
+    public:
+
+        WaveformCache(const QString& filePath = WAVEFORM_CACHE_FILEPATH);
+
+        /**
+         * @brief Ouvre le fichier du cache (créé s'il n'existe pas) et lit son index.
+         * @return true si le cache est utilisable (un fichier invalide est vidé)
+         */
+        bool load();
+
+        /**
+         * @brief Cherche la forme d'onde du fichier dans le cache.
+         * @param path Chemin canonique du fichier
+         * @param size Taille actuelle du fichier
+         * @param mtime Date de modification actuelle du fichier (ms)
+         * @param peaks Forme d'onde trouvée (WAVEFORM_RESOLUTION points)
+         * @return true si une entrée à jour (taille et date identiques) existe
+         */
+        bool find(const QString& path, qint64 size, qint64 mtime, QByteArray& peaks);
+
+        /**
+         * @brief Ecrit la forme d'onde du fichier dans le cache.
+         * @param path Chemin canonique du fichier
+         * @param size Taille du fichier
+         * @param mtime Date de modification du fichier (ms)
+         * @param peaks Forme d'onde (WAVEFORM_RESOLUTION points)
+         * @return true si l'écriture a réussi
+         */
+        bool insert(const QString& path, qint64 size, qint64 mtime, const QByteArray& peaks);
+};
+
+
+} // audio
+
+#endif  // __WAVEFORMCACHE_H__
@@ -0,0 +1,27 @@
+#-------------------------------------------------
+#
+# Mesure des traitements du spectre (FFT et SpectrumKernels),
+# hors de l'application.
+#
+#-------------------------------------------------
+
+QT       -= core gui
+
+TARGET = SpectrumBenchmark
+TEMPLATE = app
+
+CONFIG += c++14 console
+CONFIG -= app_bundle qt
+
+INCLUDEPATH += ..
+
+# Removal of warnings
+QMAKE_CXXFLAGS_WARN_ON += -Wno-comment
+
+SOURCES += main.cpp \
+    ../Audio/SpectrumKernels.cpp \
+    ../Audio/FftEngine.cpp
+
+HEADERS  += ../Constants.h \
+    ../Audio/SpectrumKernels.h \
+    ../Audio/FftEngine.h
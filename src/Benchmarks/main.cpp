@@ -0,0 +1,144 @@
+/*************************************
+ * @file    main.cpp
+ * @date    17/10/26
+ * @author  Manuel
+ *
+ * Fonction main des benchmarks.
+ * Mesure le calcul d'une trame de FFT puis
+ * compare les variantes des traitements du spectre.
+ *************************************
+*/
+
+#include "Constants.h"
+#include "Audio/SpectrumKernels.h"
+#include "Audio/FftEngine.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+
+namespace {
+
+constexpr unsigned int ITERATIONS = 10000;
+
+
+/**
+ * @brief Mesure la durée moyenne d'un traitement.
+ * @param kernel Traitement à mesurer
+ * @return Durée moyenne d'un appel (ns)
+ */
+template<typename Kernel>
+double measure(Kernel kernel)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    for (unsigned int i = 0; i < ITERATIONS; i++)
+        kernel();
+
+    std::chrono::duration<double, std::nano> duration = std::chrono::steady_clock::now() - start;
+    return duration.count() / ITERATIONS;
+}
+
+// ==============================
+// ==============================
+
+/**
+ * @brief Mesure le calcul d'une trame (fenêtre, FFT, amplitudes et regroupement).
+ * @param fftSize Taille de la FFT
+ * @return Durée moyenne d'une trame (ns)
+ */
+double benchmarkFft(unsigned int fftSize)
+{
+    audio::FftEngine engine(fftSize, SPECTRUM_WIDTH);
+
+    std::vector<float> samples(engine.getFftSize()), output(engine.getOutputSize());
+
+    for (unsigned int i = 0; i < samples.size(); i++)
+        samples[i] = std::sin(i * 0.05f) * 0.5f + std::sin(i * 0.7f) * 0.25f;
+
+    double duration = measure([&]() { engine.transform(samples.data(), output.data()); });
+
+    // Empêche l'élimination des résultats
+    volatile float sink = output[0];
+    (void) sink;
+
+    return duration;
+}
+
+// ==============================
+// ==============================
+
+/**
+ * @brief Mesure chaque traitement d'une variante sur des trames de la taille passée en paramètre.
+ * @param variant Variante à mesurer
+ * @param size Nombre de valeurs par trame
+ */
+void benchmarkKernels(audio::SpectrumKernels::Variant variant, unsigned int size)
+{
+    const audio::SpectrumKernels::Functions& functions = audio::SpectrumKernels::get(variant);
+
+    std::vector<float> samples(2 * size), values(size), output(size);
+    std::vector<int> heights(size);
+
+    // Bandes de largeur croissante, comme une répartition logarithmique
+    std::vector<unsigned int> edges(1, 0);
+
+    for (unsigned int width = 1; edges.back() + width <= size; width *= 2)
+        edges.push_back(edges.back() + width);
+
+    const unsigned int bandsNb = edges.size() - 1;
+    std::vector<float> bands(bandsNb);
+
+    for (unsigned int i = 0; i < samples.size(); i++)
+        samples[i] = std::sin(i * 0.05f) * 0.5f;
+
+    for (unsigned int i = 0; i < size; i++)
+        values[i] = std::fabs(samples[2 * i]) / (1 + i % 64);
+
+    double downmix = measure([&]() { functions.downmix(samples.data(), output.data(), size, 2); });
+    double toDecibels = measure([&]() { functions.toDecibels(values.data(), output.data(), size, -100.0f); });
+    double scaleClamp = measure([&]() { functions.scaleClamp(values.data(), output.data(), size, 15.0f, 0.0f, 1.0f); });
+    double toHeights = measure([&]() { functions.toHeights(values.data(), heights.data(), size, 6000.0f, 400); });
+    double aggregateBands = measure([&]() { functions.aggregateBands(values.data(), edges.data(), bands.data(), bandsNb); });
+
+    // Empêche l'élimination des résultats
+    volatile float sink = output[0] + bands[0] + heights[0];
+    (void) sink;
+
+    std::printf("%-7s | %4u | %7.1f | %8.1f | %10.1f | %7.1f | %5.1f\n", audio::SpectrumKernels::getName(variant), size,
+                downmix, toDecibels, scaleClamp, toHeights, aggregateBands);
+}
+
+}
+
+// ==============================
+// ==============================
+
+int main()
+{
+    using audio::SpectrumKernels;
+
+    const SpectrumKernels::Variant variants[] = { SpectrumKernels::Variant::SCALAR,
+                                                  SpectrumKernels::Variant::SSE2,
+                                                  SpectrumKernels::Variant::AVX2 };
+
+    for (unsigned int fftSize = 512; fftSize <= 8192; fftSize *= 2)
+        std::printf("FFT %u -> %u : %.1f ns/frame\n", fftSize, SPECTRUM_WIDTH, benchmarkFft(fftSize));
+
+    std::printf("Best variant: %s\n", SpectrumKernels::getName(SpectrumKernels::getBestVariant()));
+    std::printf("Variant | Size | Downmix | Decibels | ScaleClamp | Heights | Bands (ns/frame)\n");
+
+    for (unsigned int size = 512; size <= 8192; size *= 2)
+    {
+        for (SpectrumKernels::Variant variant : variants)
+        {
+            if (SpectrumKernels::isSupported(variant))
+                benchmarkKernels(variant, size);
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
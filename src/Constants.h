@@ -24,6 +24,10 @@ constexpr unsigned int REFRESH_TIME_MS = 50;
 constexpr const char* BUTTONS_SUBDIR    = IMAGES_SUBDIR "Buttons/";
 constexpr const char* MENU_SUBDIR       = IMAGES_SUBDIR "Menu/";
 constexpr const char* PROFILE_FILEPATH  = "../profile.json";
+constexpr const char* METADATA_CACHE_FILEPATH = "../metadata.cache";
+constexpr const char* LOUDNESS_CACHE_FILEPATH = "../loudness.cache";
+constexpr const char* WAVEFORM_CACHE_FILEPATH = "../waveform.cache";
+constexpr const char* SEEK_INDEX_CACHE_FILEPATH = "../seekindex.cache";
 
 
 /*******************************
@@ -49,6 +53,56 @@ constexpr unsigned int MAX_CHANNELS_NB  = 8;
 constexpr unsigned int NB_VOLUME_STATES = 9;
 constexpr unsigned int MUTE_STATE       = NB_VOLUME_STATES;
 
+// Pool de canaux : nombre maximal de canaux par rôle et priorité de chaque rôle
+// (un canal occupé n'est libéré que pour un rôle plus prioritaire)
+constexpr unsigned int VOICE_LIMIT_NEXT         = 1;
+constexpr unsigned int VOICE_LIMIT_PREVIEW      = 1;
+constexpr unsigned int VOICE_LIMIT_CROSSFADE    = 2;
+constexpr unsigned int VOICE_LIMIT_PROBE        = 8;
+constexpr unsigned int VOICE_PRIORITY_MAIN      = 4;
+constexpr unsigned int VOICE_PRIORITY_NEXT      = 3;
+constexpr unsigned int VOICE_PRIORITY_PREVIEW   = 2;
+constexpr unsigned int VOICE_PRIORITY_CROSSFADE = 1;
+constexpr unsigned int VOICE_PRIORITY_PROBE     = 0;
+
+// Chargement en mémoire plutôt qu'en stream : taille des fichiers toujours décodés en mémoire (octets),
+// nombre d'ouvertures à partir duquel un fichier est gardé compressé en mémoire, taille des fichiers
+// toujours lus en stream (octets) et mémoire maximale des sons chargés par défaut (Mo, voir le profil)
+constexpr unsigned int SAMPLE_SMALL_FILE_SIZE   = 1048576;
+constexpr unsigned int SAMPLE_REPLAY_COUNT      = 3;
+constexpr unsigned int SAMPLE_LARGE_FILE_SIZE   = 16777216;
+constexpr unsigned int SAMPLE_DEFAULT_BUDGET    = 64;
+constexpr unsigned int SAMPLE_OPEN_COUNTS_NB    = 256;
+
+// Avance avec laquelle la musique suivante est ouverte pour être enchaînée sans blanc (ms)
+constexpr unsigned int GAPLESS_PRELOAD_TIME         = 3000;
+constexpr unsigned int GAPLESS_REMOTE_PRELOAD_TIME  = 10000;
+
+// Fondu enchaîné : durée par défaut et durées proposées dans le menu (ms, 0 : désactivé),
+// nombre de segments des courbes et remplissage minimal du buffer d'un stream distant pour le fondre (%)
+constexpr unsigned int CROSSFADE_DEFAULT_TIME       = 0;
+constexpr unsigned int CROSSFADE_MENU_TIMES[]       = { 0, 2000, 5000, 10000 };
+constexpr unsigned int CROSSFADE_CURVE_POINTS       = 16;
+constexpr unsigned int CROSSFADE_REMOTE_BUFFER      = 50;
+
+// Période de mise à jour du thread audio (ms), taille de sa file de commandes (puissance de 2),
+// nombre d'ouvertures en attente (puissance de 2) et capacité réservée pour leur chemin
+constexpr unsigned int AUDIO_UPDATE_TIME_MS         = 10;
+constexpr unsigned int AUDIO_COMMANDS_NB            = 64;
+constexpr unsigned int AUDIO_OPEN_SLOTS_NB          = 8;
+constexpr unsigned int AUDIO_PATH_CAPACITY          = 1024;
+
+
+/*******************************
+/** Chargement des musiques
+/*******************************/
+
+// Nombre de threads lisant les fichiers (0 : nombre de coeurs, 1 : lecture séquentielle)
+constexpr unsigned int SCAN_THREADS_NB  = 0;
+
+// Délai de regroupement des modifications du répertoire surveillé (ms)
+constexpr unsigned int LIBRARY_WATCH_DELAY = 500;
+
 
 /*******************************
 /** Paramètres du spectre
@@ -58,6 +112,58 @@ constexpr unsigned int SPECTRUM_WIDTH   = 512;
 constexpr unsigned int SPECTRUM_HEIGHT  = 400;
 constexpr int SPECTRUM_RATIO            = 15;
 
+// Taille de la FFT du spectre (puissance de 2) et recouvrement des trames successives
+constexpr unsigned int SPECTRUM_FFT_SIZE = 2048;
+constexpr float SPECTRUM_OVERLAP = 0.5f;
+
+// Spectre en bandes logarithmiques : lissage (part de l'écart rattrapée à chaque trame)
+// et marqueurs de crête (maintien en trames, chute en part de la hauteur par trame)
+constexpr unsigned int SPECTRUM_BANDS_NB  = 64;
+constexpr float SPECTRUM_ATTACK           = 0.7f;
+constexpr float SPECTRUM_RELEASE          = 0.2f;
+constexpr unsigned int SPECTRUM_PEAK_HOLD = 20;
+constexpr float SPECTRUM_PEAK_DECAY       = 0.01f;
+
+// Spectres en attente entre le DSP et le thread audio, le temps que le son correspondant
+// soit entendu (puissance de 2, plus que la latence de sortie de FMOD)
+constexpr unsigned int SPECTRUM_FRAMES_NB = 16;
+
+
+/*******************************
+/** Normalisation du volume
+/*******************************/
+
+// Loudness visée (LUFS), true peak maximal après gain (dBTP) et gain maximal (dB)
+constexpr float LOUDNESS_TARGET         = -18.0f;
+constexpr float LOUDNESS_MAX_TRUE_PEAK  = -1.0f;
+constexpr float LOUDNESS_MAX_GAIN       = 12.0f;
+
+// Analyse en arrière-plan : échantillons décodés par bloc, pause entre deux blocs (ms)
+// et attente tant que la lecture est prioritaire (chargement, stream distant, preview) (ms)
+constexpr unsigned int LOUDNESS_DECODE_FRAMES   = 65536;
+constexpr unsigned int LOUDNESS_IDLE_TIME       = 2;
+constexpr unsigned int LOUDNESS_THROTTLE_TIME   = 200;
+
+
+/*******************************
+/** Forme d'onde
+/*******************************/
+
+// Durée résumée par chaque bloc pendant le décodage (ms) et nombre de points conservés par musique
+constexpr unsigned int WAVEFORM_BLOCK_TIME  = 10;
+constexpr unsigned int WAVEFORM_RESOLUTION  = 1024;
+
+
+/*******************************
+/** Index de déplacement
+/*******************************/
+
+// Durée entre deux entrées de l'index d'un fichier à débit variable (ms)
+constexpr unsigned int SEEK_INDEX_INTERVAL  = 100;
+
+// Données renvoyées avec la réponse à un déplacement dans un fichier distant (octets)
+constexpr unsigned int SEEK_PREFETCH_SIZE   = 16384;
+
 
 /*******************************
 /** Propriétés des éléments
@@ -83,6 +189,11 @@ constexpr unsigned int PREVIEW_DELAY                = 2000;
 constexpr unsigned int PREVIEW_LENGTH               = 30000;
 constexpr unsigned int PREVIEW_ANIMATION_LENGTH     = 1000;
 
+// Recherche de la section la plus forte du début du fichier (ms)
+constexpr unsigned int PREVIEW_SCAN_LENGTH          = 120000;
+constexpr unsigned int PREVIEW_SCAN_STEP            = 500;
+constexpr unsigned int PREVIEW_SCAN_WINDOW          = 10000;
+
 // Boutons prev/next
 constexpr unsigned int BUTTON_DELAY                 = 500;
 constexpr unsigned int MOVE_INTERVAL                = 1000;
@@ -0,0 +1,114 @@
+/*************************************
+ * @file    AudioStatusDialog.cpp
+ * @date    17/10/26
+ * @author  Manuel
+ *
+ * Définitions de la classe AudioStatusDialog.
+ *************************************
+*/
+
+#include "AudioStatusDialog.h"
+#include <QVBoxLayout>
+#include <QGroupBox>
+#include <QHeaderView>
+#include <QFileInfo>
+#include <QPushButton>
+
+
+namespace gui {
+
+
+AudioStatusDialog::AudioStatusDialog(QWidget *parent) : QDialog(parent)
+{
+    QVBoxLayout *dialogLayout = new QVBoxLayout;
+
+    QGroupBox *voicesBox = new QGroupBox("Canaux");
+    QVBoxLayout *voicesLayout = new QVBoxLayout;
+
+    mp_Voices = new QTreeWidget;
+    mp_Voices->setRootIsDecorated(false);
+    mp_Voices->setHeaderLabels({ "Canal", "Rôle", "Priorité", "Etat", "Mémoire (Ko)", "Echantillons/s" });
+
+    voicesLayout->addWidget(mp_Voices);
+    voicesBox->setLayout(voicesLayout);
+
+    QGroupBox *residentBox = new QGroupBox("Sons chargés en mémoire");
+    QVBoxLayout *residentLayout = new QVBoxLayout;
+
+    mp_ResidentSounds = new QTreeWidget;
+    mp_ResidentSounds->setRootIsDecorated(false);
+    mp_ResidentSounds->setHeaderLabels({ "Fichier", "Mémoire (Ko)", "Format", "Etat", "Ouvertures" });
+    mp_ResidentSounds->header()->setSectionResizeMode(0, QHeaderView::Stretch);
+    mp_ResidentSounds->setMinimumWidth(500);
+
+    residentLayout->addWidget(mp_ResidentSounds);
+    residentBox->setLayout(residentLayout);
+
+    QPushButton *closeButton = new QPushButton("Fermer");
+    closeButton->setDefault(true);
+    connect(closeButton, &QPushButton::clicked, this, &AudioStatusDialog::close);
+
+    dialogLayout->addWidget(voicesBox);
+    dialogLayout->addWidget(residentBox);
+    dialogLayout->addWidget(closeButton, 0, Qt::AlignHCenter);
+
+    setLayout(dialogLayout);
+}
+
+// ==============================
+// ==============================
+
+void AudioStatusDialog::setVoices(const std::vector<audio::FmodManager::VoiceInfo>& voices)
+{
+    mp_Voices->clear();
+
+    for (const audio::FmodManager::VoiceInfo& voice : voices)
+    {
+        QString role;
+
+        switch (voice.role)
+        {
+            case audio::VoiceRole::MAIN:        role = "Principal";         break;
+            case audio::VoiceRole::NEXT:        role = "Suivant";           break;
+            case audio::VoiceRole::PREVIEW:     role = "Preview";           break;
+            case audio::VoiceRole::CROSSFADE:   role = "Fondu";             break;
+            case audio::VoiceRole::PROBE:       role = "Lecture de durée";  break;
+        }
+
+        QString state = voice.loading ? "Ouverture" : (voice.playing ? "Lecture" : "Arrêt");
+
+        QTreeWidgetItem *item = new QTreeWidgetItem({ (voice.id == audio::FmodManager::NO_VOICE_ID) ? "-" : QString::number(voice.id),
+                                                      role,
+                                                      QString::number(voice.priority),
+                                                      state,
+                                                      QString::number(voice.memory / 1024),
+                                                      QString::number(voice.cpuCost) });
+
+        mp_Voices->addTopLevelItem(item);
+    }
+}
+
+// ==============================
+// ==============================
+
+void AudioStatusDialog::setResidentSounds(const std::vector<audio::FmodManager::ResidentInfo>& residents)
+{
+    mp_ResidentSounds->clear();
+
+    for (const audio::FmodManager::ResidentInfo& resident : residents)
+    {
+        QString state = resident.loading ? "Chargement" : (resident.used ? "Utilisé" : "Libre");
+
+        QTreeWidgetItem *item = new QTreeWidgetItem({ QFileInfo(QString::fromStdString(resident.file)).fileName(),
+                                                      QString::number(resident.memory / 1024),
+                                                      resident.compressed ? "Compressé" : "PCM",
+                                                      state,
+                                                      QString::number(resident.opens) });
+
+        item->setToolTip(0, QString::fromStdString(resident.file));
+        mp_ResidentSounds->addTopLevelItem(item);
+    }
+}
+
+
+} // gui
@@ -0,0 +1,51 @@
+/*************************************
+ * @file    AudioStatusDialog.h
+ * @date    17/10/26
+ * @author  Manuel
+ *
+ * Déclarations de la classe AudioStatusDialog
+ * définissant la fenêtre d'état du moteur audio.
+ *************************************
+*/
+
+#ifndef __AUDIOSTATUSDIALOG_H__
+#define __AUDIOSTATUSDIALOG_H__
+
+#include <QDialog>
+#include <QTreeWidget>
+#include <vector>
+#include "../Audio/FmodManager.h"
+
+
+namespace gui {
+
+
+class AudioStatusDialog : public QDialog
+{
+    private:
+
+        QTreeWidget *mp_Voices;
+        QTreeWidget *mp_ResidentSounds;
+
+    public:
+
+        AudioStatusDialog(QWidget *parent = nullptr);
+        virtual ~AudioStatusDialog() = default;
+
+        /**
+         * @brief Affiche les canaux du pool.
+         * @param voices Canaux actifs et lectures de durée (voir FmodManager::getVoices)
+         */
+        void setVoices(const std::vector<audio::FmodManager::VoiceInfo>& voices);
+
+        /**
+         * @brief Affiche les sons chargés en mémoire.
+         * @param residents Sons chargés en mémoire (voir FmodManager::getResidentSounds)
+         */
+        void setResidentSounds(const std::vector<audio::FmodManager::ResidentInfo>& residents);
+};
+
+
+} // gui
+
+#endif  // __AUDIOSTATUSDIALOG_H__
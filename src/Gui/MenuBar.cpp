@@ -10,6 +10,7 @@
 #include "MenuBar.h"
 #include "Constants.h"
 #include "../Util/Tools.h"
+#include "../Audio/FmodManager.h"
 
 
 namespace gui {
@@ -31,10 +32,47 @@ MenuBar::MenuBar(QWidget *parent) : QMenuBar(parent)
     // Menu "Options"
     mp_OpenConnectionAction = optionsMenu->addAction(QIcon(util::Tools::loadImage(QString(MENU_SUBDIR) + "connection.png")), "Fenêtre de connexion");
     mp_ChangeSpectrumColorAction = optionsMenu->addAction(QIcon(util::Tools::loadImage(QString(MENU_SUBDIR) + "color.png")), "Couleurs du spectre");
+    mp_SpectrumBandsAction = optionsMenu->addAction("Spectre en bandes");
+    mp_WaveformAction = optionsMenu->addAction("Forme d'onde");
     mp_ProfileAction = optionsMenu->addAction(QIcon(util::Tools::loadImage(QString(MENU_SUBDIR) + "profile.png")), "Profil");
 
+    // Sous-menu "Fondu enchaîné"
+    QMenu *crossfadeMenu = optionsMenu->addMenu("Fondu enchaîné");
+
+    mp_CrossfadeTimeGroup = new QActionGroup(this);
+
+    for (unsigned int time : CROSSFADE_MENU_TIMES)
+    {
+        QAction *timeAction = crossfadeMenu->addAction((time == 0) ? QString("Désactivé") : QString::number(time / 1000) + " s");
+        timeAction->setCheckable(true);
+        timeAction->setData(time);
+        mp_CrossfadeTimeGroup->addAction(timeAction);
+    }
+
+    crossfadeMenu->addSeparator();
+    mp_CrossfadeCurveGroup = new QActionGroup(this);
+
+    QAction *linearAction = crossfadeMenu->addAction("Courbe linéaire");
+    linearAction->setData(static_cast<unsigned int>(audio::FadeCurve::LINEAR));
+    QAction *equalPowerAction = crossfadeMenu->addAction("Courbe à puissance constante");
+    equalPowerAction->setData(static_cast<unsigned int>(audio::FadeCurve::EQUAL_POWER));
+
+    for (QAction *curveAction : { linearAction, equalPowerAction })
+    {
+        curveAction->setCheckable(true);
+        mp_CrossfadeCurveGroup->addAction(curveAction);
+    }
+
+    crossfadeMenu->addSeparator();
+    mp_SkipUnbufferedCrossfadeAction = crossfadeMenu->addAction("Sans fondu si la musique distante n'est pas chargée");
+    mp_SkipUnbufferedCrossfadeAction->setCheckable(true);
+
     // Menu "Aide"
     mp_AboutAction = helpMenu->addAction(QIcon(util::Tools::loadImage(QString(MENU_SUBDIR) + "about.png")), "A propos");
+    mp_AudioStatusAction = helpMenu->addAction("Etat du moteur audio");
+
+    mp_SpectrumBandsAction->setCheckable(true);
+    mp_WaveformAction->setCheckable(true);
 
     mp_AddingSongAction->setShortcut(QKeySequence("Ctrl+N"));
     mp_OpenAction->setShortcut(QKeySequence("Ctrl+O"));
@@ -85,6 +123,22 @@ QAction* MenuBar::getChangeSpectrumColorAction() const
 // ==============================
 // ==============================
 
+QAction* MenuBar::getSpectrumBandsAction() const
+{
+    return mp_SpectrumBandsAction;
+}
+
+// ==============================
+// ==============================
+
+QAction* MenuBar::getWaveformAction() const
+{
+    return mp_WaveformAction;
+}
+
+// ==============================
+// ==============================
+
 QAction* MenuBar::getProfileAction() const
 {
     return mp_ProfileAction;
@@ -93,10 +147,42 @@ QAction* MenuBar::getProfileAction() const
 // ==============================
 // ==============================
 
+QActionGroup* MenuBar::getCrossfadeTimeGroup() const
+{
+    return mp_CrossfadeTimeGroup;
+}
+
+// ==============================
+// ==============================
+
+QActionGroup* MenuBar::getCrossfadeCurveGroup() const
+{
+    return mp_CrossfadeCurveGroup;
+}
+
+// ==============================
+// ==============================
+
+QAction* MenuBar::getSkipUnbufferedCrossfadeAction() const
+{
+    return mp_SkipUnbufferedCrossfadeAction;
+}
+
+// ==============================
+// ==============================
+
 QAction* MenuBar::getAboutAction() const
 {
     return mp_AboutAction;
 }
 
+// ==============================
+// ==============================
+
+QAction* MenuBar::getAudioStatusAction() const
+{
+    return mp_AudioStatusAction;
+}
+
 
 } // gui
@@ -13,6 +13,7 @@
 
 #include <QMenuBar>
 #include <QAction>
+#include <QActionGroup>
 
 
 namespace gui {
@@ -30,12 +31,24 @@ class MenuBar : public QMenuBar
 
         QAction *mp_AboutAction;
 
+        QAction *mp_AudioStatusAction;
+
         QAction *mp_OpenConnectionAction;
 
         QAction *mp_ChangeSpectrumColorAction;
 
+        QAction *mp_SpectrumBandsAction;
+
+        QAction *mp_WaveformAction;
+
         QAction *mp_ProfileAction;
 
+        QActionGroup *mp_CrossfadeTimeGroup;
+
+        QActionGroup *mp_CrossfadeCurveGroup;
+
+        QAction *mp_SkipUnbufferedCrossfadeAction;
+
     public:
 
         MenuBar(QWidget *parent = nullptr);
@@ -71,17 +84,53 @@ class MenuBar : public QMenuBar
          */
         QAction* getChangeSpectrumColorAction() const;
 
+        /**
+         * @brief getSpectrumBandsAction
+         * @return Retourne le bouton (cochable) d'affichage du spectre en bandes.
+         */
+        QAction* getSpectrumBandsAction() const;
+
+        /**
+         * @brief getWaveformAction
+         * @return Retourne le bouton (cochable) d'affichage de la forme d'onde dans la barre de progression.
+         */
+        QAction* getWaveformAction() const;
+
         /**
          * @brief getProfileAction
          * @return Retourne le bouton de visualisation du profil.
          */
         QAction* getProfileAction() const;
 
+        /**
+         * @brief getCrossfadeTimeGroup
+         * @return Retourne les durées du fondu enchaîné (durée en ms dans data()).
+         */
+        QActionGroup* getCrossfadeTimeGroup() const;
+
+        /**
+         * @brief getCrossfadeCurveGroup
+         * @return Retourne les courbes du fondu enchaîné (audio::FadeCurve dans data()).
+         */
+        QActionGroup* getCrossfadeCurveGroup() const;
+
+        /**
+         * @brief getSkipUnbufferedCrossfadeAction
+         * @return Retourne le bouton "Sans fondu si la musique distante n'est pas chargée".
+         */
+        QAction* getSkipUnbufferedCrossfadeAction() const;
+
         /**
          * @brief getAboutAction
          * @return Retourne le bouton "A propos".
          */
         QAction* getAboutAction() const;
+
+        /**
+         * @brief getAudioStatusAction
+         * @return Retourne le bouton "Etat du moteur audio".
+         */
+        QAction* getAudioStatusAction() const;
 };
 
 
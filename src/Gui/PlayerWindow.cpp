@@ -24,6 +24,7 @@
 #include <QMessageBox>
 #include "PlayerToggleButton.h"
 #include "AboutDialog.h"
+#include "AudioStatusDialog.h"
 #include "SpectrumColorDialog.h"
 #include "ProfileDialog.h"
 
@@ -39,6 +40,9 @@ PlayerWindow::PlayerWindow(QWidget *parent)
     resize(WINDOW_WIDTH, WINDOW_HEIGHT);
 
     connect(&m_Player, &audio::Player::songChanged, this, &PlayerWindow::updateCurrentSong);
+    connect(&m_Player, &audio::Player::waveformChanged, this, &PlayerWindow::updateWaveform);
+    connect(&m_Player, &audio::Player::songLoaded, this, &PlayerWindow::updateLoadedSong);
+    connect(&m_Player, &audio::Player::pictureChanged, this, &PlayerWindow::updateSongPicture);
     connect(&m_Player, &audio::Player::stateChanged, this, &PlayerWindow::setState);
     connect(&m_Player, &audio::Player::previewFinished, this, &PlayerWindow::stopPreview);
 
@@ -55,6 +59,17 @@ PlayerWindow::PlayerWindow(QWidget *parent)
     connect(mp_SongList, &SongList::songPressed, &m_Player, qOverload<audio::Player::SongId>(&audio::Player::changeSong));
     connect(mp_SongList, &SongList::songRemoved, &m_Player, &audio::Player::removeSong);
     connect(&m_Player, &audio::Player::streamError, mp_SongList, &SongList::disableSong);
+    connect(&m_Player, &audio::Player::directorySongAdded, mp_SongList, &SongList::insertSong);
+    connect(&m_Player, &audio::Player::directorySongRemoved, mp_SongList, &SongList::deleteSong);
+
+    // Profil chargé avant le menu, qui affiche ses options
+    if (!m_ProfileManager.load())
+        QMessageBox::warning(this, "Erreur de chargement", "Le profil n'a pas pu être chargé.");
+
+    m_Player.setSampleBudget(m_ProfileManager.getSampleBudget());
+    m_Player.setCrossfadeTime(m_ProfileManager.getCrossfadeTime());
+    m_Player.setCrossfadeCurve(static_cast<audio::FadeCurve>(m_ProfileManager.getCrossfadeCurve()));
+    m_Player.setSkipUnbufferedCrossfade(m_ProfileManager.isSkippingUnbufferedCrossfade());
 
     createMenuBar();
     createOptionsBar();
@@ -67,9 +82,6 @@ PlayerWindow::PlayerWindow(QWidget *parent)
     connect(&m_ConnectionDialog, &ConnectionDialog::canceled, this, &PlayerWindow::closeConnection);
     connect(&m_ConnectionDialog, &ConnectionDialog::disconnected, this, &PlayerWindow::closeConnection);
 
-    if (!m_ProfileManager.load())
-        QMessageBox::warning(this, "Erreur de chargement", "Le profil n'a pas pu être chargé.");
-
     /** Démarrage du player **/
 
     refreshSongsList();
@@ -85,6 +97,7 @@ PlayerWindow::~PlayerWindow()
         closeConnection();
 
     m_Player.stop();
+    m_Player.stopAudioThread();
     audio::FmodManager::deleteInstance();
 
     if (!mp_SongList->parent())
@@ -125,9 +138,37 @@ void PlayerWindow::createMenuBar()
     connect(menuBar->getOpenAction(), &QAction::triggered, this, &PlayerWindow::openSongsDir);
     connect(menuBar->getOpenConnectionAction(), &QAction::triggered, this, &PlayerWindow::openConnection);
     connect(menuBar->getChangeSpectrumColorAction(), &QAction::triggered, this, &PlayerWindow::openSpectrumColorDialog);
+    connect(menuBar->getSpectrumBandsAction(), &QAction::toggled, [this](bool enabled) { mp_Spectrum->setBandsEnabled(enabled); });
+    connect(menuBar->getWaveformAction(), &QAction::toggled, [this](bool enabled) {
+        mp_ProgressBar->setWaveformEnabled(enabled);
+        updateWaveform();
+    });
     connect(menuBar->getProfileAction(), &QAction::triggered, this, &PlayerWindow::openProfileDialog);
 
+    // Options du fondu enchaîné, enregistrées dans le profil
+    for (QAction *action : menuBar->getCrossfadeTimeGroup()->actions())
+        action->setChecked(action->data().toUInt() == m_ProfileManager.getCrossfadeTime());
+
+    for (QAction *action : menuBar->getCrossfadeCurveGroup()->actions())
+        action->setChecked(action->data().toUInt() == m_ProfileManager.getCrossfadeCurve());
+
+    menuBar->getSkipUnbufferedCrossfadeAction()->setChecked(m_ProfileManager.isSkippingUnbufferedCrossfade());
+
+    connect(menuBar->getCrossfadeTimeGroup(), &QActionGroup::triggered, [this](QAction *action) {
+        m_Player.setCrossfadeTime(action->data().toUInt());
+        m_ProfileManager.setCrossfadeTime(action->data().toUInt());
+    });
+    connect(menuBar->getCrossfadeCurveGroup(), &QActionGroup::triggered, [this](QAction *action) {
+        m_Player.setCrossfadeCurve(static_cast<audio::FadeCurve>(action->data().toUInt()));
+        m_ProfileManager.setCrossfadeCurve(action->data().toUInt());
+    });
+    connect(menuBar->getSkipUnbufferedCrossfadeAction(), &QAction::toggled, [this](bool skip) {
+        m_Player.setSkipUnbufferedCrossfade(skip);
+        m_ProfileManager.setSkipUnbufferedCrossfade(skip);
+    });
+
     connect(menuBar->getAboutAction(), &QAction::triggered, this, &PlayerWindow::openInformation);
+    connect(menuBar->getAudioStatusAction(), &QAction::triggered, this, &PlayerWindow::openAudioStatus);
     connect(menuBar->getQuitAction(), &QAction::triggered, qApp, &QApplication::quit);
 
     setMenuBar(menuBar);
@@ -494,6 +535,15 @@ void PlayerWindow::setState(PlayerState state)
 // ==============================
 // ==============================
 
+void PlayerWindow::updateWaveform()
+{
+    // La forme d'onde n'est calculée que si elle est affichée
+    mp_ProgressBar->setWaveform(mp_ProgressBar->isWaveformEnabled() ? m_Player.getWaveform() : QByteArray());
+}
+
+// ==============================
+// ==============================
+
 void PlayerWindow::updateCurrentSong()
 {
     if (m_CurrentMode != PlayerMode::MINIATURE)
@@ -504,6 +554,8 @@ void PlayerWindow::updateCurrentSong()
         mp_NetworkLoadBar->setStartPos(0);
     }
 
+    updateWaveform();
+
     if (m_Player.getCurrentSong())
     {
         mp_SongTitle->setText(m_Player.getCurrentSong()->getTitle());
@@ -511,26 +563,22 @@ void PlayerWindow::updateCurrentSong()
 
         if (m_CurrentMode != PlayerMode::MINIATURE)
         {
-            if (m_Player.getCurrentSong()->isAvailable())
-            {
-                mp_SongPicture->setPixmap(m_Player.getCurrentSong()->buildPicture());
-
-                if (!mp_SongPicture->pixmap()->isNull() && mp_SongPicture->pixmap()->width() > 400)
-                    mp_SongPicture->setPixmap(mp_SongPicture->pixmap()->scaledToWidth(400));
-            }
-
-            if (!mp_SongPicture->pixmap() || mp_SongPicture->pixmap()->isNull())
-                mp_SongPicture->setPixmap(m_DefaultSongPicture);
-
             mp_ProgressBar->setMaximum(m_Player.getCurrentSong()->getLength());
-
-            if (m_Player.getCurrentSong()->isRemote())
-                mp_NetworkLoadBar->setMaximum(mp_Socket->getTotalCurrentSongData());
-
             mp_SongList->setCurrentSong(m_Player.getCurrentSong()->getId());
         }
 
-        mp_SongLength->setText(util::Tools::msToString(m_Player.getCurrentSong()->getLength()));
+        // Le reste de l'interface est mis à jour une fois la musique ouverte
+        if (m_Player.isLoading())
+        {
+            if (m_CurrentMode != PlayerMode::MINIATURE)
+                mp_SongPicture->setPixmap(m_DefaultSongPicture);
+
+            mp_SongLength->setText("Chargement...");
+        }
+        else
+        {
+            updateLoadedSong();
+        }
     }
     else
     {
@@ -550,6 +598,49 @@ void PlayerWindow::updateCurrentSong()
 // ==============================
 // ==============================
 
+void PlayerWindow::updateLoadedSong()
+{
+    if (!m_Player.getCurrentSong())
+        return;
+
+    if (m_CurrentMode != PlayerMode::MINIATURE)
+    {
+        updateSongPicture();
+
+        if (m_Player.getCurrentSong()->isRemote())
+            mp_NetworkLoadBar->setMaximum(mp_Socket->getTotalCurrentSongData());
+    }
+
+    mp_SongLength->setText(util::Tools::msToString(m_Player.getCurrentSong()->getLength()));
+}
+
+// ==============================
+// ==============================
+
+void PlayerWindow::updateSongPicture()
+{
+    if (!m_Player.getCurrentSong() || m_CurrentMode == PlayerMode::MINIATURE)
+        return;
+
+    mp_SongPicture->clear();
+
+    // Pochette lue par le thread audio : l'image par défaut est affichée en attendant
+    if (m_Player.getCurrentSong()->isAvailable() && !m_Player.getPicture().isNull())
+    {
+        mp_SongPicture->setPixmap(m_Player.getPicture());
+
+        if (mp_SongPicture->pixmap()->width() > 400)
+            mp_SongPicture->setPixmap(mp_SongPicture->pixmap()->scaledToWidth(400));
+    }
+    else
+    {
+        mp_SongPicture->setPixmap(m_DefaultSongPicture);
+    }
+}
+
+// ==============================
+// ==============================
+
 void PlayerWindow::refreshSongsList()
 {
     mp_SongList->clearList(SongList_t::DIRECTORY_SONGS);
@@ -645,7 +736,7 @@ void PlayerWindow::setSongPosition(double value)
     {
         audio::SoundPos_t pos = value * m_Player.getCurrentSong()->getLength() / 100;
 
-        m_Player.getCurrentSong()->setPosition(pos);
+        m_Player.setPosition(pos);
         mp_SongPos->setText(util::Tools::msToString(pos));
 
         if (m_CurrentMode != PlayerMode::MINIATURE)
@@ -666,7 +757,7 @@ void PlayerWindow::setSongPosition(double value)
 
 void PlayerWindow::moveSongPosition(int offset)
 {
-    int newAudioPos = m_Player.getCurrentSong()->getPosition() + offset;
+    int newAudioPos = m_Player.getPosition() + offset;
 
     double newPos = newAudioPos * 100.0 / m_Player.getCurrentSong()->getLength();
     newPos = std::max(0.0, std::min(newPos, 100.0));
@@ -724,6 +815,22 @@ void PlayerWindow::openInformation()
 // ==============================
 // ==============================
 
+void PlayerWindow::openAudioStatus()
+{
+    AudioStatusDialog statusWindow(this);
+    statusWindow.setWindowTitle("Etat du moteur audio");
+
+    // Etat relevé par le thread audio, affiché à sa réception
+    connect(&m_Player, &audio::Player::voicesRead, &statusWindow, &AudioStatusDialog::setVoices);
+    connect(&m_Player, &audio::Player::residentSoundsRead, &statusWindow, &AudioStatusDialog::setResidentSounds);
+
+    m_Player.requestAudioStatus();
+    statusWindow.exec();
+}
+
+// ==============================
+// ==============================
+
 void PlayerWindow::openConnection()
 {
     m_ConnectionDialog.exec();
@@ -858,21 +965,22 @@ void PlayerWindow::timerEvent(QTimerEvent *event)
     }
 
     m_Player.update();
+    m_Player.setSpectrumEnabled(m_Player.isPlaying() && m_CurrentMode != PlayerMode::MINIATURE && mp_Spectrum->isDisplayed());
 
     if (m_Player.isPlaying())
     {
         if (m_CurrentMode != PlayerMode::MINIATURE)
         {
-            if (mp_Spectrum->isVisible())
-                mp_Spectrum->updateValues(m_Player.getCurrentSong()->getSoundID());
+            if (mp_Spectrum->isDisplayed() && m_Player.getSpectrum(m_SpectrumFrame))
+                mp_Spectrum->updateValues(m_SpectrumFrame);
 
-            mp_ProgressBar->setPosition(m_Player.getCurrentSong()->getPosition());
+            mp_ProgressBar->setPosition(m_Player.getPosition());
 
             if (m_Player.getCurrentSong()->isRemote())
                 mp_NetworkLoadBar->setValue(mp_Socket->getSongDataReceived());
         }
 
-        mp_SongPos->setText(util::Tools::msToString(m_Player.getCurrentSong()->getPosition()));
+        mp_SongPos->setText(util::Tools::msToString(m_Player.getPosition()));
 
         if (getButton(ButtonId::PREV)->isPressed())
             moveSongPosition(-MOVE_INTERVAL);
@@ -885,6 +993,9 @@ void PlayerWindow::timerEvent(QTimerEvent *event)
 
     if (m_Player.isPreviewing())
     {
+        // Longueur inconnue tant que l'ouverture de la preview n'est pas terminée
+        mp_PreviewBar->setMaximum(std::min(m_Player.getPreviewLength(), PREVIEW_LENGTH));
+
         if (m_Player.getPreviewPosition() < PREVIEW_LENGTH)
             mp_PreviewBar->setValue(m_Player.getPreviewPosition());
         else
@@ -1027,6 +1138,9 @@ void PlayerWindow::dragEnterEvent(QDragEnterEvent *event)
         {
             event->acceptProposedAction();
 
+            // Ouverture et recherche de la position de départ pendant le délai de la preview
+            m_Player.preparePreview(filepath);
+
             m_PreviewTimer.start();
             m_PreviewPath = filepath;
         }
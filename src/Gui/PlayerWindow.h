@@ -70,6 +70,9 @@ class PlayerWindow : public QMainWindow
         int m_CurrentSpectrumColor;
         QList<SpectrumColor> m_SpectrumColors;
 
+        // Dernier spectre reçu (réutilisé à chaque rafraîchissement, sans allocation)
+        audio::SpectrumFrame m_SpectrumFrame;
+
         SongList *mp_SongList;
 
         PlayerLabel *mp_SongPos;
@@ -201,6 +204,21 @@ class PlayerWindow : public QMainWindow
          */
         void updateCurrentSong();
 
+        /**
+         * @brief Affiche la forme d'onde du son courant dans la barre de progression, si elle est activée.
+         */
+        void updateWaveform();
+
+        /**
+         * @brief Actualise la pochette et la durée du son courant une fois son ouverture terminée.
+         */
+        void updateLoadedSong();
+
+        /**
+         * @brief Affiche la pochette du son courant (image par défaut tant qu'elle n'a pas été lue).
+         */
+        void updateSongPicture();
+
         /**
          * @brief Met à jour la liste des musiques du répertoire.
          */
@@ -274,6 +292,11 @@ class PlayerWindow : public QMainWindow
          */
         void openInformation();
 
+        /**
+         * @brief Ouvre la fenêtre d'état du moteur audio (canaux et sons chargés en mémoire).
+         */
+        void openAudioStatus();
+
         /**
          * @brief Ouvre la fenêtre de connexion.
          */
@@ -10,12 +10,25 @@
 #include "ProgressBar.h"
 #include "Constants.h"
 #include "../Util/Tools.h"
+#include "../Audio/WaveformBuilder.h"
+#include <algorithm>
 
 
 namespace gui {
 
 
-ProgressBar::ProgressBar(QWidget *parent) : QProgressBar(parent), m_Press(false)
+namespace {
+
+// Partie restante de la forme d'onde et opacité des crêtes (la moyenne quadratique est opaque)
+const QColor WAVEFORM_REMAINING_COLOR(110, 110, 110);
+constexpr int WAVEFORM_PEAK_ALPHA = 110;
+
+}
+
+// ==============================
+// ==============================
+
+ProgressBar::ProgressBar(QWidget *parent) : QProgressBar(parent), m_Press(false), m_WaveformEnabled(false)
 {
     setFixedHeight(PROGRESSBAR_HEIGHT);
 
@@ -35,6 +48,96 @@ void ProgressBar::setPosition(int position)
 // ==============================
 // ==============================
 
+void ProgressBar::setWaveformEnabled(bool enabled)
+{
+    m_WaveformEnabled = enabled;
+    update();
+}
+
+// ==============================
+// ==============================
+
+bool ProgressBar::isWaveformEnabled() const
+{
+    return m_WaveformEnabled;
+}
+
+// ==============================
+// ==============================
+
+void ProgressBar::setWaveform(const QByteArray& peaks)
+{
+    m_Peaks = peaks;
+
+    renderWaveform();
+    update();
+}
+
+// ==============================
+// ==============================
+
+void ProgressBar::renderWaveform()
+{
+    const int pointsNb = m_Peaks.size() / sizeof(audio::WaveformPoint);
+
+    if (pointsNb == 0 || width() <= 0 || height() <= 0)
+    {
+        m_PlayedWaveform = QImage();
+        m_RemainingWaveform = QImage();
+        return;
+    }
+
+    const audio::WaveformPoint *points = reinterpret_cast<const audio::WaveformPoint*>(m_Peaks.constData());
+    const int columnsNb = width();
+    const float halfHeight = height() / 2.0f;
+
+    /* Forme de l'onde : crêtes translucides, moyenne quadratique opaque */
+    QImage shape(size(), QImage::Format_ARGB32_Premultiplied);
+    shape.fill(Qt::transparent);
+
+    {
+        QPainter painter(&shape);
+
+        for (int x = 0; x < columnsNb; x++)
+        {
+            // Au moins un point par colonne (répété si la barre est plus large que la forme d'onde)
+            const int begin = std::min(x * pointsNb / columnsNb, pointsNb - 1);
+            const int end = std::max((x + 1) * pointsNb / columnsNb, begin + 1);
+
+            int minimum = 127, maximum = -127, rms = 0;
+
+            for (int p = begin; p < end; p++)
+            {
+                minimum = std::min<int>(minimum, points[p].minimum);
+                maximum = std::max<int>(maximum, points[p].maximum);
+                rms = std::max<int>(rms, points[p].rms);
+            }
+
+            const int peakTop = halfHeight - maximum * halfHeight / 127;
+            const int peakBottom = halfHeight - minimum * halfHeight / 127;
+            const int rmsHeight = rms * halfHeight / 255;
+
+            painter.fillRect(x, peakTop, 1, std::max(peakBottom - peakTop, 1), QColor(0, 0, 0, WAVEFORM_PEAK_ALPHA));
+            painter.fillRect(x, halfHeight - rmsHeight, 1, std::max(2 * rmsHeight, 1), Qt::black);
+        }
+    }
+
+    /* Colorisation des deux parties */
+    m_PlayedWaveform = shape;
+    m_RemainingWaveform = shape;
+
+    QPainter played(&m_PlayedWaveform);
+    played.setCompositionMode(QPainter::CompositionMode_SourceIn);
+    played.fillRect(m_PlayedWaveform.rect(), QBrush(m_BarTexture));
+
+    QPainter remaining(&m_RemainingWaveform);
+    remaining.setCompositionMode(QPainter::CompositionMode_SourceIn);
+    remaining.fillRect(m_RemainingWaveform.rect(), WAVEFORM_REMAINING_COLOR);
+}
+
+// ==============================
+// ==============================
+
 void ProgressBar::paintEvent(QPaintEvent * /*event*/)
 {
     QPainter painter(this);
@@ -44,7 +147,17 @@ void ProgressBar::paintEvent(QPaintEvent * /*event*/)
     if (maximum())
         barWidth = (static_cast<float>(value()) / maximum()) * width();
 
-    painter.fillRect(0, 0, barWidth, m_BarTexture.height(), QBrush(m_BarTexture));
+    if (m_WaveformEnabled && !m_PlayedWaveform.isNull())
+    {
+        QRect playedRect(0, 0, barWidth, height());
+        QRect remainingRect(barWidth, 0, width() - barWidth, height());
+
+        painter.drawImage(playedRect, m_PlayedWaveform, playedRect);
+        painter.drawImage(remainingRect, m_RemainingWaveform, remainingRect);
+    }
+    else
+        painter.fillRect(0, 0, barWidth, m_BarTexture.height(), QBrush(m_BarTexture));
+
     painter.drawPixmap(barWidth - 2, 0, m_MarkerTexture);
 }
 
@@ -54,6 +167,7 @@ void ProgressBar::paintEvent(QPaintEvent * /*event*/)
 void ProgressBar::resizeEvent(QResizeEvent *event)
 {
     resize(event->size());
+    renderWaveform();
 }
 
 // ==============================
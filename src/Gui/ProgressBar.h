@@ -15,6 +15,8 @@
 #include <QProgressBar>
 #include <QPainter>
 #include <QPaintEvent>
+#include <QImage>
+#include <QByteArray>
 
 
 namespace gui {
@@ -32,6 +34,19 @@ class ProgressBar : public QProgressBar
 
         bool m_Press;
 
+        // Forme d'onde du son courant (voir audio::WaveformPoint) et son rendu à la taille
+        // de la barre, avec la texture de la partie jouée et la couleur de la partie restante
+        bool m_WaveformEnabled;
+        QByteArray m_Peaks;
+        QImage m_PlayedWaveform;
+        QImage m_RemainingWaveform;
+
+
+        /**
+         * @brief Regroupe les points de la forme d'onde par colonne de la barre et prépare son rendu.
+         */
+        void renderWaveform();
+
     protected:
 
         virtual void paintEvent(QPaintEvent *event) override;
@@ -62,6 +77,24 @@ class ProgressBar : public QProgressBar
          * @param position Nouvelle position
          */
         void setPosition(int position);
+
+        /**
+         * @brief Affiche la forme d'onde du son à la place de la texture de la barre.
+         * @param enabled true pour afficher la forme d'onde
+         */
+        void setWaveformEnabled(bool enabled);
+
+        /**
+         * @brief isWaveformEnabled
+         * @return true si la forme d'onde est affichée.
+         */
+        bool isWaveformEnabled() const;
+
+        /**
+         * @brief Modifie la forme d'onde affichée.
+         * @param peaks Points de la forme d'onde (vide : texture de la barre)
+         */
+        void setWaveform(const QByteArray& peaks);
 };
 
 
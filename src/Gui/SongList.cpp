@@ -15,6 +15,7 @@
 #include "../Exceptions/ArrayAccessException.h"
 #include <QScrollBar>
 #include <QMouseEvent>
+#include <algorithm>
 
 
 namespace gui {
@@ -97,13 +98,15 @@ unsigned int SongList::setSongDetails(SongListItem *item) const
 // ==============================
 // ==============================
 
-void SongList::addChildSong(SongListItem *item, SongListItem *parent, int pos) const
+void SongList::addChildSong(SongListItem *item, SongListItem *parent, int pos)
 {
     if (pos < 0)
         parent->addChild(item);
     else
         parent->insertChild(pos, item);
 
+    indexSongs(item, true);
+
     const auto itemLength = setSongDetails(item);
     parent->setLength(parent->getLength() + itemLength);
 
@@ -129,6 +132,8 @@ void SongList::removeSong(SongListItem *item)
     SongListItem *parent = currentItem->parent();
     const auto itemLength = currentItem->getLength();
 
+    indexSongs(currentItem, false);
+
     parent->removeChild(currentItem);
     parent->setLength(parent->getLength() - itemLength);
     delete currentItem;
@@ -158,6 +163,54 @@ void SongList::removeSong(const SongListIterator& it)
 // ==============================
 // ==============================
 
+void SongList::indexSongs(SongListItem *item, bool indexed)
+{
+    if (item->isSong())
+    {
+        std::shared_ptr<audio::Song> song = item->getAttachedSong();
+
+        if (song && indexed)
+            m_SongItems.insert(song->getId(), item);
+        else if (song && m_SongItems.value(song->getId()) == item)
+            m_SongItems.remove(song->getId());
+    }
+    else
+    {
+        for (int i = 0; i < item->childCount(); ++i)
+            indexSongs(static_cast<SongListItem*>(item->child(i)), indexed);
+    }
+}
+
+// ==============================
+// ==============================
+
+int SongList::findChildPos(SongListItem *parent, const QString& filePath) const
+{
+    const QString key = audio::SongScanner::walkOrderKey(filePath);
+    int first = 0, last = parent->childCount();
+
+    while (first < last)
+    {
+        const int middle = (first + last) / 2;
+        SongListItem *child = static_cast<SongListItem*>(parent->child(middle));
+
+        // Un répertoire est placé selon sa première musique, les musiques importées suivent le répertoire
+        while (!child->isSong() && child->childCount() > 0)
+            child = static_cast<SongListItem*>(child->child(0));
+
+        std::shared_ptr<audio::Song> song = child->getAttachedSong();
+        if (!song || !song->isInFolder() || key < audio::SongScanner::walkOrderKey(song->getFile()))
+            last = middle;
+        else
+            first = middle + 1;
+    }
+
+    return first;
+}
+
+// ==============================
+// ==============================
+
 void SongList::clearList(SongList_t list)
 {
     SongListItem *root = getRootNode(list);
@@ -188,22 +241,14 @@ void SongList::setCurrentSong(audio::Player::SongId songId)
     if (mp_CurrentSong != nullptr)
         mp_CurrentSong->setTextColor(QColor(212, 255, 250));
 
-    SongListIterator it(this, QTreeWidgetItemIterator::Selectable);
+    SongListItem *item = m_SongItems.value(songId, nullptr);
+    std::shared_ptr<audio::Song> song = item ? item->getAttachedSong() : nullptr;
 
-    while (!it.isNull())
+    if (song && song->isAvailable())
     {
-        std::shared_ptr<audio::Song> song = (*it)->getAttachedSong();
-        if (song && song->isAvailable())
-        {
-            if (song->getId() == songId)
-            {
-                mp_CurrentSong = *it;
-                mp_CurrentSong->setTextColor(QColor(21, 191, 221));
-                return;
-            }
-        }
-
-        ++it;
+        mp_CurrentSong = item;
+        mp_CurrentSong->setTextColor(QColor(21, 191, 221));
+        return;
     }
 
     mp_CurrentSong = nullptr;
@@ -322,21 +367,64 @@ void SongList::addTree(SongList_t list, SongTreeRoot *songs)
 
 void SongList::disableSong(audio::Player::SongId songId)
 {
-    SongListIterator it(this, QTreeWidgetItemIterator::Selectable);
+    SongListItem *item = m_SongItems.value(songId, nullptr);
 
-    while (!it.isNull())
+    if (item)
     {
-        std::shared_ptr<audio::Song> song = (*it)->getAttachedSong();
-        if (song && song->getId() == songId)
+        item->setTextColor(QColor(255, 0, 0));
+        item->setIcon(0, QIcon(m_BrokenIcon));
+    }
+}
+
+// ==============================
+// ==============================
+
+void SongList::insertSong(SongListItem *item, const QStringList& dirs)
+{
+    std::shared_ptr<audio::Song> song = item->getAttachedSong();
+    SongListItem *parent = getRootNode(SongList_t::DIRECTORY_SONGS);
+
+    if (!song || !parent)
+    {
+        delete item;
+        return;
+    }
+
+    for (const QString& dirName : dirs)
+    {
+        SongListItem *dirItem = nullptr;
+
+        // Un répertoire existant est voisin de la position du fichier (sa première musique précède ou suit le fichier)
+        const int pos = findChildPos(parent, song->getFile());
+
+        for (int i = std::max(pos - 1, 0); i <= pos && i < parent->childCount() && !dirItem; ++i)
         {
-            (*it)->setTextColor(QColor(255, 0, 0));
-            (*it)->setIcon(0, QIcon(m_BrokenIcon));
+            SongListItem *child = static_cast<SongListItem*>(parent->child(i));
+            if (!child->isSong() && child->text(0) == dirName)
+                dirItem = child;
+        }
 
-            return;
+        if (!dirItem)
+        {
+            dirItem = new SongListItem(SongListItem::ElementType::DIRECTORY, dirName);
+            addChildSong(dirItem, parent, pos);
         }
 
-        ++it;
+        parent = dirItem;
     }
+
+    addChildSong(item, parent, findChildPos(parent, song->getFile()));
+}
+
+// ==============================
+// ==============================
+
+void SongList::deleteSong(audio::Player::SongId songId)
+{
+    SongListItem *item = m_SongItems.value(songId, nullptr);
+
+    if (item)
+        removeSong(item);
 }
 
 
@@ -14,6 +14,7 @@
 
 #include <QTreeWidget>
 #include <QVector>
+#include <QHash>
 #include <QPair>
 #include <QString>
 #include "SongListItem.h"
@@ -40,6 +41,9 @@ class SongList : public QTreeWidget
 
         SongListItem *mp_PreviousHilightedItem;
 
+        // Elément de chaque musique de la liste, tenu à jour par addChildSong/removeSong
+        QHash<audio::Player::SongId, SongListItem*> m_SongItems;
+
 
         /**
          * @brief Récupère la racine correspondant à la liste passée en paramètre.
@@ -61,7 +65,14 @@ class SongList : public QTreeWidget
          * @param parent Parent du nouvel élément
          * @param pos Position à laquelle ajouter l'élément
          */
-        void addChildSong(SongListItem *item, SongListItem *parent, int pos = -1) const;
+        void addChildSong(SongListItem *item, SongListItem *parent, int pos = -1);
+
+        /**
+         * @brief Ajoute ou retire de l'index les musiques de l'élément passé en paramètre et de ses fils.
+         * @param item Elément ajouté ou supprimé
+         * @param indexed true pour ajouter les musiques, false pour les retirer
+         */
+        void indexSongs(SongListItem *item, bool indexed);
 
         /**
          * @brief Supprime de la liste l'élément passé en paramètre (avec ses parents récursivement s'il s'agit du seul fils).
@@ -69,6 +80,15 @@ class SongList : public QTreeWidget
          */
         void removeSong(const SongListIterator& it);
 
+        /**
+         * @brief Cherche par dichotomie la position d'un fichier parmi les fils de l'élément passé
+         *        en paramètre, triés dans l'ordre du parcours.
+         * @param parent Elément parent
+         * @param filePath Chemin canonique du fichier
+         * @return Indice du premier fils situé après le fichier
+         */
+        int findChildPos(SongListItem *parent, const QString& filePath) const;
+
     private slots:
 
         void onItemClicked(QTreeWidgetItem *item, int column);
@@ -144,6 +164,20 @@ class SongList : public QTreeWidget
          * @param songId Musique à désactiver
          */
         void disableSong(audio::Player::SongId songId);
+
+        /**
+         * @brief Insère à sa place une musique apparue dans le répertoire des musiques,
+         *        en créant si besoin ses répertoires parents.
+         * @param item Elément contenant la musique
+         * @param dirs Noms des répertoires parents, depuis la racine
+         */
+        void insertSong(gui::SongListItem *item, const QStringList& dirs);
+
+        /**
+         * @brief Supprime de la liste la musique passée en paramètre.
+         * @param songId Musique à supprimer
+         */
+        void deleteSong(audio::Player::SongId songId);
 };
 
 
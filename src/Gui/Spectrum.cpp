@@ -9,16 +9,20 @@
 
 #include "Spectrum.h"
 #include "Constants.h"
+#include "../Audio/SpectrumKernels.h"
 
 #include <QImage>
 #include <QLinearGradient>
+#include <algorithm>
+#include <cmath>
 
 
 namespace gui {
 
 
 Spectrum::Spectrum(int width, QWidget *parent)
-    : QWidget(parent), m_Width(width), m_Lines(m_Width)
+    : QWidget(parent), m_Width(width), m_Lines(m_Width), m_Heights(m_Width), m_BandsEnabled(false), m_BinsNb(0),
+      m_BandValues(SPECTRUM_BANDS_NB), m_BandLevels(SPECTRUM_BANDS_NB), m_BandPeaks(SPECTRUM_BANDS_NB), m_PeakHolds(SPECTRUM_BANDS_NB)
 {
     setMinimumSize(m_Width, SPECTRUM_HEIGHT);
 
@@ -28,42 +32,232 @@ Spectrum::Spectrum(int width, QWidget *parent)
     {
         m_Lines[i].setCoords(i, height(), i, height());
     }
+
+    renderGradient();
+    resetBacking();
 }
 
 // ==============================
 // ==============================
 
-void Spectrum::draw(QPainter *painter) const
+void Spectrum::renderGradient()
 {
-    int i;
+    m_Gradient = QImage(1, std::max(height(), 1), QImage::Format_ARGB32_Premultiplied);
+    m_Gradient.fill(Qt::transparent);
 
-    QLinearGradient gradient(0, 0, 0, height());
+    QLinearGradient gradient(0, 0, 0, m_Gradient.height());
     gradient.setColorAt(0.0, m_Color.topColor);
     gradient.setColorAt(1.0, m_Color.bottomColor);
 
+    QPainter painter(&m_Gradient);
+    painter.fillRect(m_Gradient.rect(), gradient);
+}
+
+// ==============================
+// ==============================
+
+void Spectrum::resetBacking()
+{
+    m_Backing = QImage(m_Width, std::max(height(), 1), QImage::Format_ARGB32_Premultiplied);
+    m_Backing.fill(Qt::transparent);
+
+    m_DrawnTops.fill(m_Backing.height(), m_Width);
+    m_DrawnPeaks.fill(m_Backing.height(), SPECTRUM_BANDS_NB);
+}
+
+// ==============================
+// ==============================
+
+QRect Spectrum::renderColumns()
+{
+    int x, y;
+    QRect dirty;
+
+    const int imageHeight = m_Backing.height();
+    const int stride = m_Backing.bytesPerLine() / sizeof(QRgb);
+    const int gradientStride = m_Gradient.bytesPerLine() / sizeof(QRgb);
+
+    QRgb *pixels = reinterpret_cast<QRgb*>(m_Backing.bits());
+    const QRgb *gradient = reinterpret_cast<const QRgb*>(m_Gradient.constBits());
+
+    for (x = 0; x < m_Width; x++)
+    {
+        const int top = std::min(std::max(m_Lines[x].top(), 0), imageHeight);
+        const int drawn = m_DrawnTops[x];
+
+        if (top == drawn)
+            continue;
+
+        /* La colonne grandit : pixels du dégradé ; elle rétrécit : pixels transparents */
+        if (top < drawn)
+        {
+            for (y = top; y < drawn; y++)
+                pixels[y * stride + x] = gradient[y * gradientStride];
+        }
+        else
+        {
+            for (y = drawn; y < top; y++)
+                pixels[y * stride + x] = 0;
+        }
+
+        dirty |= QRect(x, std::min(top, drawn), 1, std::abs(top - drawn));
+        m_DrawnTops[x] = top;
+    }
+
+    return dirty;
+}
+
+// ==============================
+// ==============================
+
+QRect Spectrum::renderPeaks()
+{
+    int i;
+    QRect dirty;
+
+    for (i = 0; i < m_DrawnPeaks.size(); i++)
+    {
+        const int top = height() - static_cast<int>(m_BandPeaks[i] * height());
+
+        if (top != m_DrawnPeaks[i])
+        {
+            dirty |= getPeakRect(i, m_DrawnPeaks[i]) | getPeakRect(i, top);
+            m_DrawnPeaks[i] = top;
+        }
+    }
+
+    return dirty;
+}
+
+// ==============================
+// ==============================
+
+QRect Spectrum::getPeakRect(int band, int top) const
+{
+    const int bandsNb = m_DrawnPeaks.size();
+    const int left = band * m_Width / bandsNb;
+    const int right = (band + 1) * m_Width / bandsNb;
+
+    return QRect(left, std::max(top - 2, 0), std::max(right - left - 1, 1), 2);
+}
+
+// ==============================
+// ==============================
+
+void Spectrum::computeBandTable(unsigned int binsNb)
+{
+    const unsigned int bandsNb = SPECTRUM_BANDS_NB;
+
+    m_BinsNb = binsNb;
+    m_BandEdges.clear();
+
+    // Bornes réparties logarithmiquement entre le coefficient 1 et binsNb, au moins un coefficient par bande
+    // (le coefficient 0, composante continue, est ignoré)
+    unsigned int bin = 1;
+
+    for (unsigned int band = 0; band < bandsNb && bin < binsNb; band++)
+    {
+        unsigned int end = static_cast<unsigned int>(std::lround(std::pow(binsNb, (band + 1.0) / bandsNb)));
+        end = std::min(std::max(end, bin + 1), binsNb);
+
+        if (band == bandsNb - 1)
+            end = binsNb;
+
+        m_BandEdges.append(bin);
+        bin = end;
+    }
+
+    // Fin de la dernière bande (les bandes suivantes, sans coefficient, restent à 0)
+    if (!m_BandEdges.isEmpty())
+        m_BandEdges.append(bin);
+}
+
+// ==============================
+// ==============================
+
+void Spectrum::updateBands(const audio::SpectrumFrame& frame)
+{
+    int i;
+    const int bandsNb = m_BandLevels.size();
+
+    if (frame.size != m_BinsNb)
+        computeBandTable(frame.size);
+
+    /* Maximum de chaque bande, ramené à une part de la hauteur */
+    const audio::SpectrumKernels::Functions& kernels = audio::SpectrumKernels::get();
+
+    m_BandValues.fill(0.0f);
+
+    if (!m_BandEdges.isEmpty())
+        kernels.aggregateBands(frame.values.data(), m_BandEdges.constData(), m_BandValues.data(), m_BandEdges.size() - 1);
+
+    kernels.scaleClamp(m_BandValues.constData(), m_BandValues.data(), bandsNb, SPECTRUM_RATIO, 0.0f, 1.0f);
+
+    /* Lissage (montée rapide, descente lente) et crêtes */
+    for (i = 0; i < bandsNb; i++)
+    {
+        const float target = m_BandValues[i];
+        const float smoothing = target > m_BandLevels[i] ? SPECTRUM_ATTACK : SPECTRUM_RELEASE;
+
+        m_BandLevels[i] += (target - m_BandLevels[i]) * smoothing;
+
+        if (m_BandLevels[i] >= m_BandPeaks[i])
+        {
+            m_BandPeaks[i] = m_BandLevels[i];
+            m_PeakHolds[i] = SPECTRUM_PEAK_HOLD;
+        }
+        else if (m_PeakHolds[i] > 0)
+            m_PeakHolds[i]--;
+        else
+            m_BandPeaks[i] = std::max(m_BandPeaks[i] - SPECTRUM_PEAK_DECAY, m_BandLevels[i]);
+    }
+
+    /* Colonnes de chaque bande, la dernière servant de séparation */
     for (i = 0; i < m_Width; i++)
     {
-        painter->fillRect(i, m_Lines[i].top(), 1, height() - m_Lines[i].top(), gradient);
+        const int band = i * bandsNb / m_Width;
+        const bool separator = (i + 1) * bandsNb / m_Width != band && m_Width / bandsNb > 2;
+
+        m_Lines[i].setTop(separator ? height() : height() - static_cast<int>(m_BandLevels[band] * height()));
     }
 }
 
 // ==============================
 // ==============================
 
-void Spectrum::paintEvent(QPaintEvent * /*event*/)
+void Spectrum::paintEvent(QPaintEvent *event)
 {
-    QImage image(m_Width, height(), QImage::Format_ARGB32_Premultiplied);
-    image.fill(Qt::transparent);
+    const QRect& area = event->rect();
+
+    QPainter painter(this);
+    painter.drawImage(area.topLeft(), m_Backing, area);
+
+    /* Marqueurs de crête des bandes */
+    if (m_BandsEnabled)
+    {
+        for (int i = 0; i < m_DrawnPeaks.size(); i++)
+        {
+            QRect peak = getPeakRect(i, m_DrawnPeaks[i]);
+
+            if (peak.intersects(area))
+                painter.fillRect(peak, m_Color.topColor);
+        }
+    }
+}
 
-    QPainter imagePainter(&image);
-    imagePainter.initFrom(this);
-    imagePainter.setRenderHint(QPainter::Antialiasing, true);
+// ==============================
+// ==============================
 
-    draw(&imagePainter);
-    imagePainter.end();
+void Spectrum::resizeEvent(QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
+
+    // Les hauteurs des colonnes dépendent de celle du widget : elles sont recalculées à la trame suivante
+    for (QRect& rect : m_Lines)
+        rect.setTop(height());
 
-    QPainter widgetPainter(this);
-    widgetPainter.drawImage(0, 0, image);
+    renderGradient();
+    resetBacking();
 }
 
 // ==============================
@@ -72,6 +266,14 @@ void Spectrum::paintEvent(QPaintEvent * /*event*/)
 void Spectrum::setColor(const SpectrumColor& color)
 {
     m_Color = color;
+
+    // Les colonnes sont redessinées avec le nouveau dégradé
+    renderGradient();
+    m_DrawnTops.fill(m_Backing.height());
+    m_Backing.fill(Qt::transparent);
+    renderColumns();
+
+    update();
 }
 
 // ==============================
@@ -82,36 +284,73 @@ void Spectrum::clear()
     for (QRect& rect : m_Lines)
         rect.setTop(height());
 
+    m_BandLevels.fill(0.0f);
+    m_BandPeaks.fill(0.0f);
+    m_PeakHolds.fill(0);
+
+    resetBacking();
     update();
 }
 
 // ==============================
 // ==============================
 
-void Spectrum::updateValues(audio::SoundID_t id)
+void Spectrum::setBandsEnabled(bool enabled)
 {
-    int i;
-    std::vector<float> spectrumValues(m_Width);
+    m_BandsEnabled = enabled;
+    clear();
+}
+
+// ==============================
+// ==============================
 
-    /* Récupération des valeurs spectrales de FMOD */
-    audio::FmodManager::getInstance().getChannelSpectrum(id, spectrumValues);
+bool Spectrum::isBandsEnabled() const
+{
+    return m_BandsEnabled;
+}
 
-    for (i = 0; i < m_Width; i++)
+// ==============================
+// ==============================
+
+bool Spectrum::isDisplayed() const
+{
+    return isVisible() && !window()->isMinimized() && !visibleRegion().isEmpty();
+}
+
+// ==============================
+// ==============================
+
+void Spectrum::updateValues(const audio::SpectrumFrame& frame)
+{
+    // Rien n'est calculé ni dessiné tant que le spectre n'est pas à l'écran
+    if (!isDisplayed())
+        return;
+
+    QRect dirty;
+
+    if (m_BandsEnabled)
     {
-        int lineHeight = spectrumValues[i] * height() * SPECTRUM_RATIO;
+        updateBands(frame);
+        dirty = renderColumns() | renderPeaks();
+    }
+    else
+    {
+        int i;
+        int width = std::min(m_Width, static_cast<int>(frame.size));
 
-        if (lineHeight > height())
-          lineHeight = height();
-        else if (lineHeight < 0)
-          lineHeight = 0;
+        audio::SpectrumKernels::get().toHeights(frame.values.data(), m_Heights.data(), width,
+                                                static_cast<float>(height()) * SPECTRUM_RATIO, height());
 
-        int yPos = height() - lineHeight;
+        /* Calcul de la position des colonnes */
+        for (i = 0; i < width; i++)
+            m_Lines[i].setTop(height() - m_Heights[i]);
 
-        /* Calcul de la position de la colonne */
-        m_Lines[i].setTop(yPos);
+        dirty = renderColumns();
     }
 
-    update();
+    // Seules les colonnes modifiées sont repeintes
+    if (!dirty.isEmpty())
+        update(dirty);
 }
 
 
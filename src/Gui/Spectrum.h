@@ -16,8 +16,10 @@
 #include <QWidget>
 #include <QVector>
 #include <QRect>
+#include <QImage>
 #include <QPainter>
 #include <QPaintEvent>
+#include <QResizeEvent>
 
 
 namespace gui {
@@ -37,18 +39,75 @@ class Spectrum : public QWidget
 
         QVector<QRect> m_Lines;
 
+        // Hauteurs des colonnes calculées à chaque mise à jour
+        QVector<int> m_Heights;
+
         SpectrumColor m_Color;
 
+        // Mode en bandes logarithmiques
+        bool m_BandsEnabled;
+        unsigned int m_BinsNb;              // Taille de spectre pour laquelle la table a été calculée
+        QVector<unsigned int> m_BandEdges;  // Premier coefficient de chaque bande ayant des coefficients, puis fin de la dernière
+        QVector<float> m_BandValues;        // Niveau visé de chaque bande dans la trame (maximum de ses coefficients)
+        QVector<float> m_BandLevels;        // Niveau lissé de chaque bande (part de la hauteur)
+        QVector<float> m_BandPeaks;         // Niveau du marqueur de crête de chaque bande
+        QVector<unsigned int> m_PeakHolds;  // Trames restantes avant la chute du marqueur
+
+        // Rendu conservé : colonne du dégradé calculée à chaque changement de couleur ou de taille,
+        // image des colonnes mise à jour uniquement là où leur hauteur change
+        QImage m_Gradient;
+        QImage m_Backing;
+        QVector<int> m_DrawnTops;           // Haut de chaque colonne dans m_Backing
+        QVector<int> m_DrawnPeaks;          // Haut du marqueur de crête affiché de chaque bande
+
+
+        /**
+         * @brief Calcule la colonne du dégradé pour la couleur et la hauteur courantes.
+         */
+        void renderGradient();
+
+        /**
+         * @brief Recrée l'image des colonnes (vide) à la taille du widget.
+         */
+        void resetBacking();
+
+        /**
+         * @brief Copie dans l'image des colonnes les pixels des colonnes dont la hauteur a changé.
+         * @return Zone modifiée
+         */
+        QRect renderColumns();
+
+        /**
+         * @brief Met à jour la position des marqueurs de crête.
+         * @return Zone modifiée (anciens et nouveaux marqueurs)
+         */
+        QRect renderPeaks();
+
+        /**
+         * @brief getPeakRect
+         * @param band Bande du marqueur
+         * @param top Haut du marqueur
+         * @return Rectangle du marqueur de crête.
+         */
+        QRect getPeakRect(int band, int top) const;
+
+        /**
+         * @brief Calcule la bande logarithmique de chaque coefficient du spectre.
+         * @param binsNb Nombre de coefficients du spectre
+         */
+        void computeBandTable(unsigned int binsNb);
 
         /**
-         * @brief Dessine le contenu du spectre dans le painter passé en paramètre.
-         * @param painter Cible du dessin
+         * @brief Met à jour les niveaux et les crêtes des bandes (voir SpectrumKernels)
+         *        puis la hauteur des colonnes de chaque bande.
+         * @param frame Spectre publié par SpectrumDsp
          */
-        void draw(QPainter *painter) const;
+        void updateBands(const audio::SpectrumFrame& frame);
 
     protected:
 
         virtual void paintEvent(QPaintEvent *event) override;
+        virtual void resizeEvent(QResizeEvent *event) override;
 
     public:
 
@@ -67,10 +126,25 @@ class Spectrum : public QWidget
         void clear();
 
         /**
-         * @brief Récupère les fréquences du son joué et met à jour les valeurs des vertices.
-         * @param id Identifiant du canal à tester
+         * @brief Affiche le spectre par bandes logarithmiques lissées avec marqueurs de crête,
+         *        ou par coefficient de la FFT.
+         * @param enabled true pour afficher les bandes
+         */
+        void setBandsEnabled(bool enabled);
+
+        bool isBandsEnabled() const;
+
+        /**
+         * @brief isDisplayed
+         * @return true si le spectre est visible à l'écran (ni caché, ni recouvert, ni réduit).
+         */
+        bool isDisplayed() const;
+
+        /**
+         * @brief Met à jour les valeurs des vertices à partir des fréquences du son joué.
+         * @param frame Spectre publié par SpectrumDsp
         */
-        void updateValues(audio::SoundID_t id);
+        void updateValues(const audio::SpectrumFrame& frame);
 };
 
 
@@ -130,8 +130,8 @@ QByteArray ReadCommandReply::toPacket() const
 // ==============================
 // ==============================
 
-SeekCommandReply::SeekCommandReply(audio::Player::SongId songId, FMOD_RESULT result)
-    : CommandReply(songId, result)
+SeekCommandReply::SeekCommandReply(audio::Player::SongId songId, FMOD_RESULT result, char *buffer, unsigned int bytes, unsigned int time)
+    : ReadCommandReply(songId, result, buffer, bytes), m_Time(time)
 {
 
 }
@@ -141,6 +141,26 @@ char SeekCommandReply::getCommandType() const
     return 's';
 }
 
+bool SeekCommandReply::hasTime() const
+{
+    return m_Time != SeekCommandRequest::NO_TIME;
+}
+
+unsigned int SeekCommandReply::getTime() const
+{
+    return m_Time;
+}
+
+QByteArray SeekCommandReply::toPacket() const
+{
+    QByteArray packet = ReadCommandReply::toPacket();
+    QDataStream out(&packet, QIODevice::Append);
+
+    out << static_cast<quint32>(m_Time);
+
+    return packet;
+}
+
 
 } // commands
 } // network
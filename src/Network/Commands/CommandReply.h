@@ -11,7 +11,7 @@
 #ifndef __COMMANDREPLY_H__
 #define __COMMANDREPLY_H__
 
-#include "Command.h"
+#include "CommandRequest.h"
 #include <fmod.h>
 
 
@@ -88,14 +88,27 @@ class ReadCommandReply : public CommandReply
         virtual QByteArray toPacket() const override;
 };
 
-class SeekCommandReply : public CommandReply
+// Réponse à un déplacement, contenant les premières données lues à la nouvelle position
+// et, pour un déplacement indexé, le début de la trame où la lecture reprend
+class SeekCommandReply : public ReadCommandReply
 {
+    private:
+
+        unsigned int m_Time;
+
     public:
 
-        SeekCommandReply(audio::Player::SongId songId, FMOD_RESULT result);
+        SeekCommandReply(audio::Player::SongId songId, FMOD_RESULT result, char *buffer, unsigned int bytes,
+                         unsigned int time = SeekCommandRequest::NO_TIME);
         virtual ~SeekCommandReply() = default;
 
         virtual char getCommandType() const override;
+
+        bool hasTime() const;
+
+        unsigned int getTime() const;
+
+        virtual QByteArray toPacket() const override;
 };
 
 
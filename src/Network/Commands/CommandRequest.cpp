@@ -89,8 +89,10 @@ QByteArray ReadCommandRequest::toPacket() const
 // ==============================
 // ==============================
 
-SeekCommandRequest::SeekCommandRequest(audio::Player::SongId songId, unsigned int pos)
-    : CommandRequest(songId), m_Pos(pos)
+constexpr unsigned int SeekCommandRequest::NO_TIME;
+
+SeekCommandRequest::SeekCommandRequest(audio::Player::SongId songId, unsigned int pos, unsigned int bytes, unsigned int time)
+    : CommandRequest(songId), m_Pos(pos), m_BytesToRead(bytes), m_Time(time)
 {
 
 }
@@ -105,12 +107,27 @@ unsigned int SeekCommandRequest::getPos() const
     return m_Pos;
 }
 
+unsigned int SeekCommandRequest::getBytesToRead() const
+{
+    return m_BytesToRead;
+}
+
+bool SeekCommandRequest::hasTime() const
+{
+    return m_Time != NO_TIME;
+}
+
+unsigned int SeekCommandRequest::getTime() const
+{
+    return m_Time;
+}
+
 QByteArray SeekCommandRequest::toPacket() const
 {
     QByteArray packet = Command::toPacket();
     QDataStream out(&packet, QIODevice::Append);
 
-    out << static_cast<quint32>(getPos());
+    out << static_cast<quint32>(getPos()) << static_cast<quint32>(getBytesToRead()) << static_cast<quint32>(m_Time);
 
     return packet;
 }
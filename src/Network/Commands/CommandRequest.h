@@ -67,21 +67,38 @@ class ReadCommandRequest : public CommandRequest
         virtual QByteArray toPacket() const override;
 };
 
+/**
+ * Déplacement dans le fichier suivi de la lecture de ses premières données, renvoyées avec la réponse.
+ * Si la position demandée (ms) est connue, le client qui lit le fichier la convertit lui-même
+ * grâce à l'index du fichier, la position en octets n'étant alors qu'une estimation.
+ */
 class SeekCommandRequest : public CommandRequest
 {
     private:
 
         unsigned int m_Pos;
 
+        unsigned int m_BytesToRead;
+
+        unsigned int m_Time;
+
     public:
 
-        SeekCommandRequest(audio::Player::SongId songId, unsigned int pos);
+        static constexpr unsigned int NO_TIME = 0xFFFFFFFF;
+
+        SeekCommandRequest(audio::Player::SongId songId, unsigned int pos, unsigned int bytes, unsigned int time = NO_TIME);
         virtual ~SeekCommandRequest() = default;
 
         virtual char getCommandType() const override;
 
         unsigned int getPos() const;
 
+        unsigned int getBytesToRead() const;
+
+        bool hasTime() const;
+
+        unsigned int getTime() const;
+
         virtual QByteArray toPacket() const override;
 };
 
@@ -11,6 +11,7 @@
 #include "RemoteSong.h"
 #include "../Exceptions/LibException.h"
 #include "../Exceptions/ArrayAccessException.h"
+#include <algorithm>
 
 
 namespace network {
@@ -18,12 +19,13 @@ namespace network {
 
 PlayerSocket::PlayerSocket(audio::Player *player)
     : mp_Player(player), m_Connected(false), mp_Server(nullptr), mp_Socket(nullptr), m_NbSentListItems(0), m_NbReceivedSongs(0),
-      mp_MessageBox(nullptr), mp_SocketThread(nullptr)
+      mp_MessageBox(nullptr), mp_SocketThread(nullptr), m_PrefetchPos(0), m_PrefetchEnd(false)
 {
     m_CallbackSettings.openCallback = openCallback;
     m_CallbackSettings.closeCallback = closeCallback;
     m_CallbackSettings.readCallback = readCallback;
     m_CallbackSettings.seekCallback = seekCallback;
+    m_CallbackSettings.seekTimeCallback = seekTimeCallback;
     m_CallbackSettings.userdata = this;
 }
 
@@ -315,9 +317,11 @@ std::shared_ptr<commands::Command> PlayerSocket::buildCommand(QByteArray message
             case 's':
             {
                 quint32 pos;
-                in >> pos;
+                quint32 bytesToRead;
+                quint32 time;
+                in >> pos >> bytesToRead >> time;
 
-                command = std::make_shared<commands::SeekCommandRequest>(songId, pos);
+                command = std::make_shared<commands::SeekCommandRequest>(songId, pos, bytesToRead, time);
                 break;
             }
 
@@ -345,6 +349,7 @@ std::shared_ptr<commands::Command> PlayerSocket::buildCommand(QByteArray message
                 break;
 
             case 'r':
+            case 's':
             {
                 quint32 readBytes;
                 in >> readBytes;
@@ -352,12 +357,19 @@ std::shared_ptr<commands::Command> PlayerSocket::buildCommand(QByteArray message
                 char *buffer = new char[readBytes];
                 in.readRawData(buffer, readBytes);
 
-                command = std::make_shared<commands::ReadCommandReply>(songId, static_cast<FMOD_RESULT>(result), buffer, readBytes);
+                if (commandType == 'r')
+                {
+                    command = std::make_shared<commands::ReadCommandReply>(songId, static_cast<FMOD_RESULT>(result), buffer, readBytes);
+                }
+                else
+                {
+                    quint32 time;
+                    in >> time;
+
+                    command = std::make_shared<commands::SeekCommandReply>(songId, static_cast<FMOD_RESULT>(result), buffer, readBytes, time);
+                }
                 break;
             }
-            case 's':
-                command = std::make_shared<commands::SeekCommandReply>(songId, static_cast<FMOD_RESULT>(result));
-                break;
 
             default:
                 break;
@@ -444,6 +456,10 @@ FMOD_RESULT PlayerSocket::openRemoteFile(const char *fileName, unsigned int *fil
             m_TotalCurrentSongData = *filesize;
             m_SongDataReceived = 0;
 
+            m_Prefetch.clear();
+            m_PrefetchPos = 0;
+            m_PrefetchEnd = false;
+
             return result;
         }
     }
@@ -476,6 +492,9 @@ FMOD_RESULT PlayerSocket::closeRemoteFile(void *handle)
     if (reply)
         result = reply->getResult();
 
+    m_Prefetch.clear();
+    m_PrefetchPos = 0;
+
     delete songId;
 
     return result;
@@ -494,9 +513,24 @@ FMOD_RESULT PlayerSocket::readRemoteFile(void *handle, void *buffer, unsigned in
 
     if (bytesread)
     {
+        /* Données reçues avec le dernier déplacement */
+        unsigned int copiedBytes = std::min<unsigned int>(sizebytes, m_Prefetch.size() - m_PrefetchPos);
+
+        memcpy(buffer, m_Prefetch.constData() + m_PrefetchPos, copiedBytes);
+        m_PrefetchPos += copiedBytes;
+
+        *bytesread = copiedBytes;
+        m_SongDataReceived += copiedBytes;
+
+        if (copiedBytes == sizebytes)
+            return FMOD_OK;
+
+        if (m_PrefetchEnd)
+            return FMOD_ERR_FILE_EOF;
+
         int *songId = static_cast<int*>(handle);
 
-        commands::ReadCommandRequest request(*songId, sizebytes);
+        commands::ReadCommandRequest request(*songId, sizebytes - copiedBytes);
         mp_MessageBox->add(&request);
 
         std::shared_ptr<commands::ReadCommandReply> reply = std::static_pointer_cast<commands::ReadCommandReply>(getCommandReply());
@@ -504,10 +538,10 @@ FMOD_RESULT PlayerSocket::readRemoteFile(void *handle, void *buffer, unsigned in
         {
             FMOD_RESULT result = reply->getResult();
 
-            *bytesread = reply->getReadBytes();
-            memcpy(buffer, reply->getBuffer(), *bytesread);
+            memcpy(static_cast<char*>(buffer) + copiedBytes, reply->getBuffer(), reply->getReadBytes());
+            *bytesread += reply->getReadBytes();
 
-            m_SongDataReceived += *bytesread;
+            m_SongDataReceived += reply->getReadBytes();
 
             if (*bytesread < sizebytes)
                 return FMOD_ERR_FILE_EOF;
@@ -523,6 +557,14 @@ FMOD_RESULT PlayerSocket::readRemoteFile(void *handle, void *buffer, unsigned in
 // ==============================
 
 FMOD_RESULT PlayerSocket::seekRemoteFile(void *handle, unsigned int pos)
+{
+    return seekRemoteFileAt(handle, pos, commands::SeekCommandRequest::NO_TIME);
+}
+
+// ==============================
+// ==============================
+
+FMOD_RESULT PlayerSocket::seekRemoteFileAt(void *handle, unsigned int pos, audio::SoundPos_t time, audio::SoundPos_t *frameTime)
 {
     if (!handle)
         return FMOD_ERR_INVALID_PARAM;
@@ -532,7 +574,12 @@ FMOD_RESULT PlayerSocket::seekRemoteFile(void *handle, unsigned int pos)
 
     int *songId = static_cast<int*>(handle);
 
-    commands::SeekCommandRequest request(*songId, pos);
+    m_Prefetch.clear();
+    m_PrefetchPos = 0;
+    m_PrefetchEnd = false;
+
+    // Les premières données à la nouvelle position sont reçues avec la réponse (voir readRemoteFile)
+    commands::SeekCommandRequest request(*songId, pos, SEEK_PREFETCH_SIZE, time);
     mp_MessageBox->add(&request);
 
     std::shared_ptr<commands::SeekCommandReply> reply = std::static_pointer_cast<commands::SeekCommandReply>(getCommandReply());
@@ -542,6 +589,16 @@ FMOD_RESULT PlayerSocket::seekRemoteFile(void *handle, unsigned int pos)
     {
         result = reply->getResult();
         m_SongDataReceived = 0;
+
+        if (result == FMOD_OK)
+        {
+            m_Prefetch = QByteArray(reply->getBuffer(), reply->getReadBytes());
+            m_PrefetchEnd = (reply->getReadBytes() < SEEK_PREFETCH_SIZE);
+
+            // Début de la trame indexée d'où l'autre client a repris la lecture
+            if (frameTime && reply->hasTime())
+                *frameTime = reply->getTime();
+        }
     }
 
     return result;
@@ -598,5 +655,13 @@ FMOD_RESULT seekCallback(void *handle, unsigned int pos, void *userdata)
     return static_cast<PlayerSocket*>(userdata)->seekRemoteFile(handle, pos);
 }
 
+// ==============================
+// ==============================
+
+FMOD_RESULT seekTimeCallback(void *handle, unsigned int pos, audio::SoundPos_t time, audio::SoundPos_t *frameTime, void *userdata)
+{
+    return static_cast<PlayerSocket*>(userdata)->seekRemoteFileAt(handle, pos, time, frameTime);
+}
+
 
 } // network
@@ -56,6 +56,11 @@ class PlayerSocket : public QObject
         quint32 m_SongDataReceived;
         quint32 m_TotalCurrentSongData;
 
+        // Données reçues avec la réponse au dernier déplacement, pas encore lues par FMOD
+        QByteArray m_Prefetch;
+        int m_PrefetchPos;
+        bool m_PrefetchEnd;         // Fin du fichier atteinte par ces données
+
 
         /**
          * @brief Cherche l'item correspondant au numéro passé en paramètre dans l'arborescence parent.
@@ -191,6 +196,7 @@ class PlayerSocket : public QObject
         FMOD_RESULT closeRemoteFile(void *handle);
         FMOD_RESULT readRemoteFile(void *handle, void *buffer, unsigned int sizebytes, unsigned int *bytesread);
         FMOD_RESULT seekRemoteFile(void *handle, unsigned int pos);
+        FMOD_RESULT seekRemoteFileAt(void *handle, unsigned int pos, audio::SoundPos_t time, audio::SoundPos_t *frameTime = nullptr);
 
     public slots:
 
@@ -212,6 +218,7 @@ FMOD_RESULT F_CALLBACK openCallback(const char *fileName, unsigned int *filesize
 FMOD_RESULT F_CALLBACK closeCallback(void *handle, void *userdata);
 FMOD_RESULT F_CALLBACK readCallback(void *handle, void *buffer, unsigned int sizebytes, unsigned int *bytesread, void *userdata);
 FMOD_RESULT F_CALLBACK seekCallback(void *handle, unsigned int pos, void *userdata);
+FMOD_RESULT seekTimeCallback(void *handle, unsigned int pos, audio::SoundPos_t time, audio::SoundPos_t *frameTime, void *userdata);
 
 
 } // network
@@ -41,9 +41,9 @@ audio::Player::SongId RemoteSong::getRemoteId() const
 // ==============================
 // ==============================
 
-void RemoteSong::open()
+void RemoteSong::open(audio::AudioThread& audioThread, bool mainCanal)
 {
-    m_SoundID = audio::FmodManager::getInstance().openFromFile(m_File.toStdString(), true, m_Settings);
+    m_SoundID = audioThread.openFromFile(m_File.toStdString(), mainCanal ? audio::VoiceRole::MAIN : audio::VoiceRole::NEXT, m_Settings);
 }
 
 
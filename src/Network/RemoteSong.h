@@ -45,8 +45,10 @@ class RemoteSong : public audio::Song
 
         /**
          * @brief Ouvre le fichier avec FMOD pour stream du fichier distant.
+         * @param audioThread Thread audio exécutant l'ouverture
+         * @param mainCanal true pour ouvrir le son sur le canal principal, false sur le canal de la musique suivante
          */
-        virtual void open() override;
+        virtual void open(audio::AudioThread& audioThread, bool mainCanal = true) override;
 };
 
 
@@ -16,6 +16,7 @@ CONFIG += c++14
 SOURCES += main.cpp \
     Util/Tools.cpp \
     Gui/AboutDialog.cpp \
+    Gui/AudioStatusDialog.cpp \
     Gui/ClickableLabel.cpp \
     Gui/PlayerButton.cpp \
     Gui/PlayerLabel.cpp \
@@ -30,6 +31,23 @@ SOURCES += main.cpp \
     Audio/FmodManager.cpp \
     Audio/Player.cpp \
     Audio/Song.cpp \
+    Audio/SongScanner.cpp \
+    Audio/MetadataCache.cpp \
+    Audio/SongProbe.cpp \
+    Audio/LibraryWatcher.cpp \
+    Audio/SongStore.cpp \
+    Audio/AudioThread.cpp \
+    Audio/SpectrumDsp.cpp \
+    Audio/SpectrumKernels.cpp \
+    Audio/FftEngine.cpp \
+    Audio/LoudnessMeter.cpp \
+    Audio/LoudnessCache.cpp \
+    Audio/SongAnalyzer.cpp \
+    Audio/WaveformBuilder.cpp \
+    Audio/WaveformCache.cpp \
+    Audio/SeekIndex.cpp \
+    Audio/SeekIndexCache.cpp \
+    Audio/PreviewScanner.cpp \
     Network/Commands/Command.cpp \
     Network/Commands/CommandReply.cpp \
     Network/Commands/CommandRequest.cpp \
@@ -50,6 +68,7 @@ SOURCES += main.cpp \
 HEADERS  += Constants.h \
     Util/Tools.h \
     Gui/AboutDialog.h \
+    Gui/AudioStatusDialog.h \
     Gui/ClickableLabel.h \
     Gui/PlayerButton.h \
     Gui/PlayerLabel.h \
@@ -68,6 +87,24 @@ HEADERS  += Constants.h \
     Audio/FmodManager.h \
     Audio/Player.h \
     Audio/Song.h \
+    Audio/SongMetadata.h \
+    Audio/SongScanner.h \
+    Audio/MetadataCache.h \
+    Audio/SongProbe.h \
+    Audio/LibraryWatcher.h \
+    Audio/SongStore.h \
+    Audio/AudioThread.h \
+    Audio/SpectrumDsp.h \
+    Audio/SpectrumKernels.h \
+    Audio/FftEngine.h \
+    Audio/LoudnessMeter.h \
+    Audio/LoudnessCache.h \
+    Audio/SongAnalyzer.h \
+    Audio/WaveformBuilder.h \
+    Audio/WaveformCache.h \
+    Audio/SeekIndex.h \
+    Audio/SeekIndexCache.h \
+    Audio/PreviewScanner.h \
     Network/Sendable.h \
     Network/Commands/Command.h \
     Network/Commands/CommandReply.h \
@@ -77,6 +114,9 @@ HEADERS  += Constants.h \
     Gui/SongListItem.h \
     Gui/SongListIterator.h \
     Util/composedmap.h \
+    Util/composedarraymap.h \
+    Util/spscqueue.h \
+    Util/triplebuffer.h \
     Gui/ShadowWidget.h \
     Gui/PlayerToggleButton.h \
     Gui/ConnectionDialog.h \
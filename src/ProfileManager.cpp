@@ -12,11 +12,16 @@
 #include <QJsonDocument>
 #include <QJsonObject>
 #include "Constants.h"
+#include "Audio/FmodManager.h"
 
 
 bool ProfileManager::load()
 {
     m_TotalListeningSeconds = 0;
+    m_SampleBudget = SAMPLE_DEFAULT_BUDGET;
+    m_CrossfadeTime = CROSSFADE_DEFAULT_TIME;
+    m_CrossfadeCurve = static_cast<unsigned int>(audio::FadeCurve::EQUAL_POWER);
+    m_SkipUnbufferedCrossfade = true;
 
     QFile profileFile(PROFILE_FILEPATH);
     if (!profileFile.open(QIODevice::ReadOnly))
@@ -32,6 +37,10 @@ bool ProfileManager::load()
     QJsonObject json = profileDoc.object();
 
     m_TotalListeningSeconds = json["listeningSeconds"].toInt();
+    m_SampleBudget = json["sampleMemoryBudget"].toInt(static_cast<int>(SAMPLE_DEFAULT_BUDGET));
+    m_CrossfadeTime = json["crossfadeTime"].toInt(static_cast<int>(CROSSFADE_DEFAULT_TIME));
+    m_CrossfadeCurve = json["crossfadeCurve"].toInt(static_cast<int>(audio::FadeCurve::EQUAL_POWER));
+    m_SkipUnbufferedCrossfade = json["skipUnbufferedCrossfade"].toBool(true);
 
     return true;
 }
@@ -47,6 +56,10 @@ bool ProfileManager::save() const
 
     QJsonObject profileObject;
     profileObject["listeningSeconds"] = static_cast<int>(m_TotalListeningSeconds);
+    profileObject["sampleMemoryBudget"] = static_cast<int>(m_SampleBudget);
+    profileObject["crossfadeTime"] = static_cast<int>(m_CrossfadeTime);
+    profileObject["crossfadeCurve"] = static_cast<int>(m_CrossfadeCurve);
+    profileObject["skipUnbufferedCrossfade"] = m_SkipUnbufferedCrossfade;
 
     QJsonDocument profileDoc(profileObject);
     profileFile.write(profileDoc.toJson());
@@ -69,3 +82,67 @@ void ProfileManager::setListeningTime(unsigned int seconds)
 {
     m_TotalListeningSeconds = seconds;
 }
+
+// ==============================
+// ==============================
+
+unsigned int ProfileManager::getSampleBudget() const
+{
+    return m_SampleBudget;
+}
+
+// ==============================
+// ==============================
+
+void ProfileManager::setSampleBudget(unsigned int megabytes)
+{
+    m_SampleBudget = megabytes;
+}
+
+// ==============================
+// ==============================
+
+unsigned int ProfileManager::getCrossfadeTime() const
+{
+    return m_CrossfadeTime;
+}
+
+// ==============================
+// ==============================
+
+void ProfileManager::setCrossfadeTime(unsigned int ms)
+{
+    m_CrossfadeTime = ms;
+}
+
+// ==============================
+// ==============================
+
+unsigned int ProfileManager::getCrossfadeCurve() const
+{
+    return m_CrossfadeCurve;
+}
+
+// ==============================
+// ==============================
+
+void ProfileManager::setCrossfadeCurve(unsigned int curve)
+{
+    m_CrossfadeCurve = curve;
+}
+
+// ==============================
+// ==============================
+
+bool ProfileManager::isSkippingUnbufferedCrossfade() const
+{
+    return m_SkipUnbufferedCrossfade;
+}
+
+// ==============================
+// ==============================
+
+void ProfileManager::setSkipUnbufferedCrossfade(bool skip)
+{
+    m_SkipUnbufferedCrossfade = skip;
+}
@@ -18,6 +18,10 @@ class ProfileManager
     private:
 
         unsigned int m_TotalListeningSeconds;
+        unsigned int m_SampleBudget;            // Mo
+        unsigned int m_CrossfadeTime;           // ms
+        unsigned int m_CrossfadeCurve;          // audio::FadeCurve
+        bool m_SkipUnbufferedCrossfade;
 
     public:
 
@@ -31,6 +35,22 @@ class ProfileManager
         unsigned int getListeningTime() const;
 
         void setListeningTime(unsigned int seconds);
+
+        unsigned int getSampleBudget() const;
+
+        void setSampleBudget(unsigned int megabytes);
+
+        unsigned int getCrossfadeTime() const;
+
+        void setCrossfadeTime(unsigned int ms);
+
+        unsigned int getCrossfadeCurve() const;
+
+        void setCrossfadeCurve(unsigned int curve);
+
+        bool isSkippingUnbufferedCrossfade() const;
+
+        void setSkipUnbufferedCrossfade(bool skip);
 };
 
 #endif  // __PROFILEMANAGER_H__
@@ -0,0 +1,404 @@
+#ifndef COMPOSEDARRAYMAP_H
+#define COMPOSEDARRAYMAP_H
+
+#include <array>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+
+
+namespace util {
+
+
+/**
+ * Variante de ComposedMap dont les clés simples sont fixées à la compilation :
+ * chaque drapeau indexe un conteneur d'un tableau, les sous-ensembles sont des vues
+ * (aucune copie) et les itérateurs ne sont pas virtuels.
+ */
+template<typename Key, typename Value, Key... Flags>
+class ComposedArrayMap
+{
+    public:
+
+        static constexpr std::size_t FLAGS_NB = sizeof...(Flags);
+
+    private:
+
+        static_assert(FLAGS_NB > 0 && FLAGS_NB <= 32, "Invalid flags number");
+
+        using Containers = std::array<Value, FLAGS_NB>;
+
+        Containers m_Values;
+
+        static constexpr std::array<Key, FLAGS_NB> keys() { return {{ Flags... }}; }
+
+        static constexpr unsigned int ALL_MASK = (FLAGS_NB == 32) ? ~0u : ((1u << FLAGS_NB) - 1);
+
+        static std::size_t getIndex(const Key& key);
+        static unsigned int getMask(const Key& composedKey);
+
+
+        template<bool IsConst = false>
+        class base_iterator
+        {
+            friend class ComposedArrayMap;
+            template<bool> friend class base_iterator;
+
+            protected:
+
+                typedef typename std::conditional<IsConst, const Containers, Containers>::type ContainersType;
+                typedef typename std::conditional<IsConst, typename Value::const_iterator, typename Value::iterator>::type ElementIterator;
+
+                ContainersType *mp_Values;
+                unsigned int m_Mask;
+                std::size_t m_Index;
+                ElementIterator m_It;
+
+
+                base_iterator(ContainersType *values, unsigned int mask, std::size_t index)
+                    : mp_Values(values), m_Mask(mask), m_Index(index)
+                {
+                    if (m_Index < FLAGS_NB)
+                    {
+                        if (isUsed(m_Index))
+                            m_It = (*mp_Values)[m_Index].begin();
+                        else
+                            nextContainer();
+                    }
+                }
+
+                base_iterator(ContainersType *values, unsigned int mask, std::size_t index, const ElementIterator& it)
+                    : mp_Values(values), m_Mask(mask), m_Index(index), m_It(it)
+                {
+                    if (m_Index < FLAGS_NB && (!isUsed(m_Index) || m_It == (*mp_Values)[m_Index].end()))
+                        nextContainer();
+                }
+
+                inline bool isUsed(std::size_t index) const
+                {
+                    return (m_Mask & (1u << index)) && !(*mp_Values)[index].empty();
+                }
+
+                inline void nextContainer()
+                {
+                    while (++m_Index < FLAGS_NB && !isUsed(m_Index))
+                    {
+                    }
+
+                    if (m_Index < FLAGS_NB)
+                        m_It = (*mp_Values)[m_Index].begin();
+                }
+
+            public:
+
+                typedef std::bidirectional_iterator_tag iterator_category;
+                typedef typename Value::value_type value_type;
+                typedef typename Value::difference_type difference_type;
+                typedef typename std::conditional<IsConst, const value_type*, value_type*>::type pointer;
+                typedef typename std::conditional<IsConst, const value_type&, value_type&>::type reference;
+
+                base_iterator() : mp_Values(nullptr), m_Mask(0), m_Index(FLAGS_NB), m_It() {}
+
+                template<bool OtherConst, typename = typename std::enable_if<IsConst && !OtherConst>::type>
+                base_iterator(const base_iterator<OtherConst>& it)
+                    : mp_Values(it.mp_Values), m_Mask(it.m_Mask), m_Index(it.m_Index), m_It(it.m_It)
+                {}
+
+                inline reference operator*() const
+                {
+                    return *m_It;
+                }
+
+                inline pointer operator->() const
+                {
+                    return &(*m_It);
+                }
+
+                template<bool OtherConst>
+                inline bool operator==(const base_iterator<OtherConst>& other) const
+                {
+                    return (m_Index == other.m_Index) && (m_Index >= FLAGS_NB || m_It == other.m_It);
+                }
+
+                template<bool OtherConst>
+                inline bool operator!=(const base_iterator<OtherConst>& other) const
+                {
+                    return !(*this == other);
+                }
+
+                inline bool operator==(const typename Value::const_iterator& other) const
+                {
+                    return m_Index < FLAGS_NB && m_It == other;
+                }
+
+                inline bool operator!=(const typename Value::const_iterator& other) const
+                {
+                    return !(*this == other);
+                }
+
+                inline base_iterator& operator++()
+                {
+                    if (m_Index < FLAGS_NB && ++m_It == (*mp_Values)[m_Index].end())
+                        nextContainer();
+
+                    return *this;
+                }
+
+                inline base_iterator operator++(int)
+                {
+                    base_iterator it = *this;
+                    operator++();
+                    return it;
+                }
+
+                inline base_iterator& operator--()
+                {
+                    if (m_Index < FLAGS_NB && m_It != (*mp_Values)[m_Index].begin())
+                    {
+                        --m_It;
+                        return *this;
+                    }
+
+                    // Le premier élément reste inchangé (comme ComposedMap)
+                    for (std::size_t i = m_Index; i > 0; --i)
+                    {
+                        if (isUsed(i - 1))
+                        {
+                            m_Index = i - 1;
+                            m_It = (*mp_Values)[m_Index].end();
+                            --m_It;
+                            break;
+                        }
+                    }
+
+                    return *this;
+                }
+
+                inline base_iterator operator--(int)
+                {
+                    base_iterator it = *this;
+                    operator--();
+                    return it;
+                }
+        };
+
+    public:
+
+        typedef base_iterator<false> iterator;
+        typedef base_iterator<true> const_iterator;
+
+        /**
+         * Vue (sans copie) sur les conteneurs d'une clé composée.
+         */
+        class SubSetView
+        {
+            friend class ComposedArrayMap;
+
+            private:
+
+                const Containers *mp_Values;
+                unsigned int m_Mask;
+
+                SubSetView(const Containers *values, unsigned int mask) : mp_Values(values), m_Mask(mask) {}
+
+            public:
+
+                inline const_iterator begin() const { return const_iterator(mp_Values, m_Mask, 0); }
+                inline const_iterator end() const { return const_iterator(mp_Values, m_Mask, FLAGS_NB); }
+
+                inline bool empty() const { return begin() == end(); }
+
+                inline unsigned int elementsCount() const
+                {
+                    unsigned int count = 0;
+
+                    for (std::size_t i = 0; i < FLAGS_NB; ++i)
+                    {
+                        if (m_Mask & (1u << i))
+                            count += (*mp_Values)[i].size();
+                    }
+
+                    return count;
+                }
+        };
+
+        ComposedArrayMap() = default;
+
+        inline iterator begin() { return iterator(&m_Values, ALL_MASK, 0); }
+        inline const_iterator begin() const { return const_iterator(&m_Values, ALL_MASK, 0); }
+
+        inline iterator end() { return iterator(&m_Values, ALL_MASK, FLAGS_NB); }
+        inline const_iterator end() const { return const_iterator(&m_Values, ALL_MASK, FLAGS_NB); }
+
+        inline const_iterator cbegin() const { return begin(); }
+        inline const_iterator cend() const { return end(); }
+
+        bool empty() const;
+        bool empty(const Key& key) const;
+
+        unsigned int elementsCount() const;
+
+        iterator erase(const_iterator position);
+
+        void clear();
+        void clear(const Key& key);
+
+        SubSetView getSubSets(const Key& composedKey) const;
+
+        const_iterator getIterator(const Key& key, const typename Value::const_iterator& element) const;
+
+        Value& operator[](const Key& key);
+        const Value& at(const Key& key) const;
+};
+
+// ==============================
+// ==============================
+
+template<typename Key, typename Value, Key... Flags>
+std::size_t ComposedArrayMap<Key, Value, Flags...>::getIndex(const Key& key)
+{
+    const std::array<Key, FLAGS_NB> flags = keys();
+
+    for (std::size_t i = 0; i < FLAGS_NB; ++i)
+    {
+        if (flags[i] == key)
+            return i;
+    }
+
+    throw std::out_of_range("Invalid key");
+}
+
+// ==============================
+// ==============================
+
+template<typename Key, typename Value, Key... Flags>
+unsigned int ComposedArrayMap<Key, Value, Flags...>::getMask(const Key& composedKey)
+{
+    const std::array<Key, FLAGS_NB> flags = keys();
+    unsigned int mask = 0;
+
+    for (std::size_t i = 0; i < FLAGS_NB; ++i)
+    {
+        if (composedKey & flags[i])
+            mask |= (1u << i);
+    }
+
+    return mask;
+}
+
+// ==============================
+// ==============================
+
+template<typename Key, typename Value, Key... Flags>
+bool ComposedArrayMap<Key, Value, Flags...>::empty() const
+{
+    for (const Value& value : m_Values)
+    {
+        if (!value.empty())
+            return false;
+    }
+
+    return true;
+}
+
+// ==============================
+// ==============================
+
+template<typename Key, typename Value, Key... Flags>
+bool ComposedArrayMap<Key, Value, Flags...>::empty(const Key& key) const
+{
+    return getSubSets(key).empty();
+}
+
+// ==============================
+// ==============================
+
+template<typename Key, typename Value, Key... Flags>
+unsigned int ComposedArrayMap<Key, Value, Flags...>::elementsCount() const
+{
+    unsigned int count = 0;
+
+    for (const Value& value : m_Values)
+        count += value.size();
+
+    return count;
+}
+
+// ==============================
+// ==============================
+
+template<typename Key, typename Value, Key... Flags>
+typename ComposedArrayMap<Key, Value, Flags...>::iterator ComposedArrayMap<Key, Value, Flags...>::erase(const_iterator position)
+{
+    if (position.m_Index >= FLAGS_NB)
+        return end();
+
+    auto nextElement = m_Values[position.m_Index].erase(position.m_It);
+    return iterator(&m_Values, ALL_MASK, position.m_Index, nextElement);
+}
+
+// ==============================
+// ==============================
+
+template<typename Key, typename Value, Key... Flags>
+void ComposedArrayMap<Key, Value, Flags...>::clear()
+{
+    for (Value& value : m_Values)
+        value.clear();
+}
+
+// ==============================
+// ==============================
+
+template<typename Key, typename Value, Key... Flags>
+void ComposedArrayMap<Key, Value, Flags...>::clear(const Key& key)
+{
+    unsigned int mask = getMask(key);
+
+    for (std::size_t i = 0; i < FLAGS_NB; ++i)
+    {
+        if (mask & (1u << i))
+            m_Values[i].clear();
+    }
+}
+
+// ==============================
+// ==============================
+
+template<typename Key, typename Value, Key... Flags>
+typename ComposedArrayMap<Key, Value, Flags...>::SubSetView ComposedArrayMap<Key, Value, Flags...>::getSubSets(const Key& composedKey) const
+{
+    return SubSetView(&m_Values, getMask(composedKey));
+}
+
+// ==============================
+// ==============================
+
+template<typename Key, typename Value, Key... Flags>
+typename ComposedArrayMap<Key, Value, Flags...>::const_iterator ComposedArrayMap<Key, Value, Flags...>::getIterator(const Key& key, const typename Value::const_iterator& element) const
+{
+    return const_iterator(&m_Values, ALL_MASK, getIndex(key), element);
+}
+
+// ==============================
+// ==============================
+
+template<typename Key, typename Value, Key... Flags>
+Value& ComposedArrayMap<Key, Value, Flags...>::operator[](const Key& key)
+{
+    return m_Values[getIndex(key)];
+}
+
+// ==============================
+// ==============================
+
+template<typename Key, typename Value, Key... Flags>
+const Value& ComposedArrayMap<Key, Value, Flags...>::at(const Key& key) const
+{
+    return m_Values[getIndex(key)];
+}
+
+
+} // util
+
+#endif  // COMPOSEDARRAYMAP_H
@@ -398,6 +398,8 @@ class ComposedMap : public std::map<Key, Value>
 
         virtual ComposedMap<Key, Value> getSubSets(const Key& composedKey) const;
 
+        virtual const_iterator getIterator(const Key& key, const typename Value::const_iterator& element) const;
+
         virtual Value& operator[](const Key& key);
 };
 
@@ -677,6 +679,20 @@ ComposedMap<Key, Value> ComposedMap<Key, Value>::getSubSets(const Key& composedK
 // ==============================
 // ==============================
 
+template<typename Key, typename Value>
+typename ComposedMap<Key, Value>::const_iterator ComposedMap<Key, Value>::getIterator(const Key& key, const typename Value::const_iterator& element) const
+{
+    typename std::map<Key, Value>::const_iterator contIt = this->find(key);
+
+    if (contIt == std::map<Key, Value>::end())
+        return end();
+
+    return const_iterator(*this, contIt, element);
+}
+
+// ==============================
+// ==============================
+
 template<typename Key, typename Value>
 Value& ComposedMap<Key, Value>::operator[](const Key& key)
 {
@@ -0,0 +1,181 @@
+/*************************************
+ * @file    spscqueue.h
+ * @date    17/10/26
+ * @author  Manuel
+ *
+ * Déclarations et définitions de la file
+ * circulaire sans verrou SpscQueue.
+ *************************************
+*/
+
+#ifndef __SPSCQUEUE_H__
+#define __SPSCQUEUE_H__
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+
+namespace util {
+
+
+/**
+ * File circulaire sans verrou à un seul producteur et un seul consommateur :
+ * push n'est appelée que par un thread, pop que par un autre.
+ * La capacité est fixée à la compilation (puissance de 2), aucune allocation n'est faite.
+ * Avec pushOverwrite, le producteur retire lui-même l'élément le plus ancien d'une file pleine :
+ * le consommateur réserve alors chaque élément lu par un échange atomique de la tête, et écarte
+ * sa copie si le producteur l'a retiré entre temps (T doit être trivialement copiable).
+ */
+template<typename T, std::size_t Capacity>
+class SpscQueue
+{
+    private:
+
+        static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of 2");
+
+        static constexpr std::size_t MASK = Capacity - 1;
+
+        std::array<T, Capacity> m_Items;
+
+        // Compteurs libres (jamais remis à 0), l'emplacement est obtenu par masque
+        std::atomic<std::size_t> m_Head;    // Ecrit par le consommateur (et par pushOverwrite)
+        std::atomic<std::size_t> m_Tail;    // Ecrit par le producteur
+
+    public:
+
+        SpscQueue() : m_Head(0), m_Tail(0) {}
+
+        SpscQueue(const SpscQueue&) = delete;
+        SpscQueue& operator=(const SpscQueue&) = delete;
+
+        /**
+         * @brief Ajoute un élément en fin de file (thread producteur).
+         * @param item Elément à ajouter
+         * @return false si la file est pleine
+         */
+        bool push(const T& item);
+
+        /**
+         * @brief Ajoute un élément en fin de file, en retirant le plus ancien si elle est pleine (thread producteur).
+         * @param item Elément à ajouter
+         * @return false si un élément a été retiré
+         */
+        bool pushOverwrite(const T& item);
+
+        /**
+         * @brief Retire l'élément en tête de file (thread consommateur).
+         * @param item Elément retiré
+         * @return false si la file est vide
+         */
+        bool pop(T& item);
+
+        /**
+         * @brief Retire l'élément en tête de file s'il vérifie le prédicat (thread consommateur).
+         * @param item Elément retiré (inchangé sinon)
+         * @param predicate Condition sur l'élément en tête
+         * @return false si la file est vide ou si l'élément en tête ne vérifie pas le prédicat
+         */
+        template<typename Predicate>
+        bool popIf(T& item, Predicate predicate);
+
+        /**
+         * @brief empty
+         * @return true si la file est vide.
+         */
+        bool empty() const;
+};
+
+// ==============================
+// ==============================
+
+template<typename T, std::size_t Capacity>
+bool SpscQueue<T, Capacity>::push(const T& item)
+{
+    const std::size_t tail = m_Tail.load(std::memory_order_relaxed);
+
+    if (tail - m_Head.load(std::memory_order_acquire) == Capacity)
+        return false;
+
+    m_Items[tail & MASK] = item;
+    m_Tail.store(tail + 1, std::memory_order_release);
+
+    return true;
+}
+
+// ==============================
+// ==============================
+
+template<typename T, std::size_t Capacity>
+bool SpscQueue<T, Capacity>::pushOverwrite(const T& item)
+{
+    const std::size_t tail = m_Tail.load(std::memory_order_relaxed);
+    std::size_t head = m_Head.load(std::memory_order_acquire);
+    bool kept = true;
+
+    // Echec de l'échange : le consommateur vient de libérer une place
+    if (tail - head == Capacity)
+        kept = !m_Head.compare_exchange_strong(head, head + 1, std::memory_order_acq_rel);
+
+    m_Items[tail & MASK] = item;
+    m_Tail.store(tail + 1, std::memory_order_release);
+
+    return kept;
+}
+
+// ==============================
+// ==============================
+
+template<typename T, std::size_t Capacity>
+bool SpscQueue<T, Capacity>::pop(T& item)
+{
+    return popIf(item, [](const T&) { return true; });
+}
+
+// ==============================
+// ==============================
+
+template<typename T, std::size_t Capacity>
+template<typename Predicate>
+bool SpscQueue<T, Capacity>::popIf(T& item, Predicate predicate)
+{
+    std::size_t head = m_Head.load(std::memory_order_acquire);
+
+    while (head != m_Tail.load(std::memory_order_acquire))
+    {
+        T copy = m_Items[head & MASK];
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        // Tête déplacée par pushOverwrite : la copie a pu être écrasée
+        if (m_Head.load(std::memory_order_relaxed) != head)
+        {
+            head = m_Head.load(std::memory_order_acquire);
+            continue;
+        }
+
+        if (!predicate(copy))
+            return false;
+
+        if (m_Head.compare_exchange_strong(head, head + 1, std::memory_order_acq_rel))
+        {
+            item = copy;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// ==============================
+// ==============================
+
+template<typename T, std::size_t Capacity>
+bool SpscQueue<T, Capacity>::empty() const
+{
+    return m_Head.load(std::memory_order_acquire) == m_Tail.load(std::memory_order_acquire);
+}
+
+
+} // util
+
+#endif  // __SPSCQUEUE_H__
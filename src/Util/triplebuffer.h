@@ -0,0 +1,100 @@
+/*************************************
+ * @file    triplebuffer.h
+ * @date    17/10/26
+ * @author  Manuel
+ *
+ * Déclarations et définitions du triple
+ * tampon sans verrou TripleBuffer.
+ *************************************
+*/
+
+#ifndef __TRIPLEBUFFER_H__
+#define __TRIPLEBUFFER_H__
+
+#include <array>
+#include <atomic>
+
+
+namespace util {
+
+
+/**
+ * Triple tampon sans verrou publiant des instantanés d'un thread écrivain vers un thread lecteur :
+ * l'écrivain remplit back() puis le publie par un échange atomique avec le tampon intermédiaire,
+ * le lecteur récupère le dernier instantané publié sans jamais bloquer l'écrivain.
+ */
+template<typename T>
+class TripleBuffer
+{
+    private:
+
+        static constexpr unsigned int INDEX_MASK = 0x3;
+        static constexpr unsigned int NEW_DATA = 0x4;
+
+        std::array<T, 3> m_Buffers;
+
+        // Indice du tampon intermédiaire (et drapeau NEW_DATA), seul état partagé
+        std::atomic<unsigned int> m_Middle;
+
+        unsigned int m_Back;    // Propriété de l'écrivain
+        unsigned int m_Front;   // Propriété du lecteur
+
+    public:
+
+        TripleBuffer() : m_Middle(1), m_Back(0), m_Front(2) {}
+
+        TripleBuffer(const TripleBuffer&) = delete;
+        TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+        /**
+         * @brief back
+         * @return Tampon en cours d'écriture (thread écrivain).
+         */
+        T& back();
+
+        /**
+         * @brief Publie le tampon écrit (thread écrivain).
+         */
+        void publish();
+
+        /**
+         * @brief front
+         * @return Dernier instantané publié (thread lecteur).
+         */
+        const T& front();
+};
+
+// ==============================
+// ==============================
+
+template<typename T>
+inline T& TripleBuffer<T>::back()
+{
+    return m_Buffers[m_Back];
+}
+
+// ==============================
+// ==============================
+
+template<typename T>
+inline void TripleBuffer<T>::publish()
+{
+    m_Back = m_Middle.exchange(m_Back | NEW_DATA, std::memory_order_acq_rel) & INDEX_MASK;
+}
+
+// ==============================
+// ==============================
+
+template<typename T>
+inline const T& TripleBuffer<T>::front()
+{
+    if (m_Middle.load(std::memory_order_relaxed) & NEW_DATA)
+        m_Front = m_Middle.exchange(m_Front, std::memory_order_acq_rel) & INDEX_MASK;
+
+    return m_Buffers[m_Front];
+}
+
+
+} // util
+
+#endif  // __TRIPLEBUFFER_H__